@@ -19,6 +19,7 @@
 #include "utils/JobManager.h"
 #include "utils/Variant.h"
 #include "LangInfo.h"
+#include "LibraryWatcher.h"
 #include "utils/Screenshot.h"
 #include "Util.h"
 #include "URL.h"
@@ -234,6 +235,8 @@ CApplication::CApplication(void)
 {
   TiXmlBase::SetCondenseWhiteSpace(false);
 
+  m_libraryWatcher.reset(new CLibraryWatcher());
+
 #ifdef HAVE_X11
   XInitThreads();
 #endif
@@ -1045,6 +1048,11 @@ void CApplication::OnSettingChanged(std::shared_ptr<const CSetting> setting)
   {
     CApplicationMessenger::GetInstance().PostMsg(TMSG_MEDIA_RESTART);
   }
+  else if (settingId == CSettings::SETTING_VIDEOLIBRARY_WATCHSOURCES ||
+           settingId == CSettings::SETTING_MUSICLIBRARY_WATCHSOURCES)
+  {
+    m_libraryWatcher->Start();
+  }
   else if (StringUtils::EqualsNoCase(settingId, CSettings::SETTING_MUSICPLAYER_REPLAYGAINTYPE))
     m_replayGainSettings.iType = std::static_pointer_cast<const CSettingInt>(setting)->GetValue();
   else if (StringUtils::EqualsNoCase(settingId, CSettings::SETTING_MUSICPLAYER_REPLAYGAINPREAMP))
@@ -2556,6 +2564,7 @@ void CApplication::Stop(int exitCode)
     WakeUpScreenSaverAndDPMS();
 
     g_alarmClock.StopThread();
+    m_libraryWatcher->Stop();
 
     CLog::Log(LOGNOTICE, "Storing total System Uptime");
     g_sysinfo.SetTotalUptime(g_sysinfo.GetTotalUptime() + (int)(CTimeUtils::GetFrameTime() / 60000));
@@ -3752,6 +3761,11 @@ bool CApplication::OnMessage(CGUIMessage& message)
           CServiceBroker::GetGUI()->GetInfoManager().UpdateCurrentItem(*item);
         }
       }
+      else if (message.GetParam1() == GUI_MSG_UPDATE_SOURCES)
+      {
+        // watch added sources, stop watching removed ones
+        m_libraryWatcher->Start();
+      }
     }
     break;
 
@@ -4595,6 +4609,9 @@ void CApplication::UpdateLibraries()
     CLog::LogF(LOGNOTICE, "Starting music library startup scan");
     StartMusicScan("", !settings->GetBool(CSettings::SETTING_MUSICLIBRARY_BACKGROUNDUPDATE));
   }
+
+  // keep the libraries up to date from here on
+  m_libraryWatcher->Start();
 }
 
 void CApplication::UpdateCurrentPlayArt()
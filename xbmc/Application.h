@@ -55,6 +55,7 @@ class IActionListener;
 class CGUIComponent;
 class CAppInboundProtocol;
 class CSettingsComponent;
+class CLibraryWatcher;
 
 namespace ADDON
 {
@@ -443,6 +444,7 @@ protected:
   bool m_bSystemScreenSaverEnable = false;
 
   std::unique_ptr<MUSIC_INFO::CMusicInfoScanner> m_musicInfoScanner;
+  std::unique_ptr<CLibraryWatcher> m_libraryWatcher;
 
   bool m_muted = false;
   float m_volumeLevel = VOLUME_MAXIMUM;
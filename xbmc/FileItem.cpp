@@ -644,17 +644,26 @@ void CFileItem::Archive(CArchive& ar)
 }
 
 void CFileItem::Serialize(CVariant& value) const
+{
+  CFileItem::SerializeFields(value, std::set<std::string>());
+}
+
+void CFileItem::SerializeFields(CVariant& value, const std::set<std::string>& fields) const
 {
   //CGUIListItem::Serialize(value["CGUIListItem"]);
 
-  value["strPath"] = m_strPath;
-  value["dateTime"] = (m_dateTime.IsValid()) ? m_dateTime.GetAsRFC1123DateTime() : "";
-  value["lastmodified"] = m_dateTime.IsValid() ? m_dateTime.GetAsDBDateTime() : "";
-  value["size"] = m_dwSize;
-  value["DVDLabel"] = m_strDVDLabel;
-  value["title"] = m_strTitle;
-  value["mimetype"] = m_mimetype;
-  value["extrainfo"] = m_extrainfo;
+  if (IsWanted(fields, "strPath")) value["strPath"] = m_strPath;
+  if (IsWanted(fields, "dateTime")) value["dateTime"] = (m_dateTime.IsValid()) ? m_dateTime.GetAsRFC1123DateTime() : "";
+  if (IsWanted(fields, "lastmodified")) value["lastmodified"] = m_dateTime.IsValid() ? m_dateTime.GetAsDBDateTime() : "";
+  if (IsWanted(fields, "size")) value["size"] = m_dwSize;
+  if (IsWanted(fields, "DVDLabel")) value["DVDLabel"] = m_strDVDLabel;
+  if (IsWanted(fields, "title")) value["title"] = m_strTitle;
+  if (IsWanted(fields, "mimetype")) value["mimetype"] = m_mimetype;
+  if (IsWanted(fields, "extrainfo")) value["extrainfo"] = m_extrainfo;
+
+  // the tags are serialized on their own for projections
+  if (!fields.empty())
+    return;
 
   if (m_musicInfoTag)
     (*m_musicInfoTag).Serialize(value["musicInfoTag"]);
@@ -0,0 +1,470 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "LibraryWatcher.h"
+
+#include "FileItem.h"
+#include "MediaSource.h"
+#include "ServiceBroker.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "music/MusicLibraryQueue.h"
+#include "music/infoscanner/MusicInfoScanner.h"
+#include "settings/MediaSourceSettings.h"
+#include "settings/Settings.h"
+#include "settings/SettingsComponent.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+#include "video/VideoLibraryQueue.h"
+
+#include <set>
+#include <utility>
+#include <vector>
+
+#ifdef HAVE_INOTIFY
+#include <errno.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+using namespace XFILE;
+
+// scan once no change was seen for this long
+#define DEBOUNCE_TIME 5000
+// but don't hold back changes longer than this while a source keeps changing
+#define MAX_DEBOUNCE_TIME 60000
+#define WAIT_INTERVAL 500
+#define POLL_INTERVAL 300000
+
+CLibraryWatcher::CLibraryWatcher()
+  : CThread("LibraryWatcher"), m_refresh(false)
+{
+}
+
+CLibraryWatcher::~CLibraryWatcher()
+{
+  Stop();
+}
+
+void CLibraryWatcher::Start()
+{
+  const std::shared_ptr<CSettings> settings = CServiceBroker::GetSettingsComponent()->GetSettings();
+  if (!settings->GetBool(CSettings::SETTING_VIDEOLIBRARY_WATCHSOURCES) &&
+      !settings->GetBool(CSettings::SETTING_MUSICLIBRARY_WATCHSOURCES))
+  {
+    Stop();
+    return;
+  }
+
+  // the watcher thread must not touch the sources while they may be changed
+  std::map<std::string, int> sources = GetSources();
+  {
+    CSingleLock lock(m_critSection);
+    m_sources = std::move(sources);
+  }
+
+  m_refresh = true;
+  if (!IsRunning())
+    Create();
+}
+
+void CLibraryWatcher::Stop()
+{
+  StopThread(true);
+}
+
+void CLibraryWatcher::Process()
+{
+#ifdef HAVE_INOTIFY
+  m_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+  if (m_fd < 0)
+    CLog::Log(LOGERROR, "CLibraryWatcher::%s - inotify not available, polling all sources", __FUNCTION__);
+#endif
+
+  while (!m_bStop)
+  {
+    if (m_refresh)
+    {
+      m_refresh = false;
+      std::map<std::string, int> roots;
+      {
+        CSingleLock lock(m_critSection);
+        roots = m_sources;
+      }
+      UpdateRoots(roots);
+    }
+
+    if (m_fd >= 0)
+      ReadEvents(WAIT_INTERVAL);
+    else
+      Sleep(WAIT_INTERVAL);
+
+    if (XbmcThreads::SystemClockMillis() - m_lastPoll >= POLL_INTERVAL)
+      PollDirectories();
+
+    QueueScans();
+  }
+
+#ifdef HAVE_INOTIFY
+  if (m_fd >= 0)
+    close(m_fd);
+#endif
+  m_fd = -1;
+  m_watches.clear();
+  m_polled.clear();
+  m_roots.clear();
+  m_changed.clear();
+  m_watchLimit = false;
+}
+
+std::map<std::string, int> CLibraryWatcher::GetSources()
+{
+  const std::shared_ptr<CSettings> settings = CServiceBroker::GetSettingsComponent()->GetSettings();
+  std::map<std::string, int> roots;
+
+  const std::pair<const char*, int> types[] = {
+    { "video", settings->GetBool(CSettings::SETTING_VIDEOLIBRARY_WATCHSOURCES) ? LIBRARY_VIDEO : LIBRARY_NONE },
+    { "music", settings->GetBool(CSettings::SETTING_MUSICLIBRARY_WATCHSOURCES) ? LIBRARY_MUSIC : LIBRARY_NONE },
+  };
+  for (const auto& type : types)
+  {
+    if (type.second == LIBRARY_NONE)
+      continue;
+
+    VECSOURCES* sources = CMediaSourceSettings::GetInstance().GetSources(type.first);
+    if (!sources)
+      continue;
+
+    for (const auto& source : *sources)
+    {
+      std::vector<std::string> paths = source.vecPaths;
+      if (paths.empty())
+        paths.push_back(source.strPath);
+
+      for (std::string path : paths)
+      {
+        // only file systems that can tell us about changes, scrapers and
+        // plugins have no notion of a modified directory
+        if (!URIUtils::IsHD(path) && !URIUtils::IsSmb(path) && !URIUtils::IsNfs(path))
+          continue;
+
+        URIUtils::AddSlashAtEnd(path);
+        roots[path] |= type.second;
+      }
+    }
+  }
+
+  return roots;
+}
+
+void CLibraryWatcher::UpdateRoots(const std::map<std::string, int>& roots)
+{
+  std::map<std::string, int> oldRoots = m_roots;
+  if (m_watchLimit)
+  { // start over, the limit may have been raised or sources removed since
+    for (const auto& root : m_roots)
+      RemoveWatches(root.first);
+    oldRoots.clear();
+    m_watchLimit = false;
+  }
+
+  // drop sources that were removed, add new ones
+  std::vector<std::string> unwatch, watch;
+  GetRootChanges(oldRoots, roots, unwatch, watch);
+  for (const auto& directory : unwatch)
+    RemoveWatches(directory);
+  for (const auto& directory : watch)
+  {
+    if (URIUtils::IsHD(directory) && m_fd >= 0)
+      AddWatches(directory);
+    else
+      AddPolledDirectories(directory);
+  }
+  m_roots = roots;
+  m_lastPoll = XbmcThreads::SystemClockMillis();
+
+  CLog::Log(LOGDEBUG, "CLibraryWatcher::%s - watching %u sources, %u directories, polling %u directories",
+            __FUNCTION__, static_cast<unsigned int>(m_roots.size()),
+            static_cast<unsigned int>(m_watches.size()), static_cast<unsigned int>(m_polled.size()));
+}
+
+int CLibraryWatcher::GetLibraries(const std::map<std::string, int>& roots, const std::string& directory)
+{
+  int libraries = LIBRARY_NONE;
+  for (const auto& root : roots)
+  {
+    if (StringUtils::StartsWith(directory, root.first))
+      libraries |= root.second;
+  }
+  return libraries;
+}
+
+static bool IsWithin(const std::string& directory, const std::vector<std::string>& roots)
+{
+  for (const auto& root : roots)
+  {
+    if (StringUtils::StartsWith(directory, root))
+      return true;
+  }
+  return false;
+}
+
+void CLibraryWatcher::GetRootChanges(const std::map<std::string, int>& oldRoots, const std::map<std::string, int>& roots,
+                                     std::vector<std::string>& unwatch, std::vector<std::string>& watch)
+{
+  std::vector<std::string> remaining;
+  for (const auto& root : roots)
+    remaining.push_back(root.first);
+
+  // directories of a removed source are still watched for a source it is nested in
+  for (const auto& root : oldRoots)
+  {
+    if (roots.find(root.first) == roots.end() && !IsWithin(root.first, remaining))
+      unwatch.push_back(root.first);
+  }
+
+  // the watches of sources nested in an unwatched one are gone as well
+  std::vector<std::string> kept;
+  for (const auto& root : oldRoots)
+  {
+    if (roots.find(root.first) != roots.end() && !IsWithin(root.first, unwatch))
+      kept.push_back(root.first);
+  }
+
+  // a nested source is walked along with its parent
+  for (const auto& root : roots)
+  {
+    if (IsWithin(root.first, kept))
+      continue;
+
+    if (watch.empty() || !StringUtils::StartsWith(root.first, watch.back()))
+      watch.push_back(root.first);
+  }
+}
+
+void CLibraryWatcher::OnChanged(const std::string& directory)
+{
+  int libraries = GetLibraries(m_roots, directory);
+  if (libraries == LIBRARY_NONE)
+    return;
+
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  if (m_changed.empty() && !m_overflow)
+    m_firstChange = now;
+  m_lastChange = now;
+
+  m_changed[directory] |= libraries;
+}
+
+void CLibraryWatcher::QueueScans()
+{
+  if (m_changed.empty() && !m_overflow)
+    return;
+
+  unsigned int now = XbmcThreads::SystemClockMillis();
+  if (now - m_lastChange < DEBOUNCE_TIME && now - m_firstChange < MAX_DEBOUNCE_TIME)
+    return;
+
+  // keep collecting while a scan is running, it may be the one we queued
+  CVideoLibraryQueue& videoQueue = CVideoLibraryQueue::GetInstance();
+  CMusicLibraryQueue& musicQueue = CMusicLibraryQueue::GetInstance();
+  if (videoQueue.IsScanningLibrary() || musicQueue.IsScanningLibrary())
+    return;
+
+  const std::shared_ptr<CSettings> settings = CServiceBroker::GetSettingsComponent()->GetSettings();
+  int musicFlags = 0;
+  if (settings->GetBool(CSettings::SETTING_MUSICLIBRARY_DOWNLOADINFO))
+    musicFlags |= MUSIC_INFO::CMusicInfoScanner::SCAN_ONLINE;
+
+  if (m_overflow)
+  { // events were lost, fall back to a regular update of the watched libraries
+    CLog::Log(LOGWARNING, "CLibraryWatcher::%s - change notifications were lost, updating libraries", __FUNCTION__);
+    if (settings->GetBool(CSettings::SETTING_VIDEOLIBRARY_WATCHSOURCES))
+      videoQueue.ScanLibrary("", false, false);
+    if (settings->GetBool(CSettings::SETTING_MUSICLIBRARY_WATCHSOURCES))
+      musicQueue.ScanLibrary("", musicFlags | MUSIC_INFO::CMusicInfoScanner::SCAN_BACKGROUND, false);
+  }
+  else
+  {
+    std::set<std::string> video, music;
+    for (const auto& changed : m_changed)
+    {
+      if (changed.second & LIBRARY_VIDEO)
+        video.insert(changed.first);
+      if (changed.second & LIBRARY_MUSIC)
+        music.insert(changed.first);
+    }
+
+    CLog::Log(LOGDEBUG, "CLibraryWatcher::%s - queuing scan of %u video and %u music directories",
+              __FUNCTION__, static_cast<unsigned int>(video.size()), static_cast<unsigned int>(music.size()));
+    videoQueue.ScanChangedPaths(video);
+    musicQueue.ScanChangedPaths(music, musicFlags);
+  }
+
+  m_changed.clear();
+  m_overflow = false;
+}
+
+void CLibraryWatcher::AddWatches(const std::string& directory)
+{
+#ifdef HAVE_INOTIFY
+  if (m_watchLimit)
+    return;
+
+  std::string path = CSpecialProtocol::TranslatePath(directory);
+  int wd = inotify_add_watch(m_fd, path.c_str(), IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+                                                 IN_CLOSE_WRITE | IN_ONLYDIR);
+  if (wd < 0)
+  {
+    if (errno == ENOSPC)
+    {
+      CLog::Log(LOGWARNING, "CLibraryWatcher::%s - inotify watch limit reached, raise fs.inotify.max_user_watches", __FUNCTION__);
+      m_watchLimit = true;
+    }
+    return;
+  }
+  m_watches[wd] = directory;
+
+  CFileItemList items;
+  CDirectory::GetDirectory(directory, items, "/", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE);
+  for (const auto& item : items)
+  {
+    if (item->m_bIsFolder && !item->IsParentFolder())
+      AddWatches(item->GetPath());
+  }
+#endif
+}
+
+void CLibraryWatcher::RemoveWatches(const std::string& directory)
+{
+  for (auto it = m_watches.begin(); it != m_watches.end();)
+  {
+    if (StringUtils::StartsWith(it->second, directory))
+    {
+#ifdef HAVE_INOTIFY
+      inotify_rm_watch(m_fd, it->first);
+#endif
+      it = m_watches.erase(it);
+    }
+    else
+      ++it;
+  }
+
+  for (auto it = m_polled.begin(); it != m_polled.end();)
+  {
+    if (StringUtils::StartsWith(it->first, directory))
+      it = m_polled.erase(it);
+    else
+      ++it;
+  }
+}
+
+void CLibraryWatcher::ReadEvents(unsigned int timeout)
+{
+#ifdef HAVE_INOTIFY
+  struct pollfd pfd = { m_fd, POLLIN, 0 };
+  if (poll(&pfd, 1, timeout) <= 0)
+    return;
+
+  char buffer[4096] __attribute__((aligned(__alignof__(struct inotify_event))));
+  ssize_t length;
+  while ((length = read(m_fd, buffer, sizeof(buffer))) > 0)
+  {
+    const struct inotify_event* event;
+    for (char* ptr = buffer; ptr < buffer + length; ptr += sizeof(struct inotify_event) + event->len)
+    {
+      event = reinterpret_cast<const struct inotify_event*>(ptr);
+
+      if (event->mask & IN_Q_OVERFLOW)
+      {
+        if (m_changed.empty() && !m_overflow)
+          m_firstChange = XbmcThreads::SystemClockMillis();
+        m_lastChange = XbmcThreads::SystemClockMillis();
+        m_overflow = true;
+        continue;
+      }
+
+      auto it = m_watches.find(event->wd);
+      if (it == m_watches.end())
+        continue;
+
+      if (event->mask & IN_IGNORED)
+      { // directory was removed, its parent gets notified as well
+        m_watches.erase(it);
+        continue;
+      }
+
+      std::string directory = it->second;
+      if ((event->mask & IN_ISDIR) && (event->mask & (IN_CREATE | IN_MOVED_TO)))
+        AddWatches(directory + event->name + "/");
+      else if ((event->mask & IN_ISDIR) && (event->mask & IN_MOVED_FROM))
+        RemoveWatches(directory + event->name + "/");
+
+      OnChanged(directory);
+    }
+  }
+#endif
+}
+
+void CLibraryWatcher::AddPolledDirectories(const std::string& directory)
+{
+  struct __stat64 buffer;
+  if (CFile::Stat(directory, &buffer) != 0 || buffer.st_mtime == 0)
+    return;
+  m_polled[directory] = buffer.st_mtime;
+
+  CFileItemList items;
+  CDirectory::GetDirectory(directory, items, "/", DIR_FLAG_NO_FILE_DIRS | DIR_FLAG_BYPASS_CACHE);
+  for (const auto& item : items)
+  {
+    if (m_bStop)
+      return;
+
+    // known subdirectories are polled on their own
+    if (item->m_bIsFolder && !item->IsParentFolder() && m_polled.find(item->GetPath()) == m_polled.end())
+      AddPolledDirectories(item->GetPath());
+  }
+}
+
+void CLibraryWatcher::PollDirectories()
+{
+  m_lastPoll = XbmcThreads::SystemClockMillis();
+
+  // the modification time of a directory changes when entries are added,
+  // removed or renamed, which is what a library update is looking for
+  std::vector<std::string> changed, removed;
+  for (const auto& polled : m_polled)
+  {
+    if (m_bStop)
+      return;
+
+    struct __stat64 buffer;
+    if (CFile::Stat(polled.first, &buffer) != 0)
+      removed.push_back(polled.first);
+    else if (buffer.st_mtime != polled.second)
+      changed.push_back(polled.first);
+  }
+
+  for (const auto& directory : removed)
+  {
+    RemoveWatches(directory);
+    OnChanged(URIUtils::GetParentPath(directory));
+  }
+
+  for (const auto& directory : changed)
+  {
+    // takes the new time and walks new subdirectories
+    AddPolledDirectories(directory);
+    OnChanged(directory);
+  }
+}
@@ -0,0 +1,96 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+
+#include <atomic>
+#include <ctime>
+#include <map>
+#include <string>
+#include <vector>
+
+/*!
+ \brief Watches the library sources and queues scans of the changed directories only.
+
+ Local sources are watched with inotify where available. Network shares are
+ polled by comparing the modification times of their directories, which needs
+ one stat per directory instead of one per file. Changes are coalesced and a
+ scan is queued once the sources have been quiet for a few seconds.
+ */
+class CLibraryWatcher : protected CThread
+{
+public:
+  CLibraryWatcher();
+  ~CLibraryWatcher() override;
+
+  /*!
+   \brief Watch the sources of the libraries enabled in the settings.
+   Re-reads the sources if already running, stops if no library is enabled.
+   The sources are copied, call it on the thread changing them.
+   */
+  void Start();
+  void Stop();
+
+  enum Library
+  {
+    LIBRARY_NONE = 0,
+    LIBRARY_VIDEO = 1 << 0,
+    LIBRARY_MUSIC = 1 << 1
+  };
+
+  /*!
+   \brief Get the libraries of the sources a directory is in.
+   \param roots source path -> libraries
+   */
+  static int GetLibraries(const std::map<std::string, int>& roots, const std::string& directory);
+
+  /*!
+   \brief Get the directories to unwatch and walk when the watched sources change.
+   \param unwatch removed sources that aren't within any of the remaining ones
+   \param watch added sources and those that were within an unwatched one,
+                unless they are within a source that stays watched or is walked
+   */
+  static void GetRootChanges(const std::map<std::string, int>& oldRoots, const std::map<std::string, int>& roots,
+                             std::vector<std::string>& unwatch, std::vector<std::string>& watch);
+
+protected:
+  void Process() override;
+
+private:
+  static std::map<std::string, int> GetSources();
+  void UpdateRoots(const std::map<std::string, int>& roots);
+  void OnChanged(const std::string& directory);
+  void QueueScans();
+
+  void AddWatches(const std::string& directory);
+  void RemoveWatches(const std::string& directory);
+  void ReadEvents(unsigned int timeout);
+
+  void AddPolledDirectories(const std::string& directory);
+  void PollDirectories();
+
+  std::map<std::string, int> m_roots; ///< source path -> libraries
+  std::map<std::string, int> m_sources; ///< sources copied by Start()
+  std::atomic_bool m_refresh;
+  CCriticalSection m_critSection;
+
+  int m_fd = -1; ///< inotify instance
+  std::map<int, std::string> m_watches; ///< watch descriptor -> directory
+  bool m_watchLimit = false;
+
+  std::map<std::string, time_t> m_polled; ///< network directory -> modification time
+  unsigned int m_lastPoll = 0;
+
+  std::map<std::string, int> m_changed; ///< changed directory -> libraries
+  bool m_overflow = false;
+  unsigned int m_firstChange = 0;
+  unsigned int m_lastChange = 0;
+};
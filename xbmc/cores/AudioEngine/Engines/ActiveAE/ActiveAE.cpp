@@ -30,6 +30,12 @@ using namespace ActiveAE;
 #define MAX_WATER_LEVEL 0.2   // buffered time after stream stages in seconds
 #define MAX_BUFFER_TIME 0.1   // max time of a buffer in seconds
 
+// low latency profile for games and interactive use
+#define LOWLATENCY_CACHE_LEVEL 0.1
+#define LOWLATENCY_WATER_LEVEL 0.05
+#define LOWLATENCY_BUFFER_TIME 0.02
+#define LOWLATENCY_ERROR_INTERVAL 300 // ms to average the sync error
+
 void CEngineStats::Reset(unsigned int sampleRate, bool pcm)
 {
   CSingleLock lock(m_lock);
@@ -185,6 +191,29 @@ void CEngineStats::GetSyncInfo(CAESyncInfo& info, CActiveAEStream *stream)
   }
 }
 
+void CEngineStats::GetLatencyInfo(CAELatencyInfo& info, CActiveAEStream *stream)
+{
+  CSingleLock lock(m_lock);
+  info.lowLatency = m_lowLatency;
+  info.sink = m_sinkDelay.GetDelay();
+  info.hardware = m_sinkLatency;
+  if (m_pcmOutput)
+    info.engine = (double)m_bufferedSamples / m_sinkSampleRate;
+  else
+    info.engine = (double)m_bufferedSamples * m_sinkFormat.m_streamInfo.GetDuration() / 1000;
+
+  for (auto &str : m_streamStats)
+  {
+    if (str.m_streamId == stream->m_id)
+    {
+      CSingleLock lock(stream->m_statsLock);
+      info.stream = stream->m_bufferedTime / str.m_resampleRatio;
+      info.processing = str.m_bufferedTime / str.m_resampleRatio;
+      return;
+    }
+  }
+}
+
 float CEngineStats::GetCacheTime(CActiveAEStream *stream)
 {
   CSingleLock lock(m_lock);
@@ -203,14 +232,35 @@ float CEngineStats::GetCacheTime(CActiveAEStream *stream)
   return delay;
 }
 
+void CEngineStats::SetBufferProfile(bool lowLatency)
+{
+  CSingleLock lock(m_lock);
+  m_lowLatency = lowLatency;
+  m_cacheLevel = lowLatency ? LOWLATENCY_CACHE_LEVEL : MAX_CACHE_LEVEL;
+  m_waterLevel = lowLatency ? LOWLATENCY_WATER_LEVEL : MAX_WATER_LEVEL;
+}
+
+bool CEngineStats::IsLowLatency()
+{
+  CSingleLock lock(m_lock);
+  return m_lowLatency;
+}
+
 float CEngineStats::GetCacheTotal()
 {
-  return MAX_CACHE_LEVEL;
+  CSingleLock lock(m_lock);
+  return m_cacheLevel;
+}
+
+float CEngineStats::GetWaterLevelTotal()
+{
+  CSingleLock lock(m_lock);
+  return m_waterLevel;
 }
 
 float CEngineStats::GetMaxDelay() const
 {
-  return MAX_CACHE_LEVEL + MAX_WATER_LEVEL + m_sinkCacheTotal;
+  return m_cacheLevel + m_waterLevel + m_sinkCacheTotal;
 }
 
 float CEngineStats::GetWaterLevel()
@@ -268,6 +318,7 @@ CActiveAE::CActiveAE() :
   m_sinkHasVolume = false;
   m_aeGUISoundForce = false;
   m_stats.Reset(44100, true);
+  m_stats.SetBufferProfile(false);
   m_streamIdGen = 0;
 
   m_settingsHandler.reset(new CActiveAESettings(*this));
@@ -759,6 +810,9 @@ void CActiveAE::StateMachine(int signal, Protocol *port, Message *msg)
           msgData->stream->m_processingSamples.pop_front();
           if (samples != msgData->buffer)
             CLog::Log(LOGERROR, "CActiveAE - inconsistency in stream sample message");
+          // a referenced frame sent while the stream was reconfigured must not be mixed in place
+          if (msgData->buffer->frame && !msgData->stream->m_processingBuffers->IsResampling())
+            msgData->buffer->DetachFrame(true);
           if (msgData->buffer->pkt->nb_samples == 0)
             msgData->buffer->Return();
           else
@@ -1141,7 +1195,8 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
   CAESinkFactory::ParseDevice(device, driver);
   if ((!CompareFormat(m_sinkRequestFormat, m_sinkFormat) && !CompareFormat(m_sinkRequestFormat, oldSinkRequestFormat)) ||
       m_currDevice.compare(device) != 0 ||
-      m_settings.driver.compare(driver) != 0)
+      m_settings.driver.compare(driver) != 0 ||
+      m_stats.IsLowLatency() != m_settings.lowLatency)
   {
     FlushEngine();
     if (!InitSink())
@@ -1150,16 +1205,18 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
     m_currDevice = device;
     initSink = true;
     m_stats.Reset(m_sinkFormat.m_sampleRate, m_mode == MODE_PCM);
+    m_stats.SetBufferProfile(m_settings.lowLatency);
     m_sink.m_controlPort.SendOutMessage(CSinkControlProtocol::VOLUME, &m_volume, sizeof(float));
 
     if (m_sinkRequestFormat.m_dataFormat != AE_FMT_RAW)
     {
       // limit buffer size in case of sink returns large buffer
+      double maxbuffertime = m_settings.lowLatency ? LOWLATENCY_BUFFER_TIME : MAX_BUFFER_TIME;
       double buffertime = (double)m_sinkFormat.m_frames / m_sinkFormat.m_sampleRate;
-      if (buffertime > MAX_BUFFER_TIME)
+      if (buffertime > maxbuffertime)
       {
-        CLog::Log(LOGWARNING, "ActiveAE::%s - sink returned large buffer of %d ms, reducing to %d ms", __FUNCTION__, (int)(buffertime * 1000), (int)(MAX_BUFFER_TIME*1000));
-        m_sinkFormat.m_frames = MAX_BUFFER_TIME * m_sinkFormat.m_sampleRate;
+        CLog::Log(LOGWARNING, "ActiveAE::%s - sink returned large buffer of %d ms, reducing to %d ms", __FUNCTION__, (int)(buffertime * 1000), (int)(maxbuffertime*1000));
+        m_sinkFormat.m_frames = maxbuffertime * m_sinkFormat.m_sampleRate;
       }
     }
   }
@@ -1183,7 +1240,7 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
     inputFormat.m_frameSize = inputFormat.m_channelLayout.Count() *
                               (CAEUtil::DataFormatToBits(inputFormat.m_dataFormat) >> 3);
     m_silenceBuffers = new CActiveAEBufferPool(inputFormat);
-    m_silenceBuffers->Create(MAX_WATER_LEVEL*1000);
+    m_silenceBuffers->Create(m_stats.GetWaterLevelTotal()*1000);
     sinkInputFormat = inputFormat;
     m_internalFormat = inputFormat;
 
@@ -1263,7 +1320,7 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
         if (!m_encoderBuffers)
         {
           m_encoderBuffers = new CActiveAEBufferPool(format);
-          m_encoderBuffers->Create(MAX_WATER_LEVEL*1000);
+          m_encoderBuffers->Create(m_stats.GetWaterLevelTotal()*1000);
         }
       }
 
@@ -1305,7 +1362,7 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
 
         // create buffer pool
         (*it)->m_inputBuffers = new CActiveAEBufferPool((*it)->m_format);
-        (*it)->m_inputBuffers->Create(MAX_CACHE_LEVEL*1000);
+        (*it)->m_inputBuffers->Create(m_stats.GetCacheTotal()*1000);
         (*it)->m_streamSpace = (*it)->m_format.m_frameSize * (*it)->m_format.m_frames;
 
         // if input format does not follow ffmpeg channel mask, we may need to remap channels
@@ -1324,8 +1381,10 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
         (*it)->m_processingBuffers = new CActiveAEStreamBuffers((*it)->m_inputBuffers->m_format, outputFormat, m_settings.resampleQuality);
         (*it)->m_processingBuffers->ForceResampler((*it)->m_forceResampler);
 
-        (*it)->m_processingBuffers->Create(MAX_CACHE_LEVEL*1000, false, m_settings.stereoupmix, m_settings.normalizelevels);
+        (*it)->m_processingBuffers->Create(m_stats.GetCacheTotal()*1000, false, m_settings.stereoupmix, m_settings.normalizelevels);
       }
+      // decoded frames can be referenced if the resample stage copies them anyway
+      (*it)->m_zeroCopy = m_mode != MODE_RAW && (*it)->m_processingBuffers->IsResampling();
       if (m_mode == MODE_TRANSCODE || m_streams.size() > 1)
         (*it)->m_processingBuffers->FillBuffer();
 
@@ -1382,7 +1441,7 @@ void CActiveAE::Configure(AEAudioFormat *desiredFmt)
   if (!m_sinkBuffers)
   {
     m_sinkBuffers = new CActiveAEBufferPoolResample(sinkInputFormat, m_sinkFormat, m_settings.resampleQuality);
-    m_sinkBuffers->Create(MAX_WATER_LEVEL*1000, true, false);
+    m_sinkBuffers->Create(m_stats.GetWaterLevelTotal()*1000, true, false);
   }
 
   // reset gui sounds
@@ -1447,6 +1506,9 @@ CActiveAEStream* CActiveAE::CreateStream(MsgStreamNew *streamMsg)
   if (streamMsg->options & AESTREAM_FORCE_RESAMPLE)
     stream->m_forceResampler = true;
 
+  if (m_settings.lowLatency)
+    stream->m_errorInterval = LOWLATENCY_ERROR_INTERVAL;
+
   stream->m_pClock = streamMsg->clock;
 
   m_streams.push_back(stream);
@@ -1735,7 +1797,8 @@ bool CActiveAE::NeedReconfigureSink()
 
   if (!CompareFormat(newFormat, m_sinkFormat) ||
       m_currDevice.compare(device) != 0 ||
-      m_settings.driver.compare(driver) != 0)
+      m_settings.driver.compare(driver) != 0 ||
+      m_stats.IsLowLatency() != m_settings.lowLatency)
     return true;
 
   return false;
@@ -1877,7 +1940,7 @@ bool CActiveAE::RunStages()
       float buftime = (float)(*it)->m_inputBuffers->m_format.m_frames / (*it)->m_inputBuffers->m_format.m_sampleRate;
       if ((*it)->m_inputBuffers->m_format.m_dataFormat == AE_FMT_RAW)
         buftime = (*it)->m_inputBuffers->m_format.m_streamInfo.GetDuration() / 1000;
-      while ((time < MAX_CACHE_LEVEL || (*it)->m_streamIsBuffering) && !(*it)->m_inputBuffers->m_freeSamples.empty())
+      while ((time < m_stats.GetCacheTotal() || (*it)->m_streamIsBuffering) && !(*it)->m_inputBuffers->m_freeSamples.empty())
       {
         buffer = (*it)->m_inputBuffers->GetFreeBuffer();
         (*it)->m_processingSamples.push_back(buffer);
@@ -1916,7 +1979,7 @@ bool CActiveAE::RunStages()
     }
   }
 
-  if (m_stats.GetWaterLevel() < MAX_WATER_LEVEL &&
+  if (m_stats.GetWaterLevel() < m_stats.GetWaterLevelTotal() &&
      (m_mode != MODE_TRANSCODE || (m_encoderBuffers && !m_encoderBuffers->m_freeSamples.empty())))
   {
     // calculate sync error
@@ -2607,6 +2670,7 @@ void CActiveAE::LoadSettings()
 
   m_settings.resampleQuality = static_cast<AEQuality>(settings->GetInt(CSettings::SETTING_AUDIOOUTPUT_PROCESSQUALITY));
   m_settings.atempoThreshold = settings->GetInt(CSettings::SETTING_AUDIOOUTPUT_ATEMPOTHRESHOLD) / 100.0;
+  m_settings.lowLatency = settings->GetBool(CSettings::SETTING_AUDIOOUTPUT_LOWLATENCY);
   m_settings.streamNoise = settings->GetBool(CSettings::SETTING_AUDIOOUTPUT_STREAMNOISE);
   m_settings.silenceTimeout = settings->GetInt(CSettings::SETTING_AUDIOOUTPUT_STREAMSILENCE) * 60000;
 }
@@ -59,6 +59,7 @@ struct AudioSettings
   unsigned int samplerate;
   AEQuality resampleQuality;
   double atempoThreshold;
+  bool lowLatency;
   bool streamNoise;
   int silenceTimeout;
 };
@@ -182,10 +183,14 @@ public:
   void UpdateStream(CActiveAEStream *stream);
   void GetDelay(AEDelayStatus& status, CActiveAEStream *stream);
   void GetSyncInfo(CAESyncInfo& info, CActiveAEStream *stream);
+  void GetLatencyInfo(CAELatencyInfo& info, CActiveAEStream *stream);
   float GetCacheTime(CActiveAEStream *stream);
   float GetCacheTotal();
   float GetMaxDelay() const;
   float GetWaterLevel();
+  float GetWaterLevelTotal();
+  void SetBufferProfile(bool lowLatency);
+  bool IsLowLatency();
   void SetSuspended(bool state);
   void SetCurrentSinkFormat(const AEAudioFormat& SinkFormat);
   void SetSinkCacheTotal(float time) { m_sinkCacheTotal = time; }
@@ -201,6 +206,9 @@ protected:
   bool m_suspended;
   AEAudioFormat m_sinkFormat;
   bool m_pcmOutput;
+  bool m_lowLatency;
+  float m_cacheLevel;
+  float m_waterLevel;
   CCriticalSection m_lock;
   struct StreamStats
   {
@@ -269,6 +277,7 @@ protected:
   static void FreeSoundSample(uint8_t **data);
   void GetDelay(AEDelayStatus& status, CActiveAEStream *stream) { m_stats.GetDelay(status, stream); }
   void GetSyncInfo(CAESyncInfo& info, CActiveAEStream *stream) { m_stats.GetSyncInfo(info, stream); }
+  void GetLatencyInfo(CAELatencyInfo& info, CActiveAEStream *stream) { m_stats.GetLatencyInfo(info, stream); }
   float GetCacheTime(CActiveAEStream *stream) { return m_stats.GetCacheTime(stream); }
   float GetCacheTotal() { return m_stats.GetCacheTotal(); }
   float GetMaxDelay() { return m_stats.GetMaxDelay(); }
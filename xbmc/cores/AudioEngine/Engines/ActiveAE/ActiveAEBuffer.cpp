@@ -12,6 +12,8 @@
 #include "cores/AudioEngine/Utils/AEUtil.h"
 #include "cores/AudioEngine/AEResampleFactory.h"
 
+#include <cstring>
+
 using namespace ActiveAE;
 
 CSoundPacket::CSoundPacket(SampleConfig conf, int samples) : config(conf)
@@ -34,6 +36,7 @@ CSampleBuffer::CSampleBuffer()
 
 CSampleBuffer::~CSampleBuffer()
 {
+  DetachFrame(false);
   delete pkt;
 }
 
@@ -50,6 +53,35 @@ void CSampleBuffer::Return()
     pool->ReturnBuffer(this);
 }
 
+void CSampleBuffer::AttachFrame(AVFrame *avframe)
+{
+  DetachFrame(false);
+  frame = avframe;
+  ownData = pkt->data;
+  pkt->data = frame->extended_data;
+  pkt->nb_samples = frame->nb_samples;
+}
+
+void CSampleBuffer::DetachFrame(bool copy)
+{
+  if (!frame)
+    return;
+
+  uint8_t **frameData = pkt->data;
+  pkt->data = ownData;
+  ownData = nullptr;
+
+  // frames larger than the buffer are never attached, see CActiveAEStream::AddFrame
+  if (copy)
+  {
+    int bytes = pkt->nb_samples * pkt->bytes_per_sample * pkt->config.channels / pkt->planes;
+    for (int i = 0; i < pkt->planes; i++)
+      memcpy(pkt->data[i], frameData[i], bytes);
+  }
+
+  av_frame_free(&frame);
+}
+
 CActiveAEBufferPool::CActiveAEBufferPool(const AEAudioFormat& format)
 {
   m_format = format;
@@ -89,6 +121,7 @@ CSampleBuffer* CActiveAEBufferPool::GetFreeBuffer()
 
 void CActiveAEBufferPool::ReturnBuffer(CSampleBuffer *buffer)
 {
+  buffer->DetachFrame(false);
   buffer->pkt->nb_samples = 0;
   buffer->pkt->pause_burst_ms = 0;
   m_freeSamples.push_back(buffer);
@@ -458,6 +491,11 @@ void CActiveAEBufferPoolResample::ForceResampler(bool force)
   m_forceResampler = force;
 }
 
+bool CActiveAEBufferPoolResample::IsResampling() const
+{
+  return m_resampler != nullptr;
+}
+
 
 // ----------------------------------------------------------------------------------
 // Atempo
@@ -16,6 +16,7 @@
 
 extern "C" {
 #include <libavutil/avutil.h>
+#include <libavutil/frame.h>
 #include <libswresample/swresample.h>
 }
 
@@ -49,12 +50,16 @@ public:
   ~CSampleBuffer();
   CSampleBuffer *Acquire();
   void Return();
+  void AttachFrame(AVFrame *frame);
+  void DetachFrame(bool copy);
   CSoundPacket *pkt = nullptr;
   CActiveAEBufferPool *pool = nullptr;
   int64_t timestamp;
   int pkt_start_offset = 0;
   int refCount = 0;
   double centerMixLevel;
+  AVFrame *frame = nullptr;              // decoder frame pkt->data points into, owned until returned
+  uint8_t **ownData = nullptr;           // planes of pkt while a frame is attached
 };
 
 class CActiveAEBufferPool
@@ -89,6 +94,7 @@ public:
   void FillBuffer();
   bool DoesNormalize() const;
   void ForceResampler(bool force);
+  bool IsResampling() const;
   AEAudioFormat m_inputFormat;
   std::deque<CSampleBuffer*> m_inputSamples;
   std::deque<CSampleBuffer*> m_outputSamples;
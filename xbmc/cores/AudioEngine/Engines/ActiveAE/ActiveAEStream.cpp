@@ -51,6 +51,7 @@ CActiveAEStream::CActiveAEStream(AEAudioFormat *format, unsigned int streamid, C
   m_lastPts = 0;
   m_lastPtsJump = 0;
   m_errorInterval = 1000;
+  m_zeroCopy = false;
   m_clockSpeed = 1.0;
 }
 
@@ -264,22 +265,7 @@ unsigned int CActiveAEStream::AddData(const uint8_t* const *data, unsigned int o
 
       if (!copied)
       {
-        if (pts < m_lastPts)
-        {
-          if (m_lastPtsJump != 0)
-          {
-            int diff = pts - m_lastPtsJump;
-            if (diff > m_errorInterval)
-            {
-              diff += 1000;
-              diff = std::min(diff, 6000);
-              CLog::Log(LOGNOTICE, "CActiveAEStream::AddData - messy timestamps, increasing interval for measuring average error to %d ms", diff);
-              m_errorInterval = diff;
-            }
-          }
-          m_lastPtsJump = pts;
-        }
-        m_lastPts = pts;
+        TrackTimestamp(pts);
         m_currentBuffer->timestamp = pts;
         m_currentBuffer->pkt_start_offset = m_currentBuffer->pkt->nb_samples;
       }
@@ -310,14 +296,7 @@ unsigned int CActiveAEStream::AddData(const uint8_t* const *data, unsigned int o
       }
 
       if (m_currentBuffer->pkt->nb_samples == m_currentBuffer->pkt->max_nb_samples || rawPktComplete)
-      {
-        MsgStreamSample msgData;
-        msgData.buffer = m_currentBuffer;
-        msgData.stream = this;
-        RemapBuffer();
-        m_streamPort->SendOutMessage(CActiveAEDataProtocol::STREAMSAMPLE, &msgData, sizeof(MsgStreamSample));
-        m_currentBuffer = nullptr;
-      }
+        SendCurrentBuffer();
       continue;
     }
     else if (m_streamPort->ReceiveInMessage(&msg))
@@ -345,6 +324,123 @@ unsigned int CActiveAEStream::AddData(const uint8_t* const *data, unsigned int o
   return copied;
 }
 
+bool CActiveAEStream::CanAddFrame(const AVFrame *frame)
+{
+  // the engine only allows this while the resample stage of the stream
+  // converts the samples anyway, a referenced frame never reaches the mixer
+  if (!m_zeroCopy || m_remapper || m_format.m_dataFormat == AE_FMT_RAW)
+    return false;
+
+  if (!frame->buf[0] ||
+      frame->format != CAEUtil::GetAVSampleFormat(m_format.m_dataFormat) ||
+      frame->channels != static_cast<int>(m_format.m_channelLayout.Count()) ||
+      frame->sample_rate != static_cast<int>(m_format.m_sampleRate))
+    return false;
+
+  // small frames would use up the buffers of the pool before the cache is filled,
+  // large ones could not be copied back into a pool buffer on a reconfigure
+  return frame->nb_samples >= static_cast<int>(m_format.m_frames / 2) &&
+         frame->nb_samples <= static_cast<int>(m_format.m_frames);
+}
+
+unsigned int CActiveAEStream::AddFrame(const AVFrame *frame, ExtData *extData)
+{
+  Message *msg;
+  double pts = 0;
+
+  if (extData)
+  {
+    pts = extData->pts;
+  }
+
+  m_streamIsFlushed = false;
+
+  // samples copied by AddData go first, the engine accepts short buffers
+  if (m_currentBuffer && m_currentBuffer->pkt->nb_samples > 0)
+    SendCurrentBuffer();
+
+  while (!m_currentBuffer)
+  {
+    if (m_streamPort->ReceiveInMessage(&msg))
+    {
+      if (msg->signal == CActiveAEDataProtocol::STREAMBUFFER)
+      {
+        m_currentBuffer = *((CSampleBuffer**)msg->data);
+        m_currentBuffer->timestamp = 0;
+        m_currentBuffer->pkt->nb_samples = 0;
+        m_currentBuffer->pkt->pause_burst_ms = 0;
+        msg->Release();
+        DecFreeBuffers();
+      }
+      else
+      {
+        CLog::Log(LOGERROR, "CActiveAEStream::AddFrame - unknown signal");
+        msg->Release();
+        return 0;
+      }
+    }
+    else if (!m_inMsgEvent.WaitMSec(200))
+      return 0;
+  }
+
+  // the pool buffer must be able to hold the samples if the frame gets detached
+  if (frame->nb_samples > m_currentBuffer->pkt->max_nb_samples)
+    return AddData(frame->extended_data, 0, frame->nb_samples, extData);
+
+  AVFrame *ref = av_frame_clone(frame);
+  if (!ref)
+  {
+    CLog::Log(LOGERROR, "CActiveAEStream::AddFrame - failed to reference frame");
+    return 0;
+  }
+
+  TrackTimestamp(pts);
+  m_currentBuffer->AttachFrame(ref);
+  m_currentBuffer->timestamp = pts;
+  m_currentBuffer->pkt_start_offset = 0;
+
+  if (extData && extData->hasDownmix)
+    m_currentBuffer->centerMixLevel = extData->centerMixLevel;
+
+  {
+    CSingleLock lock(m_statsLock);
+    m_bufferedTime += (double)frame->nb_samples / m_currentBuffer->pkt->config.sample_rate;
+  }
+
+  SendCurrentBuffer();
+  return frame->nb_samples;
+}
+
+void CActiveAEStream::SendCurrentBuffer()
+{
+  MsgStreamSample msgData;
+  msgData.buffer = m_currentBuffer;
+  msgData.stream = this;
+  RemapBuffer();
+  m_streamPort->SendOutMessage(CActiveAEDataProtocol::STREAMSAMPLE, &msgData, sizeof(MsgStreamSample));
+  m_currentBuffer = nullptr;
+}
+
+void CActiveAEStream::TrackTimestamp(double pts)
+{
+  if (pts < m_lastPts)
+  {
+    if (m_lastPtsJump != 0)
+    {
+      int diff = pts - m_lastPtsJump;
+      if (diff > m_errorInterval)
+      {
+        diff += 1000;
+        diff = std::min(diff, 6000);
+        CLog::Log(LOGNOTICE, "CActiveAEStream::AddData - messy timestamps, increasing interval for measuring average error to %d ms", diff);
+        m_errorInterval = diff;
+      }
+    }
+    m_lastPtsJump = pts;
+  }
+  m_lastPts = pts;
+}
+
 double CActiveAEStream::GetDelay()
 {
   AEDelayStatus status;
@@ -359,6 +455,13 @@ CAESyncInfo CActiveAEStream::GetSyncInfo()
   return info;
 }
 
+CAELatencyInfo CActiveAEStream::GetLatencyInfo()
+{
+  CAELatencyInfo info;
+  m_activeAE->GetLatencyInfo(info, this);
+  return info;
+}
+
 bool CActiveAEStream::IsBuffering()
 {
   CSingleLock lock(m_streamLock);
@@ -754,6 +857,11 @@ void CActiveAEStreamBuffers::ForceResampler(bool force)
   m_resampleBuffers->ForceResampler(force);
 }
 
+bool CActiveAEStreamBuffers::IsResampling()
+{
+  return m_resampleBuffers->IsResampling();
+}
+
 CActiveAEBufferPool* CActiveAEStreamBuffers::GetResampleBuffers()
 {
   CActiveAEBufferPool *ret = m_resampleBuffers;
@@ -105,6 +105,7 @@ public:
   void FillBuffer();
   bool DoesNormalize();
   void ForceResampler(bool force);
+  bool IsResampling();
   bool HasWork();
   CActiveAEBufferPool *GetResampleBuffers();
   CActiveAEBufferPool *GetAtempoBuffers();
@@ -135,14 +136,19 @@ protected:
   void ResetFreeBuffers();
   void InitRemapper();
   void RemapBuffer();
+  void SendCurrentBuffer();
+  void TrackTimestamp(double pts);
   double CalcResampleRatio(double error);
   int GetErrorInterval();
 
 public:
   unsigned int GetSpace() override;
   unsigned int AddData(const uint8_t* const *data, unsigned int offset, unsigned int frames, ExtData *extData) override;
+  bool CanAddFrame(const AVFrame *frame) override;
+  unsigned int AddFrame(const AVFrame *frame, ExtData *extData) override;
   double GetDelay() override;
   CAESyncInfo GetSyncInfo() override;
+  CAELatencyInfo GetLatencyInfo() override;
   bool IsBuffering() override;
   double GetCacheTime() override;
   double GetCacheTotal() override;
@@ -206,6 +212,7 @@ protected:
   double m_lastPts;
   double m_lastPtsJump;
   std::atomic_int m_errorInterval;
+  std::atomic_bool m_zeroCopy;
 
   // only accessed by engine
   CActiveAEBufferPool *m_inputBuffers;
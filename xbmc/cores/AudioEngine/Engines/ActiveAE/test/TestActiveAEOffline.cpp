@@ -0,0 +1,426 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "cores/AudioEngine/Engines/ActiveAE/ActiveAE.h"
+#include "cores/AudioEngine/Interfaces/AESound.h"
+#include "cores/AudioEngine/Interfaces/AEStream.h"
+#include "cores/AudioEngine/Sinks/AESinkOffline.h"
+#include "cores/AudioEngine/Utils/AEPackIEC61937.h"
+#include "cores/AudioEngine/Utils/AEStreamInfo.h"
+#include "settings/Settings.h"
+#include "settings/SettingsComponent.h"
+#include "test/TestUtils.h"
+#include "threads/SystemClock.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace ActiveAE;
+
+namespace
+{
+
+// bytes of an AC3 frame at 448 kbit/s, 48 kHz
+constexpr unsigned int AC3_FRAME_BYTES = 1792;
+// data type of AC3 bursts in the IEC 61937 preamble
+constexpr uint8_t IEC61937_AC3 = 0x01;
+
+const std::string ChangedSettings[] = {
+  CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE,
+  CSettings::SETTING_AUDIOOUTPUT_PASSTHROUGHDEVICE,
+  CSettings::SETTING_AUDIOOUTPUT_CONFIG,
+  CSettings::SETTING_AUDIOOUTPUT_CHANNELS,
+  CSettings::SETTING_AUDIOOUTPUT_GUISOUNDMODE,
+  CSettings::SETTING_AUDIOOUTPUT_STREAMSILENCE,
+  CSettings::SETTING_AUDIOOUTPUT_PASSTHROUGH,
+  CSettings::SETTING_AUDIOOUTPUT_AC3PASSTHROUGH,
+  CSettings::SETTING_AUDIOOUTPUT_AC3TRANSCODE,
+};
+
+struct SRenderResult
+{
+  double audioSeconds = 0.0; ///< seconds of audio handed to the engine, after atempo
+  double cpuSeconds = 0.0; ///< cpu of the whole process, engine and sink thread included
+};
+
+AEAudioFormat MakePCMFormat(const CAEChannelInfo& layout, unsigned int rate)
+{
+  AEAudioFormat format;
+  format.m_dataFormat = AE_FMT_S16NE;
+  format.m_channelLayout = layout;
+  format.m_sampleRate = rate;
+  format.m_frames = rate / 100;
+  format.m_frameSize = layout.Count() * 2;
+  return format;
+}
+
+AEAudioFormat MakeAC3Format()
+{
+  AEAudioFormat format;
+  format.m_dataFormat = AE_FMT_RAW;
+  format.m_streamInfo.m_type = CAEStreamInfo::STREAM_TYPE_AC3;
+  format.m_streamInfo.m_sampleRate = 48000;
+  format.m_streamInfo.m_channels = 6;
+  format.m_streamInfo.m_ac3FrameSize = AC3_FRAME_BYTES;
+  format.m_streamInfo.m_repeat = 1;
+  format.m_sampleRate = 48000;
+  format.m_frameSize = 1;
+  for (unsigned int i = 0; i < format.m_streamInfo.m_channels; i++)
+    format.m_channelLayout += AE_CH_RAW;
+  return format;
+}
+
+/// seconds between the first and the last sample of the PCM capture above the noise floor
+double SignalSeconds(const CAESinkOffline::Output& output)
+{
+  const int32_t* samples = reinterpret_cast<const int32_t*>(output.capture.data());
+  const size_t count = output.capture.size() / sizeof(int32_t);
+  const int64_t floor = INT32_MAX / 1000;
+
+  size_t first = count;
+  size_t last = 0;
+  for (size_t i = 0; i < count; i++)
+  {
+    if (std::abs(static_cast<int64_t>(samples[i])) > floor)
+    {
+      first = std::min(first, i);
+      last = i;
+    }
+  }
+  if (first == count)
+    return 0.0;
+
+  return static_cast<double>((last - first) / output.format.m_channelLayout.Count()) /
+         output.format.m_sampleRate;
+}
+
+/// number of IEC 61937 bursts of the given data type in the capture
+unsigned int CountBursts(const CAESinkOffline::Output& output, uint8_t dataType)
+{
+  const std::vector<uint8_t>& capture = output.capture;
+  unsigned int bursts = 0;
+  for (size_t i = 0; i + 6 <= capture.size(); i += 2)
+  {
+    if (capture[i] == 0x72 && capture[i + 1] == 0xF8 &&
+        capture[i + 2] == 0x1F && capture[i + 3] == 0x4E &&
+        (capture[i + 4] & 0x1F) == dataType)
+      bursts++;
+  }
+  return bursts;
+}
+
+void Report(const std::string& name, const SRenderResult& result)
+{
+  std::cout << "[ BENCH    ] " << name << ": " << result.audioSeconds << " s audio, "
+            << result.cpuSeconds * 1000 / result.audioSeconds << " ms cpu per s of audio" << std::endl;
+}
+
+}
+
+/**
+ * Runs the real engine against the offline sink. The engine and its sink
+ * thread render as fast as they can, streams are fed from the test thread.
+ */
+class TestActiveAEOffline : public testing::Test
+{
+protected:
+  void TearDown() override
+  {
+    Stop();
+
+    const std::shared_ptr<CSettings> settings = CServiceBroker::GetSettingsComponent()->GetSettings();
+    for (const std::string& setting : ChangedSettings)
+      settings->SetDefault(setting);
+  }
+
+  void Start(const std::string& device, bool passthrough = false, int channels = AE_CH_LAYOUT_7_1)
+  {
+    CAESinkOffline::Register();
+
+    const std::shared_ptr<CSettings> settings = CServiceBroker::GetSettingsComponent()->GetSettings();
+    settings->SetString(CSettings::SETTING_AUDIOOUTPUT_AUDIODEVICE, "OFFLINE:" + device);
+    settings->SetString(CSettings::SETTING_AUDIOOUTPUT_PASSTHROUGHDEVICE, "OFFLINE:" + device);
+    settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_CONFIG, AE_CONFIG_AUTO);
+    settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_CHANNELS, channels);
+    settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_GUISOUNDMODE, AE_SOUND_ALWAYS);
+    // the sink stops once there are no streams instead of writing silence
+    settings->SetInt(CSettings::SETTING_AUDIOOUTPUT_STREAMSILENCE, 0);
+    settings->SetBool(CSettings::SETTING_AUDIOOUTPUT_PASSTHROUGH, passthrough);
+    settings->SetBool(CSettings::SETTING_AUDIOOUTPUT_AC3PASSTHROUGH, passthrough);
+    settings->SetBool(CSettings::SETTING_AUDIOOUTPUT_AC3TRANSCODE, passthrough);
+
+    m_engine.reset(new CActiveAE());
+    m_engine->Start();
+  }
+
+  void Stop()
+  {
+    if (!m_engine)
+      return;
+    m_engine->Shutdown();
+    m_engine.reset();
+  }
+
+  /// feeds a 440 Hz sine of the given length and waits until the sink got all of it
+  SRenderResult RenderPCM(const CAEChannelInfo& layout, double tempo, double seconds)
+  {
+    AEAudioFormat format = MakePCMFormat(layout, 44100);
+    IAEStream* stream = m_engine->MakeStream(format);
+    if (!stream)
+    {
+      ADD_FAILURE() << "engine refused the stream";
+      return SRenderResult();
+    }
+
+    const unsigned int channels = layout.Count();
+    const uint64_t total = static_cast<uint64_t>(seconds * format.m_sampleRate);
+    std::vector<int16_t> samples(format.m_frames * channels);
+    uint8_t* data = reinterpret_cast<uint8_t*>(samples.data());
+
+    std::clock_t start = std::clock();
+    for (uint64_t generated = 0; generated < total;)
+    {
+      unsigned int frames = static_cast<unsigned int>(std::min<uint64_t>(format.m_frames, total - generated));
+      for (unsigned int i = 0; i < frames; i++)
+      {
+        int16_t value = static_cast<int16_t>(16000 * std::sin((generated + i) * 2 * M_PI * 440 / format.m_sampleRate));
+        for (unsigned int c = 0; c < channels; c++)
+          samples[i * channels + c] = value;
+      }
+      if (!AddData(stream, data, frames))
+        break;
+
+      // the stream stages exist once the first buffer went in
+      if (generated == 0 && tempo != 1.0)
+        stream->SetResampleRatio(1.0 / tempo);
+      generated += frames;
+    }
+
+    Finish(stream);
+
+    SRenderResult result;
+    result.cpuSeconds = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+    result.audioSeconds = seconds / tempo;
+    return result;
+  }
+
+  /// feeds AC3 frames, the sink thread packs them into IEC 61937 bursts
+  SRenderResult RenderPassthrough(double seconds)
+  {
+    AEAudioFormat format = MakeAC3Format();
+    IAEStream* stream = m_engine->MakeStream(format);
+    if (!stream)
+    {
+      ADD_FAILURE() << "engine refused the stream";
+      return SRenderResult();
+    }
+
+    std::vector<uint8_t> frame(AC3_FRAME_BYTES, 0);
+    frame[0] = 0x0B;
+    frame[1] = 0x77;
+    uint8_t* data = frame.data();
+
+    const int frames = static_cast<int>(seconds * format.m_sampleRate / AC3_FRAME_SIZE);
+    std::clock_t start = std::clock();
+    for (int i = 0; i < frames; i++)
+    {
+      if (!AddData(stream, data, AC3_FRAME_BYTES))
+        break;
+    }
+
+    Finish(stream);
+
+    SRenderResult result;
+    result.cpuSeconds = static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+    result.audioSeconds = static_cast<double>(frames) * AC3_FRAME_SIZE / format.m_sampleRate;
+    return result;
+  }
+
+  /// waits until the sink stopped receiving output, the engine writes nothing once it is idle
+  CAESinkOffline::Output WaitForOutput()
+  {
+    XbmcThreads::EndTime timeout(5000);
+    CAESinkOffline::Output output = CAESinkOffline::GetOutput();
+    while (!timeout.IsTimePast())
+    {
+      std::this_thread::sleep_for(std::chrono::milliseconds(100));
+      CAESinkOffline::Output next = CAESinkOffline::GetOutput();
+      if (next.frames > 0 && next.frames == output.frames)
+        break;
+      output = std::move(next);
+    }
+    return output;
+  }
+
+  std::unique_ptr<CActiveAE> m_engine;
+
+private:
+  bool AddData(IAEStream* stream, uint8_t* data, unsigned int frames)
+  {
+    for (unsigned int added = 0; added < frames;)
+    {
+      unsigned int copied = stream->AddData(&data, added, frames - added, nullptr);
+      if (copied == 0)
+      {
+        ADD_FAILURE() << "engine did not take data within its timeout";
+        return false;
+      }
+      added += copied;
+    }
+    return true;
+  }
+
+  void Finish(IAEStream* stream)
+  {
+    stream->Drain(true);
+
+    XbmcThreads::EndTime timeout(10000);
+    while (!stream->IsDrained() && !timeout.IsTimePast())
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    EXPECT_TRUE(stream->IsDrained());
+
+    // drained stream stages, wait for the buffers on their way to the sink
+    while (stream->GetDelay() > 0.005 && !timeout.IsTimePast())
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    m_engine->FreeStream(stream, false);
+  }
+};
+
+TEST(TestAESinkOffline, ConsumesFasterThanRealTime)
+{
+  CAESinkOffline sink;
+  AEAudioFormat format = MakePCMFormat(AE_CH_LAYOUT_2_0, 48000);
+  std::string device = "memory";
+  ASSERT_TRUE(sink.Initialize(format, device));
+  EXPECT_EQ(AE_FMT_S32NE, format.m_dataFormat);
+  EXPECT_EQ(480u, format.m_frames);
+  EXPECT_EQ(8u, format.m_frameSize);
+
+  // one second of audio
+  std::vector<int32_t> samples(2 * format.m_frames, 1 << 24);
+  uint8_t* data = reinterpret_cast<uint8_t*>(samples.data());
+  auto start = std::chrono::steady_clock::now();
+  for (int i = 0; i < 100; i++)
+    EXPECT_EQ(format.m_frames, sink.AddPackets(&data, format.m_frames, 0));
+  sink.AddPause(10);
+  // nominally 10 ms, a loaded machine only has to beat real time
+  EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+
+  AEDelayStatus status;
+  sink.GetDelay(status);
+  EXPECT_LT(status.GetDelay(), 0.5);
+
+  CAESinkOffline::Output output = CAESinkOffline::GetOutput();
+  EXPECT_EQ(101u * format.m_frames, output.frames);
+  EXPECT_EQ(101u * format.m_frames * format.m_frameSize, output.capture.size());
+}
+
+TEST_F(TestActiveAEOffline, RenderStereo)
+{
+  Start("memory");
+  RenderPCM(AE_CH_LAYOUT_2_0, 1.0, 2.0);
+  Stop();
+
+  // converted to float, mixed, limited and converted to 32 bit for the sink
+  CAESinkOffline::Output output = CAESinkOffline::GetOutput();
+  EXPECT_EQ(AE_FMT_S32NE, output.format.m_dataFormat);
+  EXPECT_EQ(2u, output.format.m_channelLayout.Count());
+  EXPECT_NEAR(2.0, SignalSeconds(output), 0.1);
+}
+
+TEST_F(TestActiveAEOffline, RenderSurround)
+{
+  Start("memory");
+  RenderPCM(AE_CH_LAYOUT_5_1, 1.0, 1.0);
+  Stop();
+
+  CAESinkOffline::Output output = CAESinkOffline::GetOutput();
+  EXPECT_EQ(6u, output.format.m_channelLayout.Count());
+  EXPECT_NEAR(1.0, SignalSeconds(output), 0.1);
+}
+
+TEST_F(TestActiveAEOffline, RenderAtempo)
+{
+  Start("memory");
+  RenderPCM(AE_CH_LAYOUT_2_0, 1.25, 2.0);
+  Stop();
+
+  // atempo compresses the output by the tempo factor
+  EXPECT_NEAR(2.0 / 1.25, SignalSeconds(CAESinkOffline::GetOutput()), 0.15);
+}
+
+TEST_F(TestActiveAEOffline, MixSounds)
+{
+  Start("memory");
+  IAESound* sound = m_engine->MakeSound(XBMC_REF_FILE_PATH("addons/resource.uisounds.kodi/resources/click.wav"));
+  ASSERT_NE(nullptr, sound);
+  sound->Play();
+
+  // no stream, the engine mixes the sound into silence
+  CAESinkOffline::Output output = WaitForOutput();
+  m_engine->FreeSound(sound);
+  Stop();
+
+  EXPECT_GT(SignalSeconds(output), 0.0);
+}
+
+TEST_F(TestActiveAEOffline, RenderPassthrough)
+{
+  Start("memory", true);
+  SRenderResult result = RenderPassthrough(1.0);
+  Stop();
+
+  CAESinkOffline::Output output = CAESinkOffline::GetOutput();
+  EXPECT_EQ(AE_FMT_RAW, output.format.m_dataFormat);
+  EXPECT_NEAR(result.audioSeconds * 48000 / AC3_FRAME_SIZE, CountBursts(output, IEC61937_AC3), 2);
+}
+
+TEST_F(TestActiveAEOffline, RenderTranscode)
+{
+  // multichannel PCM on a stereo setup goes out as AC3 from the encoder
+  Start("memory", true, AE_CH_LAYOUT_2_0);
+  RenderPCM(AE_CH_LAYOUT_5_1, 1.0, 1.0);
+  Stop();
+
+  CAESinkOffline::Output output = CAESinkOffline::GetOutput();
+  EXPECT_EQ(AE_FMT_RAW, output.format.m_dataFormat);
+  EXPECT_NEAR(48000.0 / AC3_FRAME_SIZE, CountBursts(output, IEC61937_AC3), 3);
+}
+
+// takes minutes, run with --gtest_also_run_disabled_tests --gtest_filter=*Benchmark*
+TEST_F(TestActiveAEOffline, DISABLED_Benchmark)
+{
+  const double seconds = 30.0;
+
+  Start("null");
+  Report("stereo", RenderPCM(AE_CH_LAYOUT_2_0, 1.0, seconds));
+  Report("5.1", RenderPCM(AE_CH_LAYOUT_5_1, 1.0, seconds));
+  Report("7.1", RenderPCM(AE_CH_LAYOUT_7_1, 1.0, seconds));
+  Report("stereo atempo 1.1", RenderPCM(AE_CH_LAYOUT_2_0, 1.1, seconds));
+  Stop();
+
+  Start("null", true);
+  Report("ac3 passthrough", RenderPassthrough(seconds));
+  Stop();
+
+  Start("null", true, AE_CH_LAYOUT_2_0);
+  Report("5.1 ac3 transcode", RenderPCM(AE_CH_LAYOUT_5_1, 1.0, seconds));
+}
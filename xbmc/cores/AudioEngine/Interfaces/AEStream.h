@@ -46,6 +46,23 @@ public:
   AESyncState state;
 };
 
+/**
+ * Breakdown of the output delay of a stream into the stages a sample passes
+ * on its way to the speakers. All values are in seconds.
+ */
+class CAELatencyInfo
+{
+public:
+  double stream = 0.0; ///< samples added to the stream but not yet picked up by the engine
+  double processing = 0.0; ///< resample, atempo and mix stages of the stream
+  double engine = 0.0; ///< water level between the engine and the sink
+  double sink = 0.0; ///< buffered in the sink / audio driver
+  double hardware = 0.0; ///< latency reported by the device
+  bool lowLatency = false; ///< engine runs with the low latency buffer profile
+
+  double Total() const { return stream + processing + engine + sink + hardware; }
+};
+
 /**
  * IAEStream Stream Interface for streaming audio
  */
@@ -81,6 +98,21 @@ public:
    */
   virtual unsigned int AddData(const uint8_t* const *data, unsigned int offset, unsigned int frames, ExtData *extData) = 0;
 
+  /**
+   * Returns true if the stream can take a reference to a decoded frame
+   * instead of copying its samples
+   * @param frame ref counted frame in the format of the stream
+   */
+  virtual bool CanAddFrame(const AVFrame *frame) { return false; }
+
+  /**
+   * Add a decoded frame to the stream without copying, the stream holds
+   * its own reference until the samples are consumed
+   * @param frame ref counted frame, the caller keeps its reference
+   * @return The number of frames consumed, either all or none
+   */
+  virtual unsigned int AddFrame(const AVFrame *frame, ExtData *extData) { return 0; }
+
   /**
    * Returns the time in seconds that it will take
    * for the next added packet to be heard from the speakers.
@@ -94,6 +126,12 @@ public:
    */
   virtual CAESyncInfo GetSyncInfo() = 0;
 
+  /**
+   * Returns the current output delay split up by stages
+   * @return CAELatencyInfo
+   */
+  virtual CAELatencyInfo GetLatencyInfo() = 0;
+
   /**
    * Returns if the stream is buffering
    * @return True if the stream is buffering
@@ -0,0 +1,171 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "AESinkOffline.h"
+#include "cores/AudioEngine/AESinkFactory.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <thread>
+
+namespace
+{
+// period handed to the engine, sets the size of the chunks the engine produces
+constexpr unsigned int OFFLINE_PERIOD_MS = 10;
+
+// the device plays this many times faster than real time. The sink thread of
+// the engine writes silence while it waits for data, without a limit this
+// would spin a core and fill the capture.
+constexpr double OFFLINE_SPEED = 100.0;
+
+const unsigned int OfflineSampleRates[] = {32000, 44100, 48000, 88200, 96000, 176400, 192000};
+
+CCriticalSection outputSection;
+CAESinkOffline::Output output;
+}
+
+void CAESinkOffline::Register()
+{
+  AE::AESinkRegEntry entry;
+  entry.sinkName = "OFFLINE";
+  entry.createFunc = CAESinkOffline::Create;
+  entry.enumerateFunc = CAESinkOffline::EnumerateDevicesEx;
+  AE::CAESinkFactory::RegisterSink(entry);
+}
+
+IAESink* CAESinkOffline::Create(std::string &device, AEAudioFormat& desiredFormat)
+{
+  IAESink* sink = new CAESinkOffline();
+  if (sink->Initialize(desiredFormat, device))
+    return sink;
+
+  delete sink;
+  return nullptr;
+}
+
+void CAESinkOffline::EnumerateDevicesEx(AEDeviceInfoList &list, bool force)
+{
+  for (const char* device : {"null", "memory"})
+  {
+    CAEDeviceInfo info;
+    info.m_deviceName = device;
+    info.m_displayName = "Offline";
+    info.m_displayNameExtra = device;
+    info.m_deviceType = AE_DEVTYPE_HDMI;
+    info.m_wantsIECPassthrough = true;
+    info.m_channels = AE_CH_LAYOUT_7_1;
+
+    for (unsigned int rate : OfflineSampleRates)
+      info.m_sampleRates.push_back(rate);
+    info.m_dataFormats.push_back(AE_FMT_S32NE);
+    info.m_dataFormats.push_back(AE_FMT_RAW);
+
+    info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_AC3);
+    info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_EAC3);
+    info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_DTS_512);
+    info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_DTS_1024);
+    info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_DTS_2048);
+    info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_DTSHD_CORE);
+    info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_DTSHD);
+    info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_DTSHD_MA);
+    info.m_streamTypes.push_back(CAEStreamInfo::STREAM_TYPE_TRUEHD);
+
+    list.push_back(info);
+  }
+}
+
+bool CAESinkOffline::Initialize(AEAudioFormat &format, std::string &device)
+{
+  // PCM is written as 32 bit integers like most hardware takes it, this keeps
+  // the conversion stage of the engine in the path
+  if (format.m_dataFormat != AE_FMT_RAW)
+    format.m_dataFormat = AE_FMT_S32NE;
+
+  // IEC bursts are sent as 2 channel 16 bit frames
+  unsigned int channels = format.m_dataFormat == AE_FMT_RAW ? 2 : format.m_channelLayout.Count();
+  unsigned int bytes = format.m_dataFormat == AE_FMT_RAW ? 2 : CAEUtil::DataFormatToBits(format.m_dataFormat) / 8;
+
+  if (channels == 0 || format.m_sampleRate == 0)
+  {
+    CLog::Log(LOGERROR, "CAESinkOffline::Initialize - invalid format");
+    return false;
+  }
+
+  format.m_frameSize = channels * bytes;
+  format.m_frames = format.m_sampleRate * OFFLINE_PERIOD_MS / 1000;
+
+  m_format = format;
+  m_capturing = device == "memory";
+  m_framesWritten = 0;
+  m_start = std::chrono::steady_clock::now();
+
+  {
+    CSingleLock lock(outputSection);
+    output.format = format;
+    output.frames = 0;
+    output.capture.clear();
+  }
+
+  CLog::Log(LOGDEBUG, "CAESinkOffline::Initialize - device: %s, rate: %u, frame size: %u",
+            device.c_str(), format.m_sampleRate, format.m_frameSize);
+  return true;
+}
+
+double CAESinkOffline::GetCacheTotal()
+{
+  return static_cast<double>(OFFLINE_PERIOD_MS) / 1000;
+}
+
+unsigned int CAESinkOffline::AddPackets(uint8_t **data, unsigned int frames, unsigned int offset)
+{
+  Consume(data[0] + offset * m_format.m_frameSize, frames);
+  return frames;
+}
+
+void CAESinkOffline::AddPause(unsigned int millis)
+{
+  Consume(nullptr, static_cast<uint64_t>(m_format.m_sampleRate) * millis / 1000);
+}
+
+void CAESinkOffline::GetDelay(AEDelayStatus& status)
+{
+  double played = std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+  double written = static_cast<double>(m_framesWritten) / m_format.m_sampleRate / OFFLINE_SPEED;
+  status.SetDelay(std::max(0.0, written - played));
+}
+
+CAESinkOffline::Output CAESinkOffline::GetOutput()
+{
+  CSingleLock lock(outputSection);
+  return output;
+}
+
+void CAESinkOffline::Consume(const uint8_t* buffer, uint64_t frames)
+{
+  {
+    CSingleLock lock(outputSection);
+    if (m_capturing)
+    {
+      if (buffer)
+        output.capture.insert(output.capture.end(), buffer, buffer + frames * m_format.m_frameSize);
+      else
+        output.capture.insert(output.capture.end(), frames * m_format.m_frameSize, 0);
+    }
+    output.frames += frames;
+  }
+  m_framesWritten += frames;
+
+  // block like a device would once the buffer is full
+  AEDelayStatus status;
+  GetDelay(status);
+  if (status.delay > static_cast<double>(OFFLINE_PERIOD_MS) / 1000 / OFFLINE_SPEED)
+    std::this_thread::sleep_for(std::chrono::duration<double>(status.delay));
+}
@@ -0,0 +1,67 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "cores/AudioEngine/Interfaces/AESink.h"
+#include "cores/AudioEngine/Utils/AEDeviceInfo.h"
+
+#include <chrono>
+#include <stdint.h>
+#include <vector>
+
+/**
+ * Sink without hardware behind it. The device plays many times faster than
+ * real time, so the engine renders as fast as it can produce output. Used for
+ * regression tests and benchmarks of the audio path. Register with
+ * KODI_AE_SINK=OFFLINE.
+ *
+ * Devices: "null" discards the output, "memory" keeps it for inspection.
+ * PCM is always written as 32 bit integers.
+ */
+class CAESinkOffline : public IAESink
+{
+public:
+  const char *GetName() override { return "offline"; }
+
+  CAESinkOffline() = default;
+  ~CAESinkOffline() override = default;
+
+  static void Register();
+  static IAESink* Create(std::string &device, AEAudioFormat &desiredFormat);
+  static void EnumerateDevicesEx(AEDeviceInfoList &list, bool force = false);
+
+  bool Initialize(AEAudioFormat &format, std::string &device) override;
+  void Deinitialize() override {}
+
+  double GetCacheTotal() override;
+  unsigned int AddPackets(uint8_t **data, unsigned int frames, unsigned int offset) override;
+  void AddPause(unsigned int millis) override;
+  void GetDelay(AEDelayStatus& status) override;
+  void Drain() override {}
+
+  /**
+   * Output of the offline sink that was initialized last. The engine owns its
+   * sink, so this is how tests get at what was rendered.
+   */
+  struct Output
+  {
+    AEAudioFormat format;
+    uint64_t frames = 0; ///< frames consumed since Initialize, including pauses
+    std::vector<uint8_t> capture; ///< interleaved output of the memory device
+  };
+  static Output GetOutput();
+
+private:
+  void Consume(const uint8_t* buffer, uint64_t frames);
+
+  AEAudioFormat m_format;
+  bool m_capturing = false;
+  uint64_t m_framesWritten = 0;
+  std::chrono::steady_clock::time_point m_start;
+};
@@ -135,7 +135,11 @@ unsigned int CAudioSinkAE::AddPackets(const DVDAudioFrame &audioframe)
       ext.hasDownmix = true;
       ext.centerMixLevel = audioframe.centerMixLevel;
     }
-    unsigned int copied = m_pAudioStream->AddData(audioframe.data, offset, frames, &ext);
+    unsigned int copied;
+    if (offset == 0 && audioframe.avframe && m_pAudioStream->CanAddFrame(audioframe.avframe))
+      copied = m_pAudioStream->AddFrame(audioframe.avframe, &ext);
+    else
+      copied = m_pAudioStream->AddData(audioframe.data, offset, frames, &ext);
     offset += copied;
     frames -= copied;
     if (frames <= 0)
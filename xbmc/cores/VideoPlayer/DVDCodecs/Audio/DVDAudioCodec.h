@@ -43,6 +43,7 @@ typedef struct stDVDAudioFrame
   int profile;
   bool hasDownmix;
   double centerMixLevel;
+  AVFrame* avframe; // ref counted decoder frame holding data, valid until the next GetData
 } DVDAudioFrame;
 
 class CDVDAudioCodec
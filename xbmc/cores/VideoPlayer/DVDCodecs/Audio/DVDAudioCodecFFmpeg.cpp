@@ -165,6 +165,7 @@ bool CDVDAudioCodecFFmpeg::AddData(const DemuxPacket &packet)
 void CDVDAudioCodecFFmpeg::GetData(DVDAudioFrame &frame)
 {
   frame.nb_frames = 0;
+  frame.avframe = nullptr;
 
   uint8_t* data[16];
   int bytes = GetData(data);
@@ -187,6 +188,10 @@ void CDVDAudioCodecFFmpeg::GetData(DVDAudioFrame &frame)
   for (unsigned int i=0; i<frame.planes; i++)
     frame.data[i] = data[i];
 
+  // lets the audio stream reference the samples instead of copying them
+  if (m_pFrame->buf[0])
+    frame.avframe = m_pFrame;
+
   frame.bits_per_sample = CAEUtil::DataFormatToBits(frame.format.m_dataFormat);
   frame.format.m_sampleRate = m_format.m_sampleRate;
   frame.matrix_encoding = GetMatrixEncoding();
@@ -1261,7 +1261,13 @@ void CDVDVideoCodecFFmpeg::SetCodecControl(int flags)
     else
       m_requestSkipDeint = false;
 
-    if (bDrop)
+    if (flags & DVD_CODEC_CTRL_KEYFRAMES)
+    {
+      m_pCodecContext->skip_frame = AVDISCARD_NONKEY;
+      m_pCodecContext->skip_idct = AVDISCARD_NONKEY;
+      m_pCodecContext->skip_loop_filter = AVDISCARD_NONKEY;
+    }
+    else if (bDrop)
     {
       m_pCodecContext->skip_frame = AVDISCARD_NONREF;
       m_pCodecContext->skip_idct = AVDISCARD_NONREF;
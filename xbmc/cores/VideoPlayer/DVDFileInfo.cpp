@@ -90,23 +90,55 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
                                 CTextureDetails &details,
                                 CStreamDetails *pStreamDetails,
                                 int64_t pos)
+{
+  std::vector<ThumbRequest> requests(1);
+  requests[0].pos = pos;
+  requests[0].details = &details;
+
+  return ExtractThumbs(fileItem, requests, pStreamDetails) == 1;
+}
+
+int CDVDFileInfo::ExtractThumbs(const CFileItem& fileItem,
+                                std::vector<ThumbRequest>& requests,
+                                CStreamDetails *pStreamDetails,
+                                const std::function<bool(unsigned int)>& progress)
 {
   const std::string redactPath = CURL::GetRedacted(fileItem.GetPath());
   unsigned int nTime = XbmcThreads::SystemClockMillis();
 
+  for (auto& request : requests)
+  {
+    request.attempted = false;
+    request.extracted = false;
+  }
+
+  // create empty cache files for whatever was tried but could not be
+  // extracted so we don't retry, requests left by a cancel are retried
+  auto markFailed = [&requests]()
+  {
+    for (auto& request : requests)
+    {
+      if (!request.attempted || request.extracted)
+        continue;
+      XFILE::CFile file;
+      if(file.OpenForWrite(CTextureCache::GetCachedPath(request.details->file)))
+        file.Close();
+    }
+  };
+
   CFileItem item(fileItem);
   item.SetMimeTypeForInternetFile();
   auto pInputStream = CDVDFactoryInputStream::CreateInputStream(NULL, item);
   if (!pInputStream)
   {
     CLog::Log(LOGERROR, "InputStream: Error creating stream for %s", redactPath.c_str());
-    return false;
+    return 0;
   }
 
   if (!pInputStream->Open())
   {
     CLog::Log(LOGERROR, "InputStream: Error opening, %s", redactPath.c_str());
-    return false;
+    return 0;
   }
 
   CDVDDemux *pDemuxer = NULL;
@@ -117,7 +149,7 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
     if(!pDemuxer)
     {
       CLog::Log(LOGERROR, "%s - Error creating demuxer", __FUNCTION__);
-      return false;
+      return 0;
     }
   }
   catch(...)
@@ -126,7 +158,7 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
     if (pDemuxer)
       delete pDemuxer;
 
-    return false;
+    return 0;
   }
 
   if (pStreamDetails)
@@ -181,8 +213,9 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
     }
   }
 
-  bool bOk = false;
+  int extracted = 0;
   int packetsTried = 0;
+  bool decoding = false;
 
   if (nVideoStream != -1)
   {
@@ -199,50 +232,63 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
 
     if (pVideoCodec)
     {
+      decoding = true;
+
+      // a thumbnail only needs the key frame we seek to, skip everything in between
+      pVideoCodec->SetCodecControl(DVD_CODEC_CTRL_KEYFRAMES);
+
       int nTotalLen = pDemuxer->GetStreamLength();
-      int nSeekTo = (pos == -1) ? nTotalLen / 3 : pos;
+      struct SwsContext *context = nullptr;
 
-      CLog::Log(LOGDEBUG,"%s - seeking to pos %dms (total: %dms) in %s", __FUNCTION__, nSeekTo, nTotalLen, redactPath.c_str());
-      if (pDemuxer->SeekTime(nSeekTo, true))
+      for (unsigned int idx = 0; idx < requests.size(); idx++)
       {
-        CDVDVideoCodec::VCReturn iDecoderState = CDVDVideoCodec::VC_NONE;
-        VideoPicture picture = {};
+        ThumbRequest& request = requests[idx];
+        request.attempted = true;
+        int nSeekTo = (request.pos == -1) ? nTotalLen / 3 : request.pos;
 
-        // num streams * 160 frames, should get a valid frame, if not abort.
-        int abort_index = pDemuxer->GetNrOfStreams() * 160;
-        do
-        {
-          DemuxPacket* pPacket = pDemuxer->Read();
-          packetsTried++;
+        CLog::Log(LOGDEBUG,"%s - seeking to pos %dms (total: %dms) in %s", __FUNCTION__, nSeekTo, nTotalLen, redactPath.c_str());
+        if (idx > 0)
+          pVideoCodec->Reset();
 
-          if (!pPacket)
-            break;
+        if (pDemuxer->SeekTime(nSeekTo, true))
+        {
+          CDVDVideoCodec::VCReturn iDecoderState = CDVDVideoCodec::VC_NONE;
+          VideoPicture picture = {};
 
-          if (pPacket->iStreamId != nVideoStream)
+          // num streams * 160 frames, should get a valid frame, if not abort.
+          int abort_index = pDemuxer->GetNrOfStreams() * 160;
+          do
           {
-            CDVDDemuxUtils::FreeDemuxPacket(pPacket);
-            continue;
-          }
+            DemuxPacket* pPacket = pDemuxer->Read();
+            packetsTried++;
 
-          pVideoCodec->AddData(*pPacket);
-          CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+            if (!pPacket)
+              break;
 
-          iDecoderState = CDVDVideoCodec::VC_NONE;
-          while (iDecoderState == CDVDVideoCodec::VC_NONE)
-          {
-            iDecoderState = pVideoCodec->GetPicture(&picture);
-          }
+            if (pPacket->iStreamId != nVideoStream)
+            {
+              CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+              continue;
+            }
 
-          if (iDecoderState == CDVDVideoCodec::VC_PICTURE)
-          {
-            if(!(picture.iFlags & DVP_FLAG_DROPPED))
-              break;
-          }
+            pVideoCodec->AddData(*pPacket);
+            CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+
+            iDecoderState = CDVDVideoCodec::VC_NONE;
+            while (iDecoderState == CDVDVideoCodec::VC_NONE)
+            {
+              iDecoderState = pVideoCodec->GetPicture(&picture);
+            }
+
+            if (iDecoderState == CDVDVideoCodec::VC_PICTURE)
+            {
+              if(!(picture.iFlags & DVP_FLAG_DROPPED))
+                break;
+            }
 
-        } while (abort_index--);
+          } while (abort_index--);
 
-        if (iDecoderState == CDVDVideoCodec::VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
-        {
+          if (iDecoderState == CDVDVideoCodec::VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
           {
             unsigned int nWidth = std::min(picture.iDisplayWidth, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_imageRes);
             double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
@@ -251,7 +297,9 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
             unsigned int nHeight = (unsigned int)((double)nWidth / aspect);
 
             uint8_t *pOutBuf = (uint8_t*)av_malloc(nWidth * nHeight * 4);
-            struct SwsContext *context = sws_getContext(picture.iWidth, picture.iHeight,
+            // the scaler is kept across positions, swscale uses its SIMD paths
+            // to convert straight into the BGRA layout of the texture cache
+            context = sws_getCachedContext(context, picture.iWidth, picture.iHeight,
                   AV_PIX_FMT_YUV420P, nWidth, nHeight, AV_PIX_FMT_BGRA, SWS_FAST_BILINEAR, NULL, NULL, NULL);
 
             if (context)
@@ -266,21 +314,27 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
               int dstStride[] = { (int)nWidth*4, 0, 0, 0 };
               int orientation = DegreeToOrientation(hint.orientation);
               sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
-              sws_freeContext(context);
 
-              details.width = nWidth;
-              details.height = nHeight;
-              CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
-              bOk = true;
+              request.details->width = nWidth;
+              request.details->height = nHeight;
+              CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(request.details->file));
+              request.extracted = true;
+              extracted++;
             }
             av_free(pOutBuf);
           }
+          else
+          {
+            CLog::Log(LOGDEBUG,"%s - decode failed in %s after %d packets.", __FUNCTION__, redactPath.c_str(), packetsTried);
+          }
         }
-        else
-        {
-          CLog::Log(LOGDEBUG,"%s - decode failed in %s after %d packets.", __FUNCTION__, redactPath.c_str(), packetsTried);
-        }
+
+        if (progress && progress(idx + 1))
+          break;
       }
+
+      if (context)
+        sws_freeContext(context);
       delete pVideoCodec;
     }
   }
@@ -288,16 +342,17 @@ bool CDVDFileInfo::ExtractThumb(const CFileItem& fileItem,
   if (pDemuxer)
     delete pDemuxer;
 
-  if(!bOk)
+  // none of the requests can succeed without a decodable video stream
+  if (!decoding)
   {
-    XFILE::CFile file;
-    if(file.OpenForWrite(CTextureCache::GetCachedPath(details.file)))
-      file.Close();
+    for (auto& request : requests)
+      request.attempted = true;
   }
+  markFailed();
 
   unsigned int nTotalTime = XbmcThreads::SystemClockMillis() - nTime;
-  CLog::Log(LOGDEBUG,"%s - measured %u ms to extract thumb from file <%s> in %d packets. ", __FUNCTION__, nTotalTime, redactPath.c_str(), packetsTried);
-  return bOk;
+  CLog::Log(LOGDEBUG,"%s - measured %u ms to extract %d of %d thumbs from file <%s> in %d packets. ", __FUNCTION__, nTotalTime, extracted, static_cast<int>(requests.size()), redactPath.c_str(), packetsTried);
+  return extracted;
 }
 
 /**
@@ -8,6 +8,7 @@
 
 #pragma once
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
@@ -22,12 +23,33 @@ class CTextureDetails;
 class CDVDFileInfo
 {
 public:
+  /*! \brief A thumbnail to extract with ExtractThumbs() */
+  struct ThumbRequest
+  {
+    int64_t pos = -1; ///< position in ms, -1 for a third into the file
+    CTextureDetails* details = nullptr; ///< details.file is the cache target, size is filled in on success
+    bool attempted = false; ///< false if extraction stopped before this request
+    bool extracted = false;
+  };
+
   // Extract a thumbnail image from the media referenced by fileItem, optionally populating a streamdetails class with the data
   static bool ExtractThumb(const CFileItem& fileItem,
                            CTextureDetails &details,
                            CStreamDetails *pStreamDetails,
                            int64_t pos);
 
+  /*! \brief Extract thumbnails at several positions of the media referenced by fileItem.
+   Input stream, demuxer and decoder are opened once for all requests and only key frames are decoded.
+   \param requests the thumbnails to extract, extracted is set for each successful one.
+   \param pStreamDetails optional streamdetails to populate.
+   \param progress optional callback invoked with the number of requests handled so far, return true to abort.
+   \return the number of extracted thumbnails.
+   */
+  static int ExtractThumbs(const CFileItem& fileItem,
+                           std::vector<ThumbRequest>& requests,
+                           CStreamDetails *pStreamDetails,
+                           const std::function<bool(unsigned int)>& progress = nullptr);
+
   // Probe the files streams and store the info in the VideoInfoTag
   static bool GetFileStreamDetails(CFileItem *pItem);
   static bool DemuxerToStreamDetails(std::shared_ptr<CDVDInputStream> pInputStream, CDVDDemux *pDemux, CStreamDetails &details, const std::string &path = "");
@@ -10,22 +10,23 @@
 
 #include "../DVDCodecs/Overlay/DVDOverlay.h"
 
-typedef struct stListElement
-{
-  CDVDOverlay* pOverlay;
-  struct stListElement* pNext;
-
-} ListElement;
+#include <stddef.h>
+#include <vector>
 
+/*!
+ * \brief Time indexed store for the overlays of a text subtitle file.
+ *
+ * Overlays are kept in a contiguous array sorted by start time. Next to it a
+ * running maximum of the stop times is kept, which is monotonic even when
+ * events overlap, so the first overlay still visible at a given pts can be
+ * located by binary search instead of walking the list.
+ */
 class CDVDSubtitleLineCollection
 {
 public:
   CDVDSubtitleLineCollection();
   virtual ~CDVDSubtitleLineCollection();
 
-  //void Lock()   { EnterCriticalSection(&m_critSection); }
-  //void Unlock() { LeaveCriticalSection(&m_critSection); }
-
   void Add(CDVDOverlay* pSubtitle);
   void Sort();
 
@@ -33,16 +34,14 @@ public:
 
   void Reset();
 
-  void Remove();
   void Clear();
-  int GetSize() { return m_iSize; }
+  int GetSize() { return static_cast<int>(m_overlays.size()); }
 
 private:
-  ListElement* m_pHead;
-  ListElement* m_pCurrent;
-  ListElement* m_pTail;
+  void BuildIndex();
 
-  int m_iSize;
-  //CRITICAL_SECTION m_critSection;
+  std::vector<CDVDOverlay*> m_overlays;
+  std::vector<double> m_maxStopTime;
+  size_t m_current;
+  bool m_indexed;
 };
-
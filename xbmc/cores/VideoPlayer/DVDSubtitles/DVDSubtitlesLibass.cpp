@@ -93,6 +93,7 @@ bool CDVDSubtitlesLibass::DecodeHeader(char* data, int size)
   }
 
   ass_process_codec_private(m_track, data, size);
+  m_lastValid = false;
   return true;
 }
 
@@ -107,6 +108,7 @@ bool CDVDSubtitlesLibass::DecodeDemuxPkt(const char* data, int size, double star
 
   //! @bug libass isn't const correct
   ass_process_chunk(m_track, const_cast<char*>(data), size, DVD_TIME_TO_MSEC(start), DVD_TIME_TO_MSEC(duration));
+  m_lastValid = false;
   return true;
 }
 
@@ -122,6 +124,7 @@ bool CDVDSubtitlesLibass::CreateTrack(char* buf, size_t size)
   CLog::Log(LOGINFO, "SSA Parser: Creating m_track from SSA buffer");
 
   m_track = ass_read_memory(m_library, buf, size, 0);
+  m_lastValid = false;
   if(m_track == NULL)
     return false;
 
@@ -138,6 +141,26 @@ ASS_Image* CDVDSubtitlesLibass::RenderImage(int frameWidth, int frameHeight, int
     return NULL;
   }
 
+  SRenderParams params;
+  params.frameWidth = frameWidth;
+  params.frameHeight = frameHeight;
+  params.videoWidth = videoWidth;
+  params.videoHeight = videoHeight;
+  params.sourceWidth = sourceWidth;
+  params.sourceHeight = sourceHeight;
+  params.time = DVD_TIME_TO_MSEC(pts);
+  params.useMargin = useMargin;
+  params.position = position;
+
+  // the display usually refreshes faster than the video frame rate, avoid
+  // laying out the same frame again for every repeated pts
+  if (m_lastValid && params == m_lastParams)
+  {
+    if (changes)
+      *changes = 0;
+    return m_lastImage;
+  }
+
   double sar = (double)sourceWidth / sourceHeight;
   double dar = (double)videoWidth / videoHeight;
   ass_set_frame_size(m_renderer, frameWidth, frameHeight);
@@ -147,7 +170,19 @@ ASS_Image* CDVDSubtitlesLibass::RenderImage(int frameWidth, int frameHeight, int
   ass_set_use_margins(m_renderer, useMargin);
   ass_set_line_position(m_renderer, position);
   ass_set_aspect_ratio(m_renderer, dar, sar);
-  return ass_render_frame(m_renderer, m_track, DVD_TIME_TO_MSEC(pts), changes);
+
+  m_lastImage = ass_render_frame(m_renderer, m_track, params.time, changes);
+  m_lastParams = params;
+  m_lastValid = true;
+  return m_lastImage;
+}
+
+bool CDVDSubtitlesLibass::SRenderParams::operator==(const SRenderParams& rhs) const
+{
+  return frameWidth == rhs.frameWidth && frameHeight == rhs.frameHeight &&
+         videoWidth == rhs.videoWidth && videoHeight == rhs.videoHeight &&
+         sourceWidth == rhs.sourceWidth && sourceHeight == rhs.sourceHeight &&
+         time == rhs.time && useMargin == rhs.useMargin && position == rhs.position;
 }
 
 ASS_Event* CDVDSubtitlesLibass::GetEvents()
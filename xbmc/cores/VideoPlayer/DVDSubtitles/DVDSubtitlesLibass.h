@@ -32,9 +32,33 @@ public:
   bool CreateTrack(char* buf, size_t size);
 
 private:
+  /*!
+   * Parameters of the last ass_render_frame call. Rendering again with the
+   * same parameters and an unmodified track yields the same images, so the
+   * previous result is handed out with changes = 0 instead.
+   */
+  struct SRenderParams
+  {
+    int frameWidth = 0;
+    int frameHeight = 0;
+    int videoWidth = 0;
+    int videoHeight = 0;
+    int sourceWidth = 0;
+    int sourceHeight = 0;
+    long long time = -1;
+    int useMargin = 0;
+    double position = 0.0;
+
+    bool operator==(const SRenderParams& rhs) const;
+  };
+
   ASS_Library* m_library = nullptr;
   ASS_Track* m_track = nullptr;
   ASS_Renderer* m_renderer = nullptr;
   CCriticalSection m_section;
+
+  SRenderParams m_lastParams;
+  ASS_Image* m_lastImage = nullptr;
+  bool m_lastValid = false;
 };
 
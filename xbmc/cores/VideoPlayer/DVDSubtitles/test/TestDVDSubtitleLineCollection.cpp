@@ -0,0 +1,181 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "cores/VideoPlayer/DVDStreamInfo.h"
+#include "cores/VideoPlayer/DVDSubtitles/DVDSubtitleLineCollection.h"
+#include "cores/VideoPlayer/DVDSubtitles/DVDSubtitleParserMPL2.h"
+#include "cores/VideoPlayer/DVDSubtitles/DVDSubtitleParserSubrip.h"
+#include "cores/VideoPlayer/DVDSubtitles/DVDSubtitleParserVplayer.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+#include "utils/StringUtils.h"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+
+CDVDOverlay* CreateOverlay(double start, double stop)
+{
+  CDVDOverlay* overlay = new CDVDOverlay(DVDOVERLAY_TYPE_TEXT);
+  overlay->iPTSStartTime = start;
+  overlay->iPTSStopTime = stop;
+  return overlay;
+}
+
+const int BenchmarkEvents = 20000;
+
+std::string FormatSubripTime(int ms)
+{
+  return StringUtils::Format("%02d:%02d:%02d,%03d", ms / 3600000, (ms / 60000) % 60,
+                             (ms / 1000) % 60, ms % 1000);
+}
+
+template<class TParser>
+void BenchmarkParser(const std::string& name, const std::string& content)
+{
+  std::unique_ptr<CDVDSubtitleStream> stream(new CDVDSubtitleStream());
+  stream->m_stringstream << content;
+
+  TParser parser(std::move(stream), name);
+  CDVDStreamInfo hints;
+
+  auto start = std::chrono::steady_clock::now();
+  ASSERT_TRUE(parser.Open(hints));
+  auto opened = std::chrono::steady_clock::now();
+
+  // one lookup per 100ms of media, followed by a backwards seek
+  int lookups = 0;
+  for (int pass = 0; pass < 2; pass++)
+  {
+    parser.Reset();
+    for (double pts = pass * DVD_MSEC_TO_TIME(500); pts < DVD_MSEC_TO_TIME(BenchmarkEvents * 1000);
+         pts += DVD_MSEC_TO_TIME(100))
+    {
+      CDVDOverlay* overlay = parser.Parse(pts);
+      if (overlay)
+        overlay->Release();
+      lookups++;
+    }
+  }
+  auto done = std::chrono::steady_clock::now();
+
+  auto openUs = std::chrono::duration_cast<std::chrono::microseconds>(opened - start).count();
+  auto lookupUs = std::chrono::duration_cast<std::chrono::microseconds>(done - opened).count();
+  std::cout << name << ": " << BenchmarkEvents << " events parsed in " << openUs << "us, "
+            << lookups << " lookups in " << lookupUs << "us" << std::endl;
+}
+
+} // namespace
+
+TEST(TestDVDSubtitleLineCollection, SortAndSequentialGet)
+{
+  CDVDSubtitleLineCollection collection;
+  collection.Add(CreateOverlay(300, 400));
+  collection.Add(CreateOverlay(100, 200));
+  collection.Add(CreateOverlay(200, 300));
+  collection.Sort();
+
+  EXPECT_EQ(3, collection.GetSize());
+
+  CDVDOverlay* overlay = collection.Get(0);
+  ASSERT_NE(nullptr, overlay);
+  EXPECT_EQ(100, overlay->iPTSStartTime);
+  overlay = collection.Get(0);
+  ASSERT_NE(nullptr, overlay);
+  EXPECT_EQ(200, overlay->iPTSStartTime);
+  overlay = collection.Get(0);
+  ASSERT_NE(nullptr, overlay);
+  EXPECT_EQ(300, overlay->iPTSStartTime);
+  EXPECT_EQ(nullptr, collection.Get(0));
+}
+
+TEST(TestDVDSubtitleLineCollection, SkipsExpiredOverlays)
+{
+  CDVDSubtitleLineCollection collection;
+  for (int i = 0; i < 1000; i++)
+    collection.Add(CreateOverlay(i * 10, i * 10 + 5));
+  collection.Sort();
+
+  CDVDOverlay* overlay = collection.Get(5003);
+  ASSERT_NE(nullptr, overlay);
+  EXPECT_EQ(5000, overlay->iPTSStartTime);
+
+  // backwards seek
+  collection.Reset();
+  overlay = collection.Get(1234);
+  ASSERT_NE(nullptr, overlay);
+  EXPECT_EQ(1230, overlay->iPTSStartTime);
+
+  EXPECT_EQ(nullptr, collection.Get(100000));
+}
+
+TEST(TestDVDSubtitleLineCollection, OverlappingEvents)
+{
+  CDVDSubtitleLineCollection collection;
+  collection.Add(CreateOverlay(0, 1000)); // long sign spanning everything
+  collection.Add(CreateOverlay(100, 200));
+  collection.Add(CreateOverlay(300, 400));
+  collection.Add(CreateOverlay(500, 600));
+  collection.Sort();
+
+  CDVDOverlay* overlay = collection.Get(550);
+  ASSERT_NE(nullptr, overlay);
+  EXPECT_EQ(0, overlay->iPTSStartTime);
+  overlay = collection.Get(550);
+  ASSERT_NE(nullptr, overlay);
+  EXPECT_EQ(500, overlay->iPTSStartTime);
+  EXPECT_EQ(nullptr, collection.Get(550));
+}
+
+TEST(TestDVDSubtitleLineCollection, UnsortedInput)
+{
+  // parsers for frame based formats add in file order without sorting
+  CDVDSubtitleLineCollection collection;
+  collection.Add(CreateOverlay(500, 600));
+  collection.Add(CreateOverlay(100, 200));
+
+  CDVDOverlay* overlay = collection.Get(150);
+  ASSERT_NE(nullptr, overlay);
+  EXPECT_EQ(500, overlay->iPTSStartTime);
+  overlay = collection.Get(150);
+  ASSERT_NE(nullptr, overlay);
+  EXPECT_EQ(100, overlay->iPTSStartTime);
+  EXPECT_EQ(nullptr, collection.Get(150));
+}
+
+TEST(TestDVDSubtitleParserBenchmark, Subrip)
+{
+  std::string content;
+  for (int i = 0; i < BenchmarkEvents; i++)
+  {
+    content += StringUtils::Format("%d\n%s --> %s\nLine %d\n\n", i + 1,
+                                   FormatSubripTime(i * 1000).c_str(),
+                                   FormatSubripTime(i * 1000 + 800).c_str(), i);
+  }
+  BenchmarkParser<CDVDSubtitleParserSubrip>("subrip", content);
+}
+
+TEST(TestDVDSubtitleParserBenchmark, MPL2)
+{
+  std::string content;
+  for (int i = 0; i < BenchmarkEvents; i++)
+    content += StringUtils::Format("[%d][%d]Line %d\n", i * 10, i * 10 + 8, i);
+  BenchmarkParser<CDVDSubtitleParserMPL2>("mpl2", content);
+}
+
+TEST(TestDVDSubtitleParserBenchmark, Vplayer)
+{
+  std::string content;
+  for (int i = 0; i < BenchmarkEvents; i++)
+    content += StringUtils::Format("%02d:%02d:%02d:Line %d\n", i / 3600, (i / 60) % 60, i % 60, i);
+  BenchmarkParser<CDVDSubtitleParserVplayer>("vplayer", content);
+}
@@ -294,6 +294,11 @@ CVideoBufferManager& CProcessInfo::GetVideoBufferManager()
   return m_videoBufferManager;
 }
 
+VideoBufferPoolStats CProcessInfo::GetVideoBufferPoolStats()
+{
+  return m_videoBufferManager.GetStats();
+}
+
 std::vector<AVPixelFormat> CProcessInfo::GetPixFormats()
 {
   CSingleLock lock(m_videoCodecSection);
@@ -655,6 +660,18 @@ int64_t CProcessInfo::GetMaxTime()
   return m_timeMax;
 }
 
+void CProcessInfo::SetCacheStatus(const XFILE::SCacheStatus &status)
+{
+  CSingleLock lock(m_stateSection);
+  m_cacheStatus = status;
+}
+
+XFILE::SCacheStatus CProcessInfo::GetCacheStatus()
+{
+  CSingleLock lock(m_stateSection);
+  return m_cacheStatus;
+}
+
 //******************************************************************************
 // settings
 //******************************************************************************
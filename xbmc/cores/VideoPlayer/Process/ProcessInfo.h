@@ -11,6 +11,7 @@
 #include "VideoBuffer.h"
 #include "cores/VideoSettings.h"
 #include "cores/VideoPlayer/VideoRenderers/RenderInfo.h"
+#include "filesystem/IFileTypes.h"
 #include "threads/CriticalSection.h"
 #include <atomic>
 #include <list>
@@ -56,6 +57,7 @@ public:
   void SetDeinterlacingMethodDefault(EINTERLACEMETHOD method);
   EINTERLACEMETHOD GetDeinterlacingMethodDefault();
   CVideoBufferManager& GetVideoBufferManager();
+  VideoBufferPoolStats GetVideoBufferPoolStats();
   std::vector<AVPixelFormat> GetPixFormats();
   void SetPixFormats(std::vector<AVPixelFormat> &formats);
 
@@ -104,6 +106,8 @@ public:
 
   void SetPlayTimes(time_t start, int64_t current, int64_t min, int64_t max);
   int64_t GetMaxTime();
+  void SetCacheStatus(const XFILE::SCacheStatus &status);
+  XFILE::SCacheStatus GetCacheStatus();
 
   // settings
   CVideoSettings GetVideoSettings();
@@ -163,6 +167,7 @@ protected:
   int64_t m_timeMax;
   int64_t m_timeMin;
   bool m_realTimeStream;
+  XFILE::SCacheStatus m_cacheStatus = {};
 
   // settings
   CCriticalSection m_settingsSection;
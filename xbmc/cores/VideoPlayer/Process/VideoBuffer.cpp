@@ -8,7 +8,27 @@
 
 #include "VideoBuffer.h"
 #include "threads/SingleLock.h"
+#include "utils/log.h"
+#include <algorithm>
 #include <string.h>
+#ifdef TARGET_POSIX
+#include "platform/linux/XMemUtils.h"
+#endif
+#if defined(TARGET_LINUX)
+#include <sys/mman.h>
+#endif
+
+namespace
+{
+const size_t PAGE_ALIGN = 4096;
+const size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+const uint32_t FREE_LIST_END = 0xFFFFFFFF;
+
+uint64_t MakeHead(uint32_t tag, uint32_t id)
+{
+  return (static_cast<uint64_t>(tag) << 32) | id;
+}
+}
 
 //-----------------------------------------------------------------------------
 // CVideoBuffer
@@ -179,7 +199,7 @@ CVideoBufferSysMem::CVideoBufferSysMem(IVideoBufferPool &pool, int id, AVPixelFo
 
 CVideoBufferSysMem::~CVideoBufferSysMem()
 {
-  delete[] m_data;
+  _aligned_free(m_data);
 }
 
 uint8_t* CVideoBufferSysMem::GetMemPtr()
@@ -265,7 +285,17 @@ void CVideoBufferSysMem::SetDimensions(int width, int height, const int (&stride
 
 bool CVideoBufferSysMem::Alloc()
 {
-  m_data = new uint8_t[m_size];
+  // page aligned so planes start on cache line and page boundaries
+  m_data = static_cast<uint8_t*>(_aligned_malloc(m_size, PAGE_ALIGN));
+  if (!m_data)
+    return false;
+
+#if defined(TARGET_LINUX) && defined(MADV_HUGEPAGE)
+  // UHD frames span several huge pages, let the kernel back them with
+  // transparent huge pages to cut TLB misses when copying planes
+  if (static_cast<size_t>(m_size) >= HUGE_PAGE_SIZE)
+    madvise(m_data, m_size & ~(PAGE_ALIGN - 1), MADV_HUGEPAGE);
+#endif
   return true;
 }
 
@@ -274,61 +304,112 @@ bool CVideoBufferSysMem::Alloc()
 // CVideoBufferPool
 //-----------------------------------------------------------------------------
 
+CVideoBufferPoolSysMem::CVideoBufferPoolSysMem()
+{
+  for (int i = 0; i < MAX_BUFFERS; i++)
+  {
+    m_all[i] = nullptr;
+    m_next[i] = FREE_LIST_END;
+  }
+  m_allocated = 0;
+  m_freeHead = MakeHead(0, FREE_LIST_END);
+  m_used = 0;
+  m_highWatermark = 0;
+  m_gets = 0;
+  m_hits = 0;
+}
+
 CVideoBufferPoolSysMem::~CVideoBufferPoolSysMem()
 {
   CSingleLock lock(m_critSection);
 
-  for (auto buf : m_all)
+  for (int i = 0; i < m_allocated; i++)
   {
-    delete buf;
+    delete m_all[i];
   }
 }
 
-CVideoBuffer* CVideoBufferPoolSysMem::Get()
+int CVideoBufferPoolSysMem::PopFree()
 {
-  CSingleLock lock(m_critSection);
+  uint64_t head = m_freeHead.load(std::memory_order_acquire);
+  while (true)
+  {
+    uint32_t id = static_cast<uint32_t>(head);
+    if (id == FREE_LIST_END)
+      return -1;
+
+    uint32_t tag = static_cast<uint32_t>(head >> 32);
+    uint64_t next = MakeHead(tag + 1, m_next[id].load(std::memory_order_relaxed));
+    if (m_freeHead.compare_exchange_weak(head, next, std::memory_order_acq_rel, std::memory_order_acquire))
+      return id;
+  }
+}
 
+void CVideoBufferPoolSysMem::PushFree(int id)
+{
+  uint64_t head = m_freeHead.load(std::memory_order_relaxed);
+  while (true)
+  {
+    m_next[id].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+    uint32_t tag = static_cast<uint32_t>(head >> 32);
+    if (m_freeHead.compare_exchange_weak(head, MakeHead(tag + 1, id), std::memory_order_release, std::memory_order_relaxed))
+      return;
+  }
+}
+
+CVideoBuffer* CVideoBufferPoolSysMem::Get()
+{
   CVideoBufferSysMem *buf = nullptr;
-  if (!m_free.empty())
+
+  int id = PopFree();
+  if (id >= 0)
   {
-    int idx = m_free.front();
-    m_free.pop_front();
-    m_used.push_back(idx);
-    buf = m_all[idx];
+    buf = m_all[id];
+    m_hits++;
   }
   else
   {
-    int id = m_all.size();
+    CSingleLock lock(m_critSection);
+
+    id = m_allocated;
+    if (id >= MAX_BUFFERS)
+    {
+      CLog::Log(LOGERROR, "CVideoBufferPoolSysMem::Get - pool exhausted, %d buffers in use", id);
+      return nullptr;
+    }
+
     buf = new CVideoBufferSysMem(*this, id, m_pixFormat, m_size);
-    buf->Alloc();
-    m_all.push_back(buf);
-    m_used.push_back(id);
+    if (!buf->Alloc())
+    {
+      delete buf;
+      return nullptr;
+    }
+    m_all[id] = buf;
+    m_allocated++;
   }
 
+  m_gets++;
+  int used = ++m_used;
+  int watermark = m_highWatermark;
+  while (used > watermark && !m_highWatermark.compare_exchange_weak(watermark, used))
+    ;
+
   buf->Acquire(GetPtr());
   return buf;
 }
 
 void CVideoBufferPoolSysMem::Return(int id)
 {
-  CSingleLock lock(m_critSection);
+  PushFree(id);
 
-  auto it = m_used.begin();
-  while (it != m_used.end())
+  if (--m_used == 0)
   {
-    if (*it == id)
+    CSingleLock lock(m_critSection);
+    if (m_bm && !m_disposed && m_used == 0)
     {
-      m_used.erase(it);
-      break;
+      m_disposed = true;
+      (m_bm->*m_cbDispose)(this);
     }
-    else
-      ++it;
-  }
-  m_free.push_back(id);
-
-  if (m_bm && m_used.empty())
-  {
-    (m_bm->*m_cbDispose)(this);
   }
 }
 
@@ -359,8 +440,21 @@ void CVideoBufferPoolSysMem::Discard(CVideoBufferManager *bm, ReadyToDispose cb)
   m_bm = bm;
   m_cbDispose = cb;
 
-  if (m_used.empty())
+  if (m_used == 0 && !m_disposed)
+  {
+    m_disposed = true;
     (m_bm->*m_cbDispose)(this);
+  }
+}
+
+bool CVideoBufferPoolSysMem::GetStats(VideoBufferPoolStats &stats)
+{
+  stats.gets = m_gets;
+  stats.hits = m_hits;
+  stats.allocations = m_allocated;
+  stats.used = m_used;
+  stats.highWatermark = m_highWatermark;
+  return true;
 }
 
 std::shared_ptr<IVideoBufferPool> CVideoBufferPoolSysMem::CreatePool()
@@ -383,6 +477,7 @@ void CVideoBufferManager::RegisterPool(std::shared_ptr<IVideoBufferPool> pool)
   CSingleLock lock(m_critSection);
   // preferred pools are to the front
   m_pools.push_front(pool);
+  PublishPools();
 }
 
 void CVideoBufferManager::RegisterPoolFactory(std::string id, CreatePoolFunc createFunc)
@@ -396,6 +491,7 @@ void CVideoBufferManager::ReleasePools()
   CSingleLock lock(m_critSection);
   std::list<std::shared_ptr<IVideoBufferPool>> pools = m_pools;
   m_pools.clear();
+  PublishPools();
 
   m_discardedPools = pools;
 
@@ -415,6 +511,7 @@ void CVideoBufferManager::ReleasePool(IVideoBufferPool *pool)
     {
       m_discardedPools.push_back(*it);
       m_pools.erase(it);
+      PublishPools();
       pool->Discard(this, &CVideoBufferManager::ReadyForDisposal);
       break;
     }
@@ -436,8 +533,44 @@ void CVideoBufferManager::ReadyForDisposal(IVideoBufferPool *pool)
   }
 }
 
+VideoBufferPoolStats CVideoBufferManager::GetStats()
+{
+  CSingleLock lock(m_critSection);
+
+  VideoBufferPoolStats total;
+  for (auto pool : m_pools)
+  {
+    VideoBufferPoolStats stats;
+    if (pool->GetStats(stats))
+    {
+      total.gets += stats.gets;
+      total.hits += stats.hits;
+      total.allocations += stats.allocations;
+      total.used += stats.used;
+      total.highWatermark = std::max(total.highWatermark, stats.highWatermark);
+    }
+  }
+  return total;
+}
+
+void CVideoBufferManager::PublishPools()
+{
+  std::atomic_store(&m_activePools, std::make_shared<const std::list<std::shared_ptr<IVideoBufferPool>>>(m_pools));
+}
+
 CVideoBuffer* CVideoBufferManager::Get(AVPixelFormat format, int size, IVideoBufferPool **pPool)
 {
+  // a pool set up for this format serves the buffer without the lock
+  std::shared_ptr<const std::list<std::shared_ptr<IVideoBufferPool>>> pools = std::atomic_load(&m_activePools);
+  if (pools)
+  {
+    for (auto pool : *pools)
+    {
+      if (pool->IsConfigured() && pool->IsCompatible(format, size))
+        return pool->Get();
+    }
+  }
+
   CSingleLock lock(m_critSection);
   for (auto pool: m_pools)
   {
@@ -455,6 +588,7 @@ CVideoBuffer* CVideoBufferManager::Get(AVPixelFormat format, int size, IVideoBuf
   {
     std::shared_ptr<IVideoBufferPool> pool = fact.second();
     m_pools.push_front(pool);
+    PublishPools();
     pool->Configure(format, size);
     if (pPool)
       *pPool = pool.get();
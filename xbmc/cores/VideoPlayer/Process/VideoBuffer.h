@@ -48,6 +48,15 @@ class CVideoBufferManager;
 
 typedef void (CVideoBufferManager::*ReadyToDispose)(IVideoBufferPool *pool);
 
+struct VideoBufferPoolStats
+{
+  uint64_t gets = 0; // buffers handed out
+  uint64_t hits = 0; // buffers handed out from the free list
+  int allocations = 0; // buffers allocated
+  int used = 0; // buffers currently handed out
+  int highWatermark = 0; // max buffers handed out at the same time, the largest of all pools
+};
+
 class IVideoBufferPool : public std::enable_shared_from_this<IVideoBufferPool>
 {
 public:
@@ -78,6 +87,9 @@ public:
   // pool calls back when all buffers are back home
   virtual void Discard(CVideoBufferManager *bm, ReadyToDispose cb) { (bm->*cb)(this); };
 
+  // optional usage statistics
+  virtual bool GetStats(VideoBufferPoolStats &stats) { return false; };
+
   // call on Get() before returning buffer to caller
   std::shared_ptr<IVideoBufferPool> GetPtr() { return shared_from_this(); };
 };
@@ -135,9 +147,12 @@ protected:
 //
 //-----------------------------------------------------------------------------
 
+// Get() and Return() recycle buffers through a lock-free free list, the
+// lock is only taken to allocate a new buffer and for disposal.
 class CVideoBufferPoolSysMem : public IVideoBufferPool
 {
 public:
+  CVideoBufferPoolSysMem();
   ~CVideoBufferPoolSysMem() override;
   CVideoBuffer* Get() override;
   void Return(int id) override;
@@ -145,22 +160,39 @@ public:
   bool IsConfigured() override;
   bool IsCompatible(AVPixelFormat format, int size) override;
   void Discard(CVideoBufferManager *bm, ReadyToDispose cb) override;
+  bool GetStats(VideoBufferPoolStats &stats) override;
 
   static std::shared_ptr<IVideoBufferPool> CreatePool();
 
+  static const int MAX_BUFFERS = 256;
+
 protected:
+  int PopFree();
+  void PushFree(int id);
+
   int m_width = 0;
   int m_height = 0;
   int m_size = 0;
   AVPixelFormat m_pixFormat = AV_PIX_FMT_NONE;
-  bool m_configured = false;
+  std::atomic_bool m_configured{false};
   CCriticalSection m_critSection;
   CVideoBufferManager *m_bm = nullptr;
   ReadyToDispose m_cbDispose;
+  bool m_disposed = false;
+
+  // buffers are never removed, so an index stays valid once published
+  CVideoBufferSysMem* m_all[MAX_BUFFERS];
+  std::atomic_int m_allocated;
 
-  std::vector<CVideoBufferSysMem*> m_all;
-  std::deque<int> m_used;
-  std::deque<int> m_free;
+  // free list as a stack of buffer ids linked through m_next, the head
+  // carries a tag in the upper 32 bits against ABA
+  std::atomic<uint64_t> m_freeHead;
+  std::atomic_int m_next[MAX_BUFFERS];
+
+  std::atomic_int m_used;
+  std::atomic_int m_highWatermark;
+  std::atomic<uint64_t> m_gets;
+  std::atomic<uint64_t> m_hits;
 };
 
 //-----------------------------------------------------------------------------
@@ -179,10 +211,15 @@ public:
   void ReleasePool(IVideoBufferPool *pool);
   CVideoBuffer* Get(AVPixelFormat format, int size, IVideoBufferPool **pPool);
   void ReadyForDisposal(IVideoBufferPool *pool);
+  VideoBufferPoolStats GetStats();
 
 protected:
+  void PublishPools();
+
   CCriticalSection m_critSection;
   std::list<std::shared_ptr<IVideoBufferPool>> m_pools;
+  // copy of m_pools, replaced on each change, Get() reads it without the lock
+  std::shared_ptr<const std::list<std::shared_ptr<IVideoBufferPool>>> m_activePools;
   std::list<std::shared_ptr<IVideoBufferPool>> m_discardedPools;
   std::map<std::string, CreatePoolFunc> m_poolFactories;
 
@@ -37,6 +37,7 @@
 #include "guilib/GUIWindowManager.h"
 #include "guilib/StereoscopicsManager.h"
 #include "Application.h"
+#include "XBDateTime.h"
 #include "ServiceBroker.h"
 #include "messaging/ApplicationMessenger.h"
 
@@ -3303,6 +3304,8 @@ void CVideoPlayer::GetGeneralInfo(std::string& strGeneralInfo)
       if (apts != DVD_NOPTS_VALUE && vpts != DVD_NOPTS_VALUE)
         dDiff = (apts - vpts) / DVD_TIME_BASE;
 
+      XFILE::SCacheStatus status = m_processInfo->GetCacheStatus();
+
       std::string strBuf;
       CSingleLock lock(m_StateSection);
       if(m_State.cache_bytes >= 0)
@@ -3313,6 +3316,13 @@ void CVideoPlayer::GetGeneralInfo(std::string& strGeneralInfo)
         if(m_playSpeed == 0 || m_caching == CACHESTATE_FULL)
           strBuf += StringUtils::Format(" %d msec", DVD_TIME_TO_MSEC(m_State.cache_delay));
       }
+      if (status.readahead > 0)
+      {
+        strBuf += StringUtils::Format(", cache readahead:%s source:%s/s stalls:%u"
+                                      , StringUtils::SizeToString(status.readahead).c_str()
+                                      , StringUtils::SizeToString(status.sourcerate).c_str()
+                                      , status.stalls);
+      }
 
       strGeneralInfo = StringUtils::Format("Player: a/v:% 6.3f, %s"
                                            , dDiff
@@ -4483,6 +4493,13 @@ bool CVideoPlayer::OnAction(const CAction &action)
       m_renderManager.ToggleDebug();
       break;
 
+    case ACTION_PLAYER_FRAMEPACING_DUMP:
+    {
+      std::string path = StringUtils::Format("special://temp/framepacing-%s", CDateTime::GetCurrentDateTime().GetAsSaveString().c_str());
+      m_renderManager.DumpFramePacing(path);
+      return true;
+    }
+
     case ACTION_PLAYER_PROCESS_INFO:
       if (CServiceBroker::GetGUI()->GetWindowManager().GetActiveWindow() != WINDOW_DIALOG_PLAYER_PROCESS_INFO)
       {
@@ -4818,7 +4835,7 @@ void CVideoPlayer::UpdatePlayState(double timeout)
     state.cache_offset = GetQueueTime() / state.timeMax;
   }
 
-  XFILE::SCacheStatus status;
+  XFILE::SCacheStatus status = {};
   if (m_pInputStream && m_pInputStream->GetCacheStatus(&status))
   {
     state.cache_bytes = status.forward;
@@ -4828,6 +4845,8 @@ void CVideoPlayer::UpdatePlayState(double timeout)
   else
     state.cache_bytes = 0;
 
+  m_processInfo->SetCacheStatus(status);
+
   state.timestamp = m_clock.GetAbsoluteClock();
 
   if (state.timeMax <= 0)
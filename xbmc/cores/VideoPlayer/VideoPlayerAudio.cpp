@@ -220,6 +220,7 @@ void CVideoPlayerAudio::Process()
   DVDAudioFrame audioframe;
   audioframe.nb_frames = 0;
   audioframe.framesOut = 0;
+  audioframe.avframe = nullptr;
   m_audioStats.Start();
 
   bool onlyPrioMsgs = false;
@@ -422,6 +423,7 @@ bool CVideoPlayerAudio::ProcessDecoderOutput(DVDAudioFrame &audioframe)
   if (audioframe.nb_frames <= audioframe.framesOut)
   {
     audioframe.hasDownmix = false;
+    audioframe.avframe = nullptr;
 
     m_pAudioCodec->GetData(audioframe);
 
@@ -0,0 +1,174 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FramePacingRecorder.h"
+#include "cores/VideoPlayer/Interface/Addon/TimingConstants.h"
+#include "filesystem/File.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+
+#include <algorithm>
+#include <cmath>
+
+CFramePacingRecorder::CFramePacingRecorder(size_t capacity)
+  : m_records(capacity)
+{
+}
+
+void CFramePacingRecorder::Reset()
+{
+  CSingleLock lock(m_section);
+  m_next = 0;
+  m_count = 0;
+}
+
+void CFramePacingRecorder::Record(const SRecord& record)
+{
+  CSingleLock lock(m_section);
+  m_records[m_next] = record;
+  m_next = (m_next + 1) % m_records.size();
+  if (m_count < m_records.size())
+    m_count++;
+}
+
+std::vector<CFramePacingRecorder::SRecord> CFramePacingRecorder::GetRecords(size_t frames) const
+{
+  CSingleLock lock(m_section);
+
+  size_t count = m_count;
+  if (frames > 0 && frames < count)
+    count = frames;
+
+  std::vector<SRecord> records;
+  records.reserve(count);
+  size_t start = (m_next + m_records.size() - count) % m_records.size();
+  for (size_t i = 0; i < count; i++)
+    records.push_back(m_records[(start + i) % m_records.size()]);
+
+  return records;
+}
+
+CFramePacingRecorder::SSummary CFramePacingRecorder::GetSummary(size_t frames) const
+{
+  SSummary summary;
+  std::vector<SRecord> records = GetRecords(frames);
+
+  std::vector<double> lateness;
+  lateness.reserve(records.size());
+  double lastLate = 0.0;
+  double sumDiff = 0.0;
+  double sumDiffSq = 0.0;
+  int diffs = 0;
+  int queued = 0;
+
+  for (const auto& record : records)
+  {
+    if (record.decision == DECISION_SKIP)
+    {
+      summary.skipped++;
+      continue;
+    }
+
+    double late = DVD_TIME_TO_MSEC(record.renderPts - record.targetPts);
+    if (!lateness.empty())
+    {
+      double diff = late - lastLate;
+      sumDiff += diff;
+      sumDiffSq += diff * diff;
+      diffs++;
+    }
+    lastLate = late;
+    lateness.push_back(late);
+    queued += record.queued;
+  }
+
+  summary.frames = static_cast<int>(lateness.size());
+  if (lateness.empty())
+    return summary;
+
+  std::sort(lateness.begin(), lateness.end());
+  summary.lateP50 = lateness[lateness.size() / 2];
+  summary.lateP99 = lateness[std::min(lateness.size() - 1, lateness.size() * 99 / 100)];
+  summary.avgQueued = static_cast<double>(queued) / lateness.size();
+
+  if (diffs > 0)
+  {
+    double mean = sumDiff / diffs;
+    summary.judder = std::sqrt(std::max(0.0, sumDiffSq / diffs - mean * mean));
+  }
+
+  return summary;
+}
+
+const char* CFramePacingRecorder::DecisionToString(EDecision decision)
+{
+  switch (decision)
+  {
+    case DECISION_PRESENT:
+      return "present";
+    case DECISION_PRESENT_EARLY:
+      return "early";
+    case DECISION_SKIP:
+      return "skip";
+  }
+  return "unknown";
+}
+
+bool CFramePacingRecorder::Dump(const std::string& basePath) const
+{
+  std::vector<SRecord> records = GetRecords(0);
+  double freq = static_cast<double>(CurrentHostFrequency());
+  int64_t base = records.empty() ? 0 : records.front().hostTime;
+
+  std::string csv = "time_ms,target_pts,render_pts,late_ms,frametime_ms,queued,lateframes,decision\n";
+  std::string json = "{\"frames\":[";
+  for (size_t i = 0; i < records.size(); i++)
+  {
+    const SRecord& r = records[i];
+    double time = (r.hostTime - base) * 1000.0 / freq;
+    double late = (r.renderPts - r.targetPts) * 1000.0 / DVD_TIME_BASE;
+    double frameTime = r.frameTime * 1000.0 / DVD_TIME_BASE;
+    const char* decision = DecisionToString(r.decision);
+
+    csv += StringUtils::Format("%.3f,%.0f,%.0f,%.3f,%.3f,%d,%d,%s\n",
+                               time, r.targetPts, r.renderPts, late, frameTime,
+                               r.queued, r.lateFrames, decision);
+    json += StringUtils::Format("%s{\"time\":%.3f,\"targetpts\":%.0f,\"renderpts\":%.0f,\"late\":%.3f,"
+                                "\"frametime\":%.3f,\"queued\":%d,\"lateframes\":%d,\"decision\":\"%s\"}",
+                                i ? "," : "", time, r.targetPts, r.renderPts, late, frameTime,
+                                r.queued, r.lateFrames, decision);
+  }
+
+  SSummary summary = GetSummary();
+  json += StringUtils::Format("],\"summary\":{\"frames\":%d,\"skipped\":%d,\"latep50\":%.3f,"
+                              "\"latep99\":%.3f,\"judder\":%.3f,\"avgqueued\":%.2f}}",
+                              summary.frames, summary.skipped, summary.lateP50,
+                              summary.lateP99, summary.judder, summary.avgQueued);
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(basePath + ".csv", true) ||
+      file.Write(csv.c_str(), csv.size()) != static_cast<ssize_t>(csv.size()))
+  {
+    CLog::Log(LOGERROR, "CFramePacingRecorder::Dump - failed to write %s.csv", basePath.c_str());
+    return false;
+  }
+  file.Close();
+
+  if (!file.OpenForWrite(basePath + ".json", true) ||
+      file.Write(json.c_str(), json.size()) != static_cast<ssize_t>(json.size()))
+  {
+    CLog::Log(LOGERROR, "CFramePacingRecorder::Dump - failed to write %s.json", basePath.c_str());
+    return false;
+  }
+  file.Close();
+
+  CLog::Log(LOGNOTICE, "CFramePacingRecorder::Dump - wrote %d frames to %s", static_cast<int>(records.size()), basePath.c_str());
+  return true;
+}
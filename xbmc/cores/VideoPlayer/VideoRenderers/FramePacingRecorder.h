@@ -0,0 +1,78 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/CriticalSection.h"
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * Ring buffer of the presentation decisions taken by CRenderManager.
+ * Used to tune refresh rate switching and frame drop logic, the recorded
+ * frames can be written to CSV and JSON and summarised for the debug overlay.
+ */
+class CFramePacingRecorder
+{
+public:
+  enum EDecision
+  {
+    DECISION_PRESENT = 0, ///< frame was flipped on time or late
+    DECISION_PRESENT_EARLY, ///< frame was flipped ahead of its slot (field/blend interpolation)
+    DECISION_SKIP, ///< frame was dropped because a later one was already due
+  };
+
+  struct SRecord
+  {
+    int64_t hostTime; ///< CurrentHostCounter() when the decision was taken
+    double targetPts; ///< pts the frame should be visible at
+    double renderPts; ///< pts the display shows when the frame is flipped
+    double frameTime; ///< duration of a display refresh
+    int queued; ///< frames left in the queue after the decision
+    int lateFrames;
+    EDecision decision;
+  };
+
+  struct SSummary
+  {
+    int frames = 0;
+    int skipped = 0;
+    double lateP50 = 0.0; ///< median lateness in ms
+    double lateP99 = 0.0; ///< 99th percentile lateness in ms
+    double judder = 0.0; ///< standard deviation of the lateness change between frames in ms
+    double avgQueued = 0.0;
+  };
+
+  explicit CFramePacingRecorder(size_t capacity = 4096);
+
+  void Reset();
+  void Record(const SRecord& record);
+
+  /**
+   * Summarise the most recent frames.
+   * @param frames number of records to look at, 0 for the whole buffer
+   */
+  SSummary GetSummary(size_t frames = 0) const;
+
+  /**
+   * Write the recorded frames to basePath.csv and basePath.json
+   */
+  bool Dump(const std::string& basePath) const;
+
+  static const char* DecisionToString(EDecision decision);
+
+protected:
+  std::vector<SRecord> GetRecords(size_t frames) const;
+
+  mutable CCriticalSection m_section;
+  std::vector<SRecord> m_records;
+  size_t m_next = 0;
+  size_t m_count = 0;
+};
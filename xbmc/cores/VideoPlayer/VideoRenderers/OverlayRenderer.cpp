@@ -388,11 +388,18 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
 
   if(o->m_textureid)
   {
-    if(changes == 0)
+    std::map<unsigned int, COverlay*>::iterator it = m_textureCache.find(o->m_textureid);
+    if (it != m_textureCache.end())
     {
-      std::map<unsigned int, COverlay*>::iterator it = m_textureCache.find(o->m_textureid);
-      if (it != m_textureCache.end())
+      // libass reports 0 for an identical frame and 1 if only positions
+      // changed, in both cases the glyph atlas can be reused
+      if(changes == 0)
         return it->second;
+#if defined(HAS_GL) || defined(HAS_GLES)
+      COverlayGlyphGL* glyphs = dynamic_cast<COverlayGlyphGL*>(it->second);
+      if(changes == 1 && glyphs && glyphs->UpdatePositions(images, targetWidth, targetHeight))
+        return it->second;
+#endif
     }
   }
 
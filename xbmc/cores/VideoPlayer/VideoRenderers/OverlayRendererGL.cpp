@@ -284,6 +284,11 @@ COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height)
   m_x      = 0.0f;
   m_y      = 0.0f;
   m_texture = 0;
+  m_count  = 0;
+  m_frameWidth  = width;
+  m_frameHeight = height;
+  m_vbo      = 0;
+  m_vboDirty = true;
 
   SQuads quads;
   if(!convert_quad(images, quads, width))
@@ -359,9 +364,55 @@ COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height)
 COverlayGlyphGL::~COverlayGlyphGL()
 {
   glDeleteTextures(1, &m_texture);
+  if (m_vbo)
+    glDeleteBuffers(1, &m_vbo);
   free(m_vertex);
 }
 
+bool COverlayGlyphGL::UpdatePositions(ASS_Image* images, int width, int height)
+{
+  if (!m_vertex || width != m_frameWidth || height != m_frameHeight)
+    return false;
+
+  // same filter as convert_quad, so the images map 1:1 onto the quads
+  int count = 0;
+  for (ASS_Image* img = images; img; img = img->next)
+  {
+    if ((img->color & 0xff) == 0xff || img->w == 0 || img->h == 0)
+      continue;
+    count++;
+  }
+  if (count != m_count)
+    return false;
+
+  float scale_x = 1.0f / width;
+  float scale_y = 1.0f / height;
+
+  VERTEX* vt = m_vertex;
+  for (ASS_Image* img = images; img; img = img->next)
+  {
+    if ((img->color & 0xff) == 0xff || img->w == 0 || img->h == 0)
+      continue;
+
+    vt[0].x = scale_x * img->dst_x;
+    vt[0].y = scale_y * img->dst_y;
+
+    vt[1].x = scale_x * img->dst_x;
+    vt[1].y = scale_y * (img->dst_y + img->h);
+
+    vt[2].x = scale_x * (img->dst_x + img->w);
+    vt[2].y = scale_y * img->dst_y;
+
+    vt[3].x = scale_x * (img->dst_x + img->w);
+    vt[3].y = scale_y * (img->dst_y + img->h);
+
+    vt += 4;
+  }
+
+  m_vboDirty = true;
+  return true;
+}
+
 void COverlayGlyphGL::Render(SRenderState& state)
 {
   if ((m_texture == 0) || (m_count == 0))
@@ -389,24 +440,30 @@ void COverlayGlyphGL::Render(SRenderState& state)
   GLint colLoc  = renderSystem->ShaderGetCol();
   GLint tex0Loc = renderSystem->ShaderGetCoord0();
 
-  std::vector<VERTEX> vecVertices( 6 * m_count);
-  VERTEX *vertices = &vecVertices[0];
+  // the vertex buffer lives as long as the overlay, it is only uploaded
+  // again when the glyphs were moved
+  if (!m_vbo)
+    glGenBuffers(1, &m_vbo);
+  glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
 
-  for (int i=0; i<m_count*4; i+=4)
+  if (m_vboDirty)
   {
-    *vertices++ = m_vertex[i];
-    *vertices++ = m_vertex[i+1];
-    *vertices++ = m_vertex[i+2];
+    std::vector<VERTEX> vecVertices( 6 * m_count);
+    VERTEX *vertices = &vecVertices[0];
 
-    *vertices++ = m_vertex[i+1];
-    *vertices++ = m_vertex[i+3];
-    *vertices++ = m_vertex[i+2];
-  }
-  GLuint VertexVBO;
+    for (int i=0; i<m_count*4; i+=4)
+    {
+      *vertices++ = m_vertex[i];
+      *vertices++ = m_vertex[i+1];
+      *vertices++ = m_vertex[i+2];
 
-  glGenBuffers(1, &VertexVBO);
-  glBindBuffer(GL_ARRAY_BUFFER, VertexVBO);
-  glBufferData(GL_ARRAY_BUFFER, sizeof(VERTEX)*vecVertices.size(), &vecVertices[0], GL_STATIC_DRAW);
+      *vertices++ = m_vertex[i+1];
+      *vertices++ = m_vertex[i+3];
+      *vertices++ = m_vertex[i+2];
+    }
+    glBufferData(GL_ARRAY_BUFFER, sizeof(VERTEX)*vecVertices.size(), &vecVertices[0], GL_STATIC_DRAW);
+    m_vboDirty = false;
+  }
 
   glVertexAttribPointer(posLoc, 3, GL_FLOAT, GL_FALSE, sizeof(VERTEX), BUFFER_OFFSET(offsetof(VERTEX, x)));
   glVertexAttribPointer(colLoc, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(VERTEX), BUFFER_OFFSET(offsetof(VERTEX, r)));
@@ -416,14 +473,13 @@ void COverlayGlyphGL::Render(SRenderState& state)
   glEnableVertexAttribArray(colLoc);
   glEnableVertexAttribArray(tex0Loc);
 
-  glDrawArrays(GL_TRIANGLES, 0, vecVertices.size());
+  glDrawArrays(GL_TRIANGLES, 0, 6 * m_count);
 
   glDisableVertexAttribArray(posLoc);
   glDisableVertexAttribArray(colLoc);
   glDisableVertexAttribArray(tex0Loc);
 
   glBindBuffer(GL_ARRAY_BUFFER, 0);
-  glDeleteBuffers(1, &VertexVBO);
 
   renderSystem->DisableShader();
 
@@ -44,6 +44,14 @@ namespace OVERLAY {
 
    void Render(SRenderState& state) override;
 
+   /*!
+    * \brief Move the glyphs to the positions of a new libass frame that only
+    * differs in placement (libass reported changes == 1). The atlas texture
+    * is kept as is.
+    * \return false if the images don't match this overlay, a full rebuild is needed then
+    */
+   bool UpdatePositions(ASS_Image* images, int width, int height);
+
     struct VERTEX
     {
        GLfloat u, v;
@@ -57,6 +65,11 @@ namespace OVERLAY {
    GLuint m_texture;
    float  m_u;
    float  m_v;
+
+   int    m_frameWidth;
+   int    m_frameHeight;
+   GLuint m_vbo;
+   bool   m_vboDirty;
   };
 
 }
@@ -15,6 +15,7 @@
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 #include "windowing/WinSystem.h"
 
 #include "Application.h"
@@ -222,6 +223,7 @@ bool CRenderManager::Configure()
     m_presentstep = PRESENT_IDLE;
     m_presentpts = DVD_NOPTS_VALUE;
     m_lateframes = -1;
+    m_framePacing.Reset();
     m_presentevent.notifyAll();
     m_renderedOverlay = false;
     m_renderDebug = false;
@@ -739,6 +741,11 @@ void CRenderManager::Render(bool clear, DWORD flags, DWORD alpha, bool gui)
                                      clockspeed * 100);
       }
 
+      CFramePacingRecorder::SSummary pacing = m_framePacing.GetSummary(FRAME_PACING_SUMMARY_FRAMES);
+      vsync += StringUtils::Format("  Pacing: frames:%i skip:%i late p50:%.1f p99:%.1f judder:%.2f queued:%.1f",
+                                   pacing.frames, pacing.skipped, pacing.lateP50,
+                                   pacing.lateP99, pacing.judder, pacing.avgQueued);
+
       m_debugRenderer.SetInfo(audio, video, player, vsync);
       m_debugRenderer.Render(src, dst, view);
 
@@ -1155,6 +1162,7 @@ void CRenderManager::PrepareNextRender()
       {
         m_discard.push_back(m_presentsourcePast);
         m_QueueSkip++;
+        RecordFramePacing(CFramePacingRecorder::DECISION_SKIP, m_Queue[m_presentsourcePast].pts, renderPts, frametime);
       }
       m_presentsourcePast = m_queued.front();
       m_queued.pop_front();
@@ -1173,6 +1181,7 @@ void CRenderManager::PrepareNextRender()
     m_presentpts = m_Queue[idx].pts - m_displayLatency;
     m_presentevent.notifyAll();
 
+    RecordFramePacing(CFramePacingRecorder::DECISION_PRESENT, m_Queue[idx].pts, renderPts, frametime);
     m_playerPort->UpdateRenderBuffers(m_queued.size(), m_discard.size(), m_free.size());
   }
   else if (!combined && renderPts > (nextFramePts - frametime))
@@ -1184,9 +1193,29 @@ void CRenderManager::PrepareNextRender()
     m_queued.pop_front();
     m_presentpts = m_Queue[m_presentsource].pts - m_displayLatency - frametime / 2;
     m_presentevent.notifyAll();
+
+    RecordFramePacing(CFramePacingRecorder::DECISION_PRESENT_EARLY, m_Queue[m_presentsource].pts, renderPts, frametime);
   }
 }
 
+void CRenderManager::RecordFramePacing(CFramePacingRecorder::EDecision decision, double targetPts, double renderPts, double frametime)
+{
+  CFramePacingRecorder::SRecord record;
+  record.hostTime = CurrentHostCounter();
+  record.targetPts = targetPts;
+  record.renderPts = renderPts;
+  record.frameTime = frametime;
+  record.queued = static_cast<int>(m_queued.size());
+  record.lateFrames = m_lateframes;
+  record.decision = decision;
+  m_framePacing.Record(record);
+}
+
+bool CRenderManager::DumpFramePacing(const std::string& basePath)
+{
+  return m_framePacing.Dump(basePath);
+}
+
 void CRenderManager::DiscardBuffer()
 {
   CSingleLock lock2(m_presentlock);
@@ -17,6 +17,7 @@
 #include "threads/CriticalSection.h"
 #include "cores/VideoSettings.h"
 #include "DebugRenderer.h"
+#include "FramePacingRecorder.h"
 #include <deque>
 #include <map>
 #include <atomic>
@@ -84,6 +85,11 @@ public:
 
   int GetSkippedFrames()  { return m_QueueSkip; }
 
+  /**
+   * Write the recorded presentation decisions to basePath.csv and basePath.json
+   */
+  bool DumpFramePacing(const std::string& basePath);
+
   bool Configure(const VideoPicture& picture, float fps, unsigned int orientation, int buffers = 0);
   bool AddVideoPicture(const VideoPicture& picture, volatile std::atomic_bool& bStop, EINTERLACEMETHOD deintMethod, bool wait);
   void AddOverlay(CDVDOverlay* o, double pts);
@@ -130,6 +136,7 @@ protected:
 
   void UpdateLatencyTweak();
   void CheckEnableClockSync();
+  void RecordFramePacing(CFramePacingRecorder::EDecision decision, double targetPts, double renderPts, double frametime);
 
   CBaseRenderer *m_pRenderer = nullptr;
   OVERLAY::CRenderer m_overlays;
@@ -201,6 +208,9 @@ protected:
   std::string m_stereomode;
 
   int m_lateframes = -1;
+  /// Number of recent frames summarised on the debug overlay
+  static const size_t FRAME_PACING_SUMMARY_FRAMES = 300;
+  CFramePacingRecorder m_framePacing;
   double m_presentpts = 0.0;
   EPRESENTSTEP m_presentstep = PRESENT_IDLE;
   XbmcThreads::EndTime m_presentTimer;
@@ -333,6 +333,9 @@ bool CGUIDialogContextMenu::OnContextButton(const std::string &type, const CFile
         ClearDefault(type);
     }
     CMediaSourceSettings::GetInstance().DeleteSource(type, share->strName, share->strPath);
+
+    CGUIMessage msg(GUI_MSG_NOTIFY_ALL, 0, 0, GUI_MSG_UPDATE_SOURCES);
+    CServiceBroker::GetGUI()->GetWindowManager().SendThreadMessage(msg);
     return true;
   }
   case CONTEXT_BUTTON_SET_DEFAULT:
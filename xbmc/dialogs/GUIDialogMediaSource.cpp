@@ -10,6 +10,7 @@
 #include "ServiceBroker.h"
 #include "guilib/GUIKeyboardFactory.h"
 #include "GUIDialogFileBrowser.h"
+#include "GUIUserMessages.h"
 #include "video/windows/GUIWindowVideoBase.h"
 #include "music/windows/GUIWindowMusicBase.h"
 #include "guilib/GUIComponent.h"
@@ -225,6 +226,9 @@ void CGUIDialogMediaSource::OnMediaSourceChanged(const std::string& type, const
     else if (type == "music")
       CGUIWindowMusicBase::OnAssignContent(oldName, share);
   }
+
+  CGUIMessage msg(GUI_MSG_NOTIFY_ALL, 0, 0, GUI_MSG_UPDATE_SOURCES);
+  CServiceBroker::GetGUI()->GetWindowManager().SendThreadMessage(msg);
 }
 
 void CGUIDialogMediaSource::OnPathBrowse(int item)
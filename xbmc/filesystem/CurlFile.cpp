@@ -244,6 +244,7 @@ CCurlFile::CReadState::CReadState()
   m_overflowSize = 0;
   m_stillRunning = 0;
   m_filePos = 0;
+  m_rangeEnd = 0;
   m_fileSize = 0;
   m_bufferSize = 0;
   m_cancelled = false;
@@ -267,6 +268,10 @@ CCurlFile::CReadState::~CReadState()
 
 bool CCurlFile::CReadState::Seek(int64_t pos)
 {
+  // a bounded range is requested anew, its transfer ends with the range
+  if (m_rangeEnd > 0)
+    return false;
+
   if(pos == m_filePos)
     return true;
 
@@ -312,6 +317,15 @@ void CCurlFile::CReadState::SetResume(void)
    * request header. If we don't the server may provide different content causing seeking to fail.
    * This only affects HTTP-like items, for FTP it's a null operation.
    */
+  if (m_rangeEnd > m_filePos)
+  {
+    // bounded request, the server ends the transfer and the connection can be reused
+    std::string range = StringUtils::Format("%" PRId64 "-%" PRId64, m_filePos, m_rangeEnd - 1);
+    g_curlInterface.easy_setopt(m_easyHandle, CURLOPT_RANGE, range.c_str());
+    g_curlInterface.easy_setopt(m_easyHandle, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)0);
+    return;
+  }
+
   if (m_sendRange && m_filePos == 0)
     g_curlInterface.easy_setopt(m_easyHandle, CURLOPT_RANGE, "0-");
   else
@@ -359,6 +373,15 @@ long CCurlFile::CReadState::Connect(unsigned int size)
     m_fileSize = m_filePos + (int64_t)length;
   }
 
+  if (m_rangeEnd > 0)
+  {
+    // the length of a bounded range is the range only, the file size follows the slash
+    std::string contentRange = m_httpheader.GetValue("content-range");
+    size_t slash = contentRange.rfind('/');
+    if (slash != std::string::npos && contentRange.compare(slash + 1, std::string::npos, "*") != 0)
+      m_fileSize = strtoll(contentRange.c_str() + slash + 1, NULL, 10);
+  }
+
   long response;
   if (CURLE_OK == g_curlInterface.easy_getinfo(m_easyHandle, CURLINFO_RESPONSE_CODE, &response))
     return response;
@@ -376,6 +399,7 @@ void CCurlFile::CReadState::Disconnect()
   m_overflowBuffer = NULL;
   m_overflowSize = 0;
   m_filePos = 0;
+  m_rangeEnd = 0;
   m_fileSize = 0;
   m_bufferSize = 0;
   m_readBuffer = 0;
@@ -458,6 +482,9 @@ void CCurlFile::SetCommonOptions(CReadState* state, bool failOnError /* = true *
 
   g_curlInterface.easy_reset(h);
 
+  if (g_curlInterface.GetShare())
+    g_curlInterface.easy_setopt(h, CURLOPT_SHARE, g_curlInterface.GetShare());
+
   g_curlInterface.easy_setopt(h, CURLOPT_DEBUGFUNCTION, debug_callback);
 
   if( CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_logLevel >= LOG_LEVEL_DEBUG )
@@ -801,6 +828,8 @@ void CCurlFile::ParseAndCorrectUrl(CURL &url2)
           m_skipshout = true;
         else if (name == "seekable" && value == "0")
           m_seekable = false;
+        else if (name == "rangelength")
+          m_rangeLength = strtoll(value.c_str(), NULL, 10);
         else if (name == "accept-charset")
           SetAcceptCharset(value);
         else if (name == "sslcipherlist")
@@ -1002,6 +1031,7 @@ bool CCurlFile::Open(const CURL& url)
   SetCommonOptions(m_state, m_failOnError && !CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->CanLogComponent(LOGCURL));
   SetRequestHeaders(m_state);
   m_state->m_sendRange = m_seekable;
+  m_state->m_rangeEnd = m_seekable ? m_rangeLength : 0;
   m_state->m_bRetry = m_allowRetry;
 
   m_httpresponse = m_state->Connect(m_bufferSize);
@@ -1352,6 +1382,7 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
   SetRequestHeaders(m_state);
 
   m_state->m_filePos = nextPos;
+  m_state->m_rangeEnd = m_rangeLength > 0 ? nextPos + m_rangeLength : 0;
   m_state->m_sendRange = true;
 
   long response = m_state->Connect(m_bufferSize);
@@ -1964,6 +1995,12 @@ int CCurlFile::IoControl(EIoControl request, void* param)
     return 0;
   }
 
+  if (request == IOCTRL_SET_RANGE)
+  {
+    m_rangeLength = *(int64_t*) param;
+    return 0;
+  }
+
   return -1;
 }
 
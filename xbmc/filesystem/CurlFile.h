@@ -106,6 +106,7 @@ namespace XFILE
           bool m_cancelled;
           int64_t m_fileSize;
           int64_t m_filePos;
+          int64_t m_rangeEnd; // end of a bounded range request, 0 for the rest of the file
           bool m_bFirstLoop;
           bool m_isPaused;
           bool m_sendRange;
@@ -182,6 +183,7 @@ namespace XFILE
       bool m_skipshout;
       bool m_postdataset;
       bool m_allowRetry;
+      int64_t m_rangeLength = 0;
       bool m_verifyPeer = true;
       bool m_failOnError = true;
 
@@ -97,6 +97,16 @@ CURLMcode DllLibCurl::multi_cleanup(CURLM* handle)
   return curl_multi_cleanup(handle);
 }
 
+CURLSH* DllLibCurl::share_init()
+{
+  return curl_share_init();
+}
+
+CURLSHcode DllLibCurl::share_cleanup(CURLSH* share)
+{
+  return curl_share_cleanup(share);
+}
+
 curl_slist* DllLibCurl::slist_append(curl_slist* list, const char* to_append)
 {
   return curl_slist_append(list, to_append);
@@ -130,14 +140,53 @@ DllLibCurlGlobal::DllLibCurlGlobal()
   {
     CLog::Log(LOGERROR, "Error initializing libcurl");
   }
+
+  // name lookups and TLS sessions are reused by all transfers, a new
+  // connection to a known server then skips the lookup and does an
+  // abbreviated handshake. Connections themselves can't be shared between
+  // threads, they stay with the idle sessions below.
+  m_share = share_init();
+  if (m_share)
+  {
+    share_setopt(m_share, CURLSHOPT_LOCKFUNC, share_lock);
+    share_setopt(m_share, CURLSHOPT_UNLOCKFUNC, share_unlock);
+    share_setopt(m_share, CURLSHOPT_USERDATA, this);
+    share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+    share_setopt(m_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+  }
 }
 
 DllLibCurlGlobal::~DllLibCurlGlobal()
 {
+  // handles still using the share have to go first
+  for (auto& session : m_sessions)
+  {
+    if (session.m_multi && session.m_easy)
+      multi_remove_handle(session.m_multi, session.m_easy);
+    if (session.m_easy)
+      easy_cleanup(session.m_easy);
+    if (session.m_multi)
+      multi_cleanup(session.m_multi);
+  }
+  m_sessions.clear();
+
+  if (m_share)
+    share_cleanup(m_share);
+
   // close libcurl
   curl_global_cleanup();
 }
 
+void DllLibCurlGlobal::share_lock(CURL_HANDLE* handle, curl_lock_data data, curl_lock_access access, void* userptr)
+{
+  static_cast<DllLibCurlGlobal*>(userptr)->m_shareLocks[data].lock();
+}
+
+void DllLibCurlGlobal::share_unlock(CURL_HANDLE* handle, curl_lock_data data, void* userptr)
+{
+  static_cast<DllLibCurlGlobal*>(userptr)->m_shareLocks[data].unlock();
+}
+
 void DllLibCurlGlobal::CheckIdle()
 {
   CSingleLock lock(m_critSection);
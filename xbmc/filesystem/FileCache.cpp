@@ -14,8 +14,10 @@
 #include "ServiceBroker.h"
 
 #include "CircularCache.h"
+#include "RangeReader.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
+#include "utils/URIUtils.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
 
@@ -34,6 +36,12 @@
 using namespace XFILE;
 
 #define READ_CACHE_CHUNK_SIZE (128*1024)
+#define READ_CACHE_MAX_CHUNK_SIZE (1024*1024)
+#define THROUGHPUT_WINDOW 500
+#define READAHEAD_SECONDS 20.0
+#define READAHEAD_MIN_SECONDS 10.0
+#define RANGE_BLOCK_SIZE (1024*1024)
+#define RANGE_ADAPT_INTERVAL 2000
 
 class CWriteRate
 {
@@ -80,6 +88,34 @@ private:
   int64_t  m_size;
 };
 
+/* Smoothed rate of the bytes over the time passed in. Unlike CWriteRate only
+ * the time given is counted, e.g. the time spent in reads of the source but
+ * not the time spent throttled or waiting for space in the cache.
+ */
+class CThroughput
+{
+public:
+  void Add(int64_t bytes, unsigned int time)
+  {
+    m_bytes += bytes;
+    m_time += time;
+    if (m_time < THROUGHPUT_WINDOW)
+      return;
+
+    const unsigned rate = (unsigned)(1000 * m_bytes / m_time);
+    m_rate = m_rate ? (unsigned)((3 * (uint64_t)m_rate + rate) / 4) : rate;
+    m_bytes = 0;
+    m_time = 0;
+  }
+
+  unsigned Rate() const { return m_rate; }
+
+private:
+  int64_t m_bytes = 0;
+  unsigned int m_time = 0;
+  unsigned m_rate = 0;
+};
+
 
 CFileCache::CFileCache(const unsigned int flags)
   : CThread("FileCache")
@@ -173,6 +209,15 @@ bool CFileCache::Open(const CURL& url)
   m_chunkSize = CFile::GetChunkSize(m_source.GetChunkSize(), READ_CACHE_CHUNK_SIZE);
   m_fileSize = m_source.GetLength();
 
+  // fetch ahead with several range requests, a single stream is bound by the round trip time
+  const unsigned int rangeConnections = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheRangeConnections;
+  if (rangeConnections > 1 && m_seekPossible > 0 && m_fileSize > 0 &&
+      (URIUtils::IsHTTP(m_sourcePath) || URIUtils::IsDAV(m_sourcePath)))
+  {
+    CLog::Log(LOGDEBUG, "CFileCache::Open - reading ahead with up to %u connections", rangeConnections);
+    m_rangeReader.reset(new CRangeReader(m_sourcePath, RANGE_BLOCK_SIZE, rangeConnections));
+  }
+
   if (!m_pCache)
   {
     if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheMemSize == 0)
@@ -229,6 +274,18 @@ bool CFileCache::Open(const CURL& url)
   m_forward = 0;
   m_bFilling = true;
   m_bLowSpeedDetected = false;
+  m_readahead = 0;
+  m_readChunk = m_chunkSize;
+  m_sourceRate = 0;
+  m_readRate = 0;
+  m_consumed = 0;
+  m_stalls = 0;
+  m_stallPossible = false;
+  m_levelSum = 0.0;
+  m_levelTime = 0;
+  m_levelStamp = XbmcThreads::SystemClockMillis();
+  m_averageLevel = 0.0f;
+  m_seekWaste = 0;
   m_seekEvent.Reset();
   m_seekEnded.Reset();
 
@@ -245,8 +302,9 @@ void CFileCache::Process()
     return;
   }
 
-  // create our read buffer
-  std::unique_ptr<char[]> buffer(new char[m_chunkSize]);
+  // create our read buffer, big enough for the largest chunk a fast source is read with
+  const unsigned maxChunk = std::max(m_chunkSize, READ_CACHE_MAX_CHUNK_SIZE / m_chunkSize * m_chunkSize);
+  std::unique_ptr<char[]> buffer(new char[maxChunk]);
   if (buffer.get() == NULL)
   {
     CLog::Log(LOGERROR, "%s - failed to allocate read buffer", __FUNCTION__);
@@ -255,13 +313,32 @@ void CFileCache::Process()
 
   CWriteRate limiter;
   CWriteRate average;
+  CWriteRate connectionRate;
+  unsigned int connectionStamp = XbmcThreads::SystemClockMillis();
+  CThroughput source;
+  CThroughput consumer;
+  uint64_t consumed = m_consumed;
+  unsigned int consumedStamp = XbmcThreads::SystemClockMillis();
   bool cacheReachEOF = false;
 
+  if (m_rangeReader)
+    m_rangeReader->Seek(0, m_fileSize);
+
   while (!m_bStop)
   {
     // Update filesize
     m_fileSize = m_source.GetLength();
 
+    // rate the cache is read at, paused playback lowers it as well
+    const unsigned int consumedNow = XbmcThreads::SystemClockMillis();
+    const uint64_t consumedTotal = m_consumed;
+    consumer.Add(consumedTotal - consumed, consumedNow - consumedStamp);
+    consumed = consumedTotal;
+    consumedStamp = consumedNow;
+    m_readRate = consumer.Rate();
+
+    UpdateReadahead(maxChunk);
+
     // check for seek events
     if (m_seekEvent.WaitMSec(0))
     {
@@ -271,7 +348,13 @@ void CFileCache::Process()
       bool sourceSeekFailed = false;
       if (!cacheReachEOF)
       {
-        m_nSeekResult = m_source.Seek(cacheMaxPos, SEEK_SET);
+        if (m_rangeReader)
+        {
+          m_rangeReader->Seek(cacheMaxPos, m_fileSize);
+          m_nSeekResult = cacheMaxPos;
+        }
+        else
+          m_nSeekResult = m_source.Seek(cacheMaxPos, SEEK_SET);
         if (m_nSeekResult != cacheMaxPos)
         {
           CLog::Log(LOGERROR,"CFileCache::Process - Error %d seeking. Seek returned %" PRId64, (int)GetLastError(), m_nSeekResult);
@@ -281,12 +364,17 @@ void CFileCache::Process()
       }
       if (!sourceSeekFailed)
       {
+        const int64_t forward = m_writePos - m_readPos;
         const bool bCompleteReset = m_pCache->Reset(m_seekPos, false);
+        if (bCompleteReset && forward > 0)
+          m_seekWaste += forward;
         m_readPos = m_seekPos;
         m_writePos = m_pCache->CachedDataEndPos();
         assert(m_writePos == cacheMaxPos);
         average.Reset(m_writePos, bCompleteReset); // Can only recalculate new average from scratch after a full reset (empty cache)
         limiter.Reset(m_writePos);
+        connectionRate.Reset(m_writePos);
+        connectionStamp = XbmcThreads::SystemClockMillis();
         m_nSeekResult = m_seekPos;
         if (bCompleteReset)
         {
@@ -318,7 +406,19 @@ void CFileCache::Process()
       }
     }
 
-    size_t maxWrite = m_pCache->GetMaxWriteSize(m_chunkSize);
+    // enough cached ahead for the rates measured, don't read what a seek may throw away
+    if (m_readahead > 0 && m_writePos - m_readPos >= m_readahead)
+    {
+      UpdateLevel();
+      if (m_seekEvent.WaitMSec(100))
+      {
+        if (!m_bStop)
+          m_seekEvent.Set();
+      }
+      continue;
+    }
+
+    size_t maxWrite = m_pCache->GetMaxWriteSize(m_readChunk);
 
     /* Only read from source if there's enough write space in the cache
      * else we may keep disposing data and seeking back on (slow) source
@@ -331,7 +431,28 @@ void CFileCache::Process()
 
     ssize_t iRead = 0;
     if (!cacheReachEOF)
-      iRead = m_source.Read(buffer.get(), maxWrite);
+    {
+      const unsigned int readStamp = XbmcThreads::SystemClockMillis();
+      if (m_rangeReader)
+      {
+        // keep an eye on seek events while the blocks are in flight
+        if (!m_rangeReader->WaitForData(100))
+        {
+          source.Add(0, XbmcThreads::SystemClockMillis() - readStamp);
+          m_sourceRate = source.Rate();
+          continue;
+        }
+        iRead = m_rangeReader->Read(buffer.get(), maxWrite);
+      }
+      else
+        iRead = m_source.Read(buffer.get(), maxWrite);
+
+      if (iRead > 0)
+      {
+        source.Add(iRead, XbmcThreads::SystemClockMillis() - readStamp);
+        m_sourceRate = source.Rate();
+      }
+    }
     if (iRead == 0)
     {
       // Check for actual EOF and retry as long as we still have data in our cache
@@ -417,30 +538,99 @@ void CFileCache::Process()
     // avoid uncertainty at start of caching
     m_writeRateActual = average.Rate(m_writePos, 1000);
 
-    // Update forward cache size
-    m_forward = m_pCache->WaitForData(0, 0);
+    UpdateLevel();
 
-    // NOTE: Hysteresis (20-80%) for filling-logic
-    const float level = (m_forwardCacheSize == 0) ? 0.0 : (float) m_forward / m_forwardCacheSize;
-    if (level > 0.8f)
-    {
-     /* NOTE: We can only reliably test for low speed condition, when the cache is *really*
-      * filling. This is because as soon as it's full the average-
-      * rate will become approximately the current-rate which can flag false
-      * low read-rate conditions.
-      */
-      if (m_bFilling && m_writeRateActual < m_writeRate)
-        m_bLowSpeedDetected = true;
-
-      m_bFilling = false;
-    }
-    else if (level < 0.2f)
+    /* Add connections while the cache fills slower than the stream needs and
+     * drop them again when it fills way faster. Only measured while filling,
+     * a full cache throttles the reads and says nothing about the link.
+     */
+    if (m_rangeReader)
     {
-      m_bFilling = true;
+      const unsigned int now = XbmcThreads::SystemClockMillis();
+      if (!m_bFilling)
+      {
+        connectionRate.Reset(m_writePos);
+        connectionStamp = now;
+      }
+      else if (now - connectionStamp >= RANGE_ADAPT_INTERVAL)
+      {
+        const unsigned rate = connectionRate.Rate(m_writePos);
+        const unsigned target = m_writeRate * CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_cacheReadFactor;
+        const unsigned int connections = m_rangeReader->GetConnections();
+        if (rate < target && connections < m_rangeReader->GetMaxConnections())
+          m_rangeReader->SetConnections(connections + 1);
+        else if (rate > 2 * target && connections > 1)
+          m_rangeReader->SetConnections(connections - 1);
+
+        if (m_rangeReader->GetConnections() != connections)
+          CLog::Log(LOGDEBUG, "CFileCache::Process - %u connections at %u bytes/s for %u bytes/s", m_rangeReader->GetConnections(), rate, target);
+
+        connectionRate.Reset(m_writePos);
+        connectionStamp = now;
+      }
     }
   }
 }
 
+void CFileCache::UpdateReadahead(unsigned maxChunk)
+{
+  // read about a tenth of a second per call, fast sources with less overhead, slow ones still responsive to seeks
+  const unsigned sourceRate = m_sourceRate;
+  if (sourceRate > 0)
+    m_readChunk = std::min(std::max(sourceRate / 10 / m_chunkSize, 1u) * m_chunkSize, maxChunk);
+
+  // nothing consumed lately (paused) or a cache on disk, keep what was decided
+  if (m_readRate == 0 || sourceRate == 0 || m_forwardCacheSize == 0 || !(m_flags & READ_AUDIO_VIDEO))
+    return;
+
+  /* The closer the source gets to the rate the stream is read at, the
+   * further ahead it needs to be to ride out a dip. A source way faster than
+   * the stream catches up quickly and a big readahead only wastes bandwidth
+   * on seeks.
+   */
+  int64_t readahead = m_forwardCacheSize;
+  if (sourceRate > m_readRate)
+  {
+    const double seconds = std::max(READAHEAD_MIN_SECONDS, READAHEAD_SECONDS * m_readRate / (sourceRate - m_readRate));
+    readahead = std::min(readahead, (int64_t)(seconds * m_readRate));
+  }
+  m_readahead = std::max(readahead, (int64_t)m_readChunk * 2);
+}
+
+void CFileCache::UpdateLevel()
+{
+  // Update forward cache size
+  m_forward = m_pCache->WaitForData(0, 0);
+
+  // NOTE: Hysteresis (20-80%) for filling-logic
+  const int64_t target = m_readahead > 0 ? std::min(m_readahead, m_forwardCacheSize) : m_forwardCacheSize;
+  const float level = (target == 0) ? 0.0 : (float) m_forward / target;
+  if (level > 0.8f)
+  {
+   /* NOTE: We can only reliably test for low speed condition, when the cache is *really*
+    * filling. This is because as soon as it's full the average-
+    * rate will become approximately the current-rate which can flag false
+    * low read-rate conditions.
+    */
+    if (m_bFilling && m_writeRateActual < m_writeRate)
+      m_bLowSpeedDetected = true;
+
+    m_bFilling = false;
+  }
+  else if (level < 0.2f)
+  {
+    m_bFilling = true;
+  }
+
+  // time weighted average since opening
+  const unsigned int now = XbmcThreads::SystemClockMillis();
+  m_levelSum += std::min(level, 1.0f) * (now - m_levelStamp);
+  m_levelTime += now - m_levelStamp;
+  m_levelStamp = now;
+  if (m_levelTime > 0)
+    m_averageLevel = (float)(m_levelSum / m_levelTime);
+}
+
 void CFileCache::OnExit()
 {
   m_bStop = true;
@@ -482,11 +672,20 @@ retry:
   if (iRc > 0)
   {
     m_readPos += iRc;
+    m_consumed += iRc;
+    m_stallPossible = true;
     return (int)iRc;
   }
 
   if (iRc == CACHE_RC_WOULD_BLOCK)
   {
+    // ran dry while playing, waiting after opening or a seek is expected
+    if (m_stallPossible)
+    {
+      m_stalls++;
+      m_stallPossible = false;
+    }
+
     // just wait for some data to show up
     iRc = m_pCache->WaitForData(1, 10000);
     if (iRc > 0)
@@ -537,6 +736,7 @@ int64_t CFileCache::Seek(int64_t iFilePosition, int iWhence)
     /* never request closer to end than 2k, speeds up tag reading */
     m_seekPos = std::min(iTarget, std::max((int64_t)0, m_fileSize - m_chunkSize));
 
+    m_stallPossible = false;
     m_seekEvent.Set();
     if (!m_seekEnded.Wait())
     {
@@ -572,6 +772,7 @@ void CFileCache::Close()
   if (m_pCache)
     m_pCache->Close();
 
+  m_rangeReader.reset();
   m_source.Close();
 }
 
@@ -611,6 +812,12 @@ int CFileCache::IoControl(EIoControl request, void* param)
     status->currate = m_writeRateActual;
     status->lowspeed = m_bLowSpeedDetected;
     m_bLowSpeedDetected = false; // Reset flag
+    status->readahead = m_readahead > 0 ? m_readahead : m_forwardCacheSize;
+    status->sourcerate = m_sourceRate;
+    status->readrate = m_readRate;
+    status->stalls = m_stalls;
+    status->level = m_averageLevel;
+    status->seekwaste = m_seekWaste;
     return 0;
   }
 
@@ -14,9 +14,11 @@
 #include "File.h"
 #include "threads/Thread.h"
 #include <atomic>
+#include <memory>
 
 namespace XFILE
 {
+  class CRangeReader;
 
   class CFileCache : public IFile, public CThread
   {
@@ -56,10 +58,14 @@ namespace XFILE
     }
 
   private:
+    void UpdateReadahead(unsigned maxChunk);
+    void UpdateLevel();
+
     CCacheStrategy *m_pCache;
     bool m_bDeleteCache;
     int m_seekPossible;
     CFile m_source;
+    std::unique_ptr<CRangeReader> m_rangeReader; ///< reads ahead with several connections if enabled
     std::string m_sourcePath;
     CEvent m_seekEvent;
     CEvent m_seekEnded;
@@ -74,6 +80,18 @@ namespace XFILE
     int64_t m_forward;
     bool m_bFilling;
     bool m_bLowSpeedDetected;
+    int64_t m_readahead = 0; ///< bytes to keep cached ahead, 0 for the whole forward cache
+    unsigned m_readChunk = 0; ///< bytes read from the source at once
+    unsigned m_sourceRate = 0; ///< throughput of the source while reading
+    unsigned m_readRate = 0; ///< rate the cache is read at
+    std::atomic<uint64_t> m_consumed{0}; ///< bytes read from the cache
+    unsigned m_stalls = 0; ///< reads that had to wait for the source while playing
+    bool m_stallPossible = false;
+    double m_levelSum = 0.0;
+    unsigned int m_levelTime = 0;
+    unsigned int m_levelStamp = 0;
+    float m_averageLevel = 0.0f; ///< time weighted fill level relative to the readahead
+    uint64_t m_seekWaste = 0; ///< bytes cached ahead and dropped by seeks
     std::atomic<int64_t> m_fileSize;
     unsigned int m_flags;
     CCriticalSection m_sync;
@@ -52,6 +52,12 @@ struct SCacheStatus
   unsigned maxrate;  /**< maximum number of bytes per second cache is allowed to fill */
   unsigned currate;  /**< average read rate from source file since last position change */
   bool     lowspeed; /**< cache low speed condition detected? */
+  uint64_t readahead;  /**< number of bytes the cache aims to keep forward, adapted to the source and read rates */
+  unsigned sourcerate; /**< throughput of the source file while reading from it */
+  unsigned readrate;   /**< rate the cache is read at */
+  unsigned stalls;     /**< number of reads that had to wait for the source during playback since opening */
+  float    level;      /**< average fill level of the forward cache relative to the readahead since opening */
+  uint64_t seekwaste;  /**< number of bytes cached forward and dropped by seeks since opening */
 };
 
 typedef enum {
@@ -61,6 +67,7 @@ typedef enum {
   IOCTRL_CACHE_SETRATE = 4,  /**< unsigned int with speed limit for caching in bytes per second */
   IOCTRL_SET_CACHE     = 8,  /**< CFileCache */
   IOCTRL_SET_RETRY     = 16, /**< Enable/disable retry within the protocol handler (if supported) */
+  IOCTRL_SET_RANGE     = 32, /**< int64_t with the number of bytes to request on the following seeks, 0 for the rest of the file. The "rangelength" protocol option sets it for the open request. */
 } EIoControl;
 
 enum CURLOPTIONTYPE
@@ -0,0 +1,281 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "RangeReader.h"
+
+#include "File.h"
+#include "URL.h"
+#include "threads/SingleLock.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+
+using namespace XFILE;
+
+#define RANGE_READ_SIZE (64*1024)
+#define RANGE_MAX_ATTEMPTS 3
+// blocks queued beyond the ones in flight, so a free connection never waits on the reader
+#define RANGE_SPARE_BLOCKS 2
+
+CRangeReader::CRangeReader(const std::string& path, unsigned int blockSize, unsigned int maxConnections)
+  : m_path(path)
+  , m_blockSize(std::max(blockSize, 1u))
+  , m_maxConnections(std::max(maxConnections, 1u))
+{
+  for (unsigned int i = 0; i < m_maxConnections; i++)
+  {
+    m_threads.emplace_back(new CThread(this, "RangeReader"));
+    m_threads.back()->Create();
+  }
+}
+
+CRangeReader::~CRangeReader()
+{
+  Stop();
+}
+
+void CRangeReader::Stop()
+{
+  {
+    CSingleLock lock(m_section);
+    m_stop = true;
+    m_queued.notifyAll();
+    m_fetched.notifyAll();
+  }
+
+  for (auto& thread : m_threads)
+    thread->StopThread(true);
+  m_threads.clear();
+}
+
+void CRangeReader::Seek(int64_t position, int64_t length)
+{
+  CSingleLock lock(m_section);
+  m_generation++;
+  m_blocks.clear();
+  m_length = length;
+  m_nextBlock = position;
+  m_offset = 0;
+  FillWindow();
+}
+
+void CRangeReader::FillWindow()
+{
+  while (m_blocks.size() < m_connections + RANGE_SPARE_BLOCKS && m_nextBlock < m_length)
+  {
+    std::shared_ptr<SBlock> block = std::make_shared<SBlock>();
+    block->start = m_nextBlock;
+    block->data.resize((size_t)std::min((int64_t)m_blockSize, m_length - m_nextBlock));
+    m_nextBlock += block->data.size();
+    m_blocks.push_back(block);
+  }
+  m_queued.notifyAll();
+}
+
+bool CRangeReader::WaitForData(unsigned int timeout)
+{
+  CSingleLock lock(m_section);
+  auto ready = [this]() {
+    if (m_stop || m_blocks.empty())
+      return true;
+    const SBlock& block = *m_blocks.front();
+    return m_offset < block.filled || block.done || block.failed;
+  };
+
+  if (!ready())
+    m_fetched.wait(lock, timeout);
+  return ready();
+}
+
+ssize_t CRangeReader::Read(char* buffer, size_t size)
+{
+  CSingleLock lock(m_section);
+  while (!m_stop)
+  {
+    if (m_blocks.empty())
+      return 0;
+
+    std::shared_ptr<SBlock> block = m_blocks.front();
+    if (m_offset < block->filled)
+    {
+      // bytes below filled are not touched by the fetching thread anymore
+      size_t read = std::min(size, block->filled - m_offset);
+      memcpy(buffer, block->data.data() + m_offset, read);
+      m_offset += read;
+      if (m_offset == block->data.size())
+      {
+        m_blocks.pop_front();
+        m_offset = 0;
+        FillWindow();
+      }
+      return read;
+    }
+
+    if (block->failed)
+      return -1;
+
+    if (block->done)
+    {
+      // the source ended before its announced length
+      m_blocks.clear();
+      m_nextBlock = m_length;
+      return 0;
+    }
+
+    m_fetched.wait(lock);
+  }
+  return -1;
+}
+
+void CRangeReader::SetConnections(unsigned int connections)
+{
+  CSingleLock lock(m_section);
+  m_connections = std::min(std::max(connections, 1u), m_maxConnections);
+  FillWindow();
+}
+
+unsigned int CRangeReader::GetConnections() const
+{
+  CSingleLock lock(m_section);
+  return m_connections;
+}
+
+unsigned int CRangeReader::GetMaxConnections() const
+{
+  CSingleLock lock(m_section);
+  return m_maxConnections;
+}
+
+void CRangeReader::Run()
+{
+  CFile file;
+  bool opened = false;
+
+  CSingleLock lock(m_section);
+  while (!m_stop)
+  {
+    // oldest block nobody fetches yet, if a connection is free
+    std::shared_ptr<SBlock> block;
+    if (m_running < m_connections)
+    {
+      auto it = std::find_if(m_blocks.begin(), m_blocks.end(), [](const std::shared_ptr<SBlock>& block) {
+        return !block->running && !block->done && !block->failed;
+      });
+      if (it != m_blocks.end())
+        block = *it;
+    }
+
+    if (!block)
+    {
+      m_queued.wait(lock);
+      continue;
+    }
+
+    block->running = true;
+    m_running++;
+    unsigned int generation = m_generation;
+    const bool connected = opened;
+
+    bool fetched;
+    {
+      CSingleExit exit(m_section);
+      fetched = FetchBlock(*block, file, opened, generation);
+    }
+
+    m_running--;
+    block->running = false;
+    if (fetched)
+      block->done = true;
+    else if (generation == m_generation)
+    {
+      ++block->attempts;
+
+      // the server may limit the number of connections, settle for less if it
+      // refuses a new one while others are open or a block keeps failing
+      if (m_connections > 1 && ((!connected && m_running > 0) || block->attempts > 1))
+      {
+        m_connections--;
+        m_maxConnections = m_connections;
+        CLog::Log(LOGWARNING, "CRangeReader::Run - fetching failed, reduced to %u connections", m_connections);
+      }
+      if (block->attempts >= RANGE_MAX_ATTEMPTS)
+      {
+        CLog::Log(LOGERROR, "CRangeReader::Run - failed to fetch %s at %" PRId64, CURL::GetRedacted(m_path).c_str(), block->start + (int64_t)block->filled);
+        block->failed = true;
+      }
+    }
+    m_fetched.notifyAll();
+    m_queued.notifyAll();
+  }
+
+  CSingleExit exit(m_section);
+  file.Close();
+}
+
+bool CRangeReader::FetchBlock(SBlock& block, CFile& file, bool& opened, unsigned int generation)
+{
+  // only this thread writes to the block while it is running
+  size_t filled = block.filled;
+  const int64_t position = block.start + filled;
+
+  // ask for this block only, so the connection is kept for the next one
+  int64_t range = block.data.size() - filled;
+
+  bool seek = true;
+  if (!opened)
+  {
+    // bound the open request too, otherwise it fetches the whole file. It
+    // starts at 0, so it either is this block or a short one to discard.
+    CURL url(m_path);
+    if (URIUtils::IsHTTP(m_path) || URIUtils::IsDAV(m_path))
+    {
+      int64_t openRange = position == 0 ? range : std::min(range, (int64_t)RANGE_READ_SIZE);
+      url.SetProtocolOption("rangelength", StringUtils::Format("%" PRId64, openRange));
+    }
+    if (!file.Open(url, READ_NO_CACHE | READ_TRUNCATED))
+      return false;
+    opened = true;
+    seek = position != 0;
+
+    bool retry = false;
+    file.IoControl(IOCTRL_SET_RETRY, &retry); // We retry per block ourselves
+  }
+
+  file.IoControl(IOCTRL_SET_RANGE, &range);
+
+  if (seek && file.Seek(position, SEEK_SET) != position)
+  {
+    file.Close();
+    opened = false;
+    return false;
+  }
+
+  while (filled < block.data.size())
+  {
+    ssize_t read = file.Read(block.data.data() + filled, std::min(block.data.size() - filled, (size_t)RANGE_READ_SIZE));
+    if (read < 0)
+    {
+      file.Close();
+      opened = false;
+      return false;
+    }
+
+    CSingleLock lock(m_section);
+    if (read == 0 || m_stop || generation != m_generation)
+      return true;
+
+    filled += read;
+    block.filled = filled;
+    m_fetched.notifyAll();
+  }
+  return true;
+}
@@ -0,0 +1,106 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/IRunnable.h"
+#include "threads/Thread.h"
+
+#include <deque>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace XFILE
+{
+  class CFile;
+
+  /*!
+   \brief Reads a file ahead with several concurrent byte range requests.
+
+   The file is split into blocks which are fetched by a pool of connections,
+   each with its own handle on the source. Blocks are handed out in file
+   order, so the cache strategy still sees a plain sequential stream. Over a
+   long distance link a single connection is bound by its round trip time,
+   several connections in flight fill the link.
+   */
+  class CRangeReader : public IRunnable
+  {
+  public:
+    CRangeReader(const std::string& path, unsigned int blockSize, unsigned int maxConnections);
+    ~CRangeReader() override;
+
+    /*! \brief Start reading at a position, drops the blocks fetched so far.
+     \param position the position of the next read
+     \param length the length of the file
+     */
+    void Seek(int64_t position, int64_t length);
+
+    /*! \brief Wait until a read will not block.
+     \param timeout time to wait in milliseconds
+     \return true if data, the end of the file or an error is ready
+     */
+    bool WaitForData(unsigned int timeout);
+
+    /*! \brief Read the next bytes in file order, waits for the block at the position.
+     \return the number of bytes read, 0 at the end of the file, -1 on error
+     */
+    ssize_t Read(char* buffer, size_t size);
+
+    /*! \brief Set the number of connections fetching blocks.
+     \param connections limited to between 1 and the maximum number of connections
+     */
+    void SetConnections(unsigned int connections);
+
+    /*! \brief Number of connections fetching blocks and the upper limit, which
+     is lowered when the server refuses more connections.
+     */
+    unsigned int GetConnections() const;
+    unsigned int GetMaxConnections() const;
+
+    void Stop();
+
+    // implementation of IRunnable
+    void Run() override;
+
+  private:
+    struct SBlock
+    {
+      int64_t start = 0;
+      std::vector<char> data;
+      size_t filled = 0;
+      unsigned int attempts = 0;
+      bool running = false;
+      bool done = false;
+      bool failed = false;
+    };
+
+    void FillWindow();
+    bool FetchBlock(SBlock& block, CFile& file, bool& opened, unsigned int generation);
+
+    std::string m_path;
+    unsigned int m_blockSize;
+    unsigned int m_maxConnections;
+    unsigned int m_connections = 1;
+    unsigned int m_running = 0;
+    unsigned int m_generation = 0; ///< increased on each seek to abandon blocks in flight
+    bool m_stop = false;
+
+    int64_t m_length = 0;
+    int64_t m_nextBlock = 0; ///< start of the next block to queue
+    size_t m_offset = 0; ///< read offset in the first block
+    std::deque<std::shared_ptr<SBlock>> m_blocks;
+
+    std::vector<std::unique_ptr<CThread>> m_threads;
+    mutable CCriticalSection m_section;
+    XbmcThreads::ConditionVariable m_queued;
+    XbmcThreads::ConditionVariable m_fetched;
+  };
+}
@@ -0,0 +1,80 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/File.h"
+#include "filesystem/RangeReader.h"
+#include "test/TestUtils.h"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+namespace
+{
+std::string LoadFile(const std::string& path)
+{
+  XUTILS::auto_buffer buffer;
+  EXPECT_GT(XFILE::CFile().LoadFile(path, buffer), 0);
+  return std::string(buffer.get(), buffer.size());
+}
+
+std::string ReadAll(XFILE::CRangeReader& reader)
+{
+  std::string data;
+  char buf[37];
+  ssize_t read;
+  while ((read = reader.Read(buf, sizeof(buf))) > 0)
+    data.append(buf, read);
+  EXPECT_EQ(0, read);
+  return data;
+}
+}
+
+TEST(TestRangeReader, ReadInOrder)
+{
+  const std::string path = XBMC_REF_FILE_PATH("/xbmc/filesystem/test/reffile.txt");
+  const std::string expected = LoadFile(path);
+  ASSERT_FALSE(expected.empty());
+
+  // blocks much smaller than the file, several fetched at once
+  XFILE::CRangeReader reader(path, 100, 4);
+  reader.SetConnections(4);
+  EXPECT_EQ(4u, reader.GetConnections());
+
+  reader.Seek(0, expected.size());
+  EXPECT_EQ(expected, ReadAll(reader));
+}
+
+TEST(TestRangeReader, Seek)
+{
+  const std::string path = XBMC_REF_FILE_PATH("/xbmc/filesystem/test/reffile.txt");
+  const std::string expected = LoadFile(path);
+  ASSERT_FALSE(expected.empty());
+
+  XFILE::CRangeReader reader(path, 64, 3);
+  reader.SetConnections(3);
+
+  char buf[10];
+  reader.Seek(0, expected.size());
+  ASSERT_EQ(10, reader.Read(buf, sizeof(buf)));
+
+  // blocks in flight are dropped, reading continues at the new position
+  reader.Seek(1000, expected.size());
+  EXPECT_TRUE(reader.WaitForData(10000));
+  EXPECT_EQ(expected.substr(1000), ReadAll(reader));
+}
+
+TEST(TestRangeReader, Connections)
+{
+  XFILE::CRangeReader reader(XBMC_REF_FILE_PATH("/xbmc/filesystem/test/reffile.txt"), 100, 2);
+  EXPECT_EQ(1u, reader.GetConnections());
+  reader.SetConnections(5);
+  EXPECT_EQ(2u, reader.GetConnections());
+  reader.SetConnections(0);
+  EXPECT_EQ(1u, reader.GetConnections());
+}
@@ -270,6 +270,8 @@
 #define ACTION_VIDEO_NEXT_STREAM      250 //!< Cycle video streams. Used in videofullscreen.
 #define ACTION_QUEUE_ITEM_NEXT        251 //!< used to queue an item to the next position in the playlist
 
+#define ACTION_PLAYER_FRAMEPACING_DUMP 252 //!< write the recorded frame presentation timings of VideoPlayer to special://temp
+
 // Voice actions
 #define ACTION_VOICE_RECOGNIZE        300
 
@@ -55,6 +55,7 @@ static const std::map<ActionName, ActionID> ActionMappings =
     { "playerdebug"              , ACTION_PLAYER_DEBUG },
     { "codecinfo"                , ACTION_PLAYER_PROCESS_INFO },
     { "playerprocessinfo"        , ACTION_PLAYER_PROCESS_INFO },
+    { "playerframepacingdump"    , ACTION_PLAYER_FRAMEPACING_DUMP },
     { "playerprogramselect"      , ACTION_PLAYER_PROGRAM_SELECT },
     { "playerresolutionselect"   , ACTION_PLAYER_RESOLUTION_SELECT },
     { "nextpicture"              , ACTION_NEXT_PICTURE },
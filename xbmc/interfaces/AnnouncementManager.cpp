@@ -20,6 +20,8 @@
 #include "PlayListPlayer.h"
 
 #define LOOKUP_PROPERTY "database-lookup"
+// time state announcements are held back to catch bursts of updates of the same state
+#define COALESCE_TIME 100
 
 using namespace ANNOUNCEMENT;
 
@@ -101,11 +103,89 @@ void CAnnouncementManager::Announce(AnnouncementFlag flag, const char *sender, c
 
   {
     CSingleLock lock (m_queueCritSection);
-    m_announcementQueue.push_back(announcement);
+    if (IsCoalescable(announcement))
+    {
+      std::string key = GetStateKey(announcement);
+      auto pending = m_pendingStateKeys.find(key);
+      if (pending != m_pendingStateKeys.end())
+      {
+        if (Coalesce(*pending->second, announcement))
+          return;
+
+        // the pending state can't take this one, deliver it first
+        FlushPendingStates(announcement.flag);
+      }
+
+      announcement.due.Set(COALESCE_TIME);
+      m_pendingStateKeys[key] = m_pendingStates.insert(m_pendingStates.end(), std::move(announcement));
+    }
+    else
+    {
+      // pending states go first, so clients still see the announcements of a
+      // namespace in order
+      FlushPendingStates(announcement.flag);
+      m_announcementQueue.push_back(std::move(announcement));
+    }
   }
   m_queueEvent.Set();
 }
 
+void CAnnouncementManager::FlushPendingStates(AnnouncementFlag flag)
+{
+  for (auto it = m_pendingStates.begin(); it != m_pendingStates.end();)
+  {
+    if (it->flag != flag)
+    {
+      ++it;
+      continue;
+    }
+    m_pendingStateKeys.erase(GetStateKey(*it));
+    m_announcementQueue.push_back(std::move(*it));
+    it = m_pendingStates.erase(it);
+  }
+}
+
+bool CAnnouncementManager::IsCoalescable(const CAnnounceData &announcement)
+{
+  return announcement.message == "OnUpdate" || announcement.message == "OnPropertyChanged";
+}
+
+std::string CAnnouncementManager::GetStateKey(const CAnnounceData &announcement)
+{
+  return StringUtils::Format("%d|%s|%s|%s", announcement.flag, announcement.sender.c_str(), announcement.message.c_str(),
+                             announcement.item != nullptr ? announcement.item->GetPath().c_str() : "");
+}
+
+bool CAnnouncementManager::Coalesce(CAnnounceData &pending, const CAnnounceData &announcement)
+{
+  if (pending.flag != announcement.flag || pending.sender != announcement.sender ||
+      pending.message != announcement.message || !IsCoalescable(pending))
+    return false;
+
+  if (announcement.message == "OnPropertyChanged")
+  {
+    const CVariant &pendingData = pending.data;
+    if (announcement.item != nullptr || pending.item != nullptr ||
+        !announcement.data["property"].isObject() || !pendingData["property"].isObject() ||
+        !(announcement.data["player"] == pendingData["player"]))
+      return false;
+
+    // the later value of each property wins
+    for (auto it = announcement.data["property"].begin_map(); it != announcement.data["property"].end_map(); ++it)
+      pending.data["property"][it->first] = it->second;
+    return true;
+  }
+
+  if ((announcement.item == nullptr) != (pending.item == nullptr) ||
+      (announcement.item != nullptr && announcement.item->GetPath() != pending.item->GetPath()) ||
+      !(announcement.data == pending.data))
+    return false;
+
+  // the later item carries the latest details
+  pending.item = announcement.item;
+  return true;
+}
+
 void CAnnouncementManager::DoAnnounce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
 {
   CLog::Log(LOGDEBUG, "CAnnouncementManager - Announcement: %s from %s", message, sender);
@@ -273,15 +353,30 @@ void CAnnouncementManager::Process()
   while (!m_bStop)
   {
     CSingleLock lock (m_queueCritSection);
+
+    // states became pending in order, so the oldest is due first
+    while (!m_pendingStates.empty() && m_pendingStates.front().due.IsTimePast())
+    {
+      m_pendingStateKeys.erase(GetStateKey(m_pendingStates.front()));
+      m_announcementQueue.push_back(std::move(m_pendingStates.front()));
+      m_pendingStates.pop_front();
+    }
+
     if (!m_announcementQueue.empty())
     {
-      auto announcement = m_announcementQueue.front();
+      auto announcement = std::move(m_announcementQueue.front());
       m_announcementQueue.pop_front();
       {
         CSingleExit ex(m_queueCritSection);
         DoAnnounce(announcement.flag, announcement.sender.c_str(), announcement.message.c_str(), announcement.item, announcement.data);
       }
     }
+    else if (!m_pendingStates.empty())
+    {
+      unsigned int left = m_pendingStates.front().due.MillisLeft();
+      CSingleExit ex(m_queueCritSection);
+      m_queueEvent.WaitMSec(left);
+    }
     else
     {
       CSingleExit ex(m_queueCritSection);
@@ -10,12 +10,15 @@
 
 #include <vector>
 #include <list>
+#include <map>
+#include <string>
 
 #include "IAnnouncer.h"
 #include "FileItem.h"
 #include "threads/CriticalSection.h"
 #include "threads/Thread.h"
 #include "threads/Event.h"
+#include "threads/SystemClock.h"
 #include "utils/Variant.h"
 
 class CVariant;
@@ -53,8 +56,30 @@ namespace ANNOUNCEMENT
       std::string message;
       CFileItemPtr item;
       CVariant data;
+      XbmcThreads::EndTime due; ///< a pending state is held back until then to catch later updates
     };
-    std::list<CAnnounceData> m_announcementQueue;
+
+    /*! \brief Whether an announcement only reports a state, so a later one of
+     the same state replaces it while both are still pending.
+     */
+    static bool IsCoalescable(const CAnnounceData &announcement);
+
+    /*! \brief Key of the state a coalescable announcement reports.
+     */
+    static std::string GetStateKey(const CAnnounceData &announcement);
+
+    /*! \brief Fold an announcement into a pending one of the same state.
+     \return true if the announcement was folded in and must not be queued
+     */
+    static bool Coalesce(CAnnounceData &pending, const CAnnounceData &announcement);
+
+    /*! \brief Queue the pending states of a namespace for delivery, oldest first.
+     */
+    void FlushPendingStates(AnnouncementFlag flag);
+
+    std::list<CAnnounceData> m_announcementQueue; ///< delivered in order without delay
+    std::list<CAnnounceData> m_pendingStates; ///< coalescable announcements, oldest first
+    std::map<std::string, std::list<CAnnounceData>::iterator> m_pendingStateKeys;
     CEvent m_queueEvent;
 
   private:
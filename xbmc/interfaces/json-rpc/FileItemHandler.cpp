@@ -178,8 +178,9 @@ void CFileItemHandler::FillDetails(const ISerializable *info, const CFileItemPtr
   if (info == NULL || fields.empty())
     return;
 
+  // only the fields still missing, a full serialization of each item is expensive for big libraries
   CVariant serialization;
-  info->Serialize(serialization);
+  info->SerializeFields(serialization, fields);
 
   bool fetchedArt = false;
 
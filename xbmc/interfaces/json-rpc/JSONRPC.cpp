@@ -6,6 +6,8 @@
  *  See LICENSES/README.md for more information.
  */
 
+#include <algorithm>
+#include <memory>
 #include <string.h>
 
 #include "JSONRPC.h"
@@ -19,6 +21,10 @@
 #include "playlists/SmartPlayList.h"
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "utils/JobManager.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 #include "utils/Variant.h"
@@ -27,6 +33,9 @@
 
 using namespace JSONRPC;
 
+// number of read only calls of a batch handled at the same time
+#define BATCH_MAX_CONCURRENCY 4
+
 bool CJSONRPC::m_initialized = false;
 
 void CJSONRPC::Initialize()
@@ -100,6 +109,9 @@ void CJSONRPC::Initialize()
   for (unsigned int index = 0; index < size; index++)
     CJSONServiceDescription::AddNotification(JSONRPC_SERVICE_NOTIFICATIONS[index]);
 
+  // resolve all referenced types once instead of on the first call of every method
+  CJSONServiceDescription::ResolveTypes();
+
   m_initialized = true;
   CLog::Log(LOGINFO, "JSONRPC v%s: Successfully initialized", CJSONServiceDescription::GetVersion());
 }
@@ -241,17 +253,7 @@ std::string CJSONRPC::MethodCall(const std::string &inputString, ITransportLayer
         hasResponse = true;
       }
       else
-      {
-        for (CVariant::const_iterator_array itr = inputroot.begin_array(); itr != inputroot.end_array(); itr++)
-        {
-          CVariant response;
-          if (HandleMethodCall(*itr, response, transport, client))
-          {
-            outputroot.append(response);
-            hasResponse = true;
-          }
-        }
-      }
+        hasResponse = HandleBatchCall(inputroot, outputroot, transport, client);
     }
     else
       hasResponse = HandleMethodCall(inputroot, outputroot, transport, client);
@@ -305,6 +307,117 @@ bool CJSONRPC::HandleMethodCall(const CVariant& request, CVariant& response, ITr
   return !isNotification;
 }
 
+bool CJSONRPC::HandleBatchCall(const CVariant& requests, CVariant& responses, ITransportLayer *transport, IClient *client)
+{
+  bool hasResponse = false;
+  std::vector<const CVariant*> readOnlyCalls;
+
+  // read only calls are handled concurrently, calls with side effects keep
+  // their order relative to each other and to the reads around them
+  CVariant::const_iterator_array itr = requests.begin_array();
+  while (itr != requests.end_array())
+  {
+    readOnlyCalls.clear();
+    for (; itr != requests.end_array() && IsReadOnlyCall(*itr); itr++)
+      readOnlyCalls.push_back(&*itr);
+
+    if (readOnlyCalls.size() > 1)
+    {
+      std::vector<CVariant> readResponses;
+      std::vector<bool> readHasResponses;
+      HandleConcurrently(readOnlyCalls, readResponses, readHasResponses, transport, client);
+
+      for (size_t i = 0; i < readResponses.size(); i++)
+      {
+        if (readHasResponses[i])
+        {
+          responses.append(readResponses[i]);
+          hasResponse = true;
+        }
+      }
+      continue;
+    }
+
+    const CVariant& request = readOnlyCalls.empty() ? *itr++ : *readOnlyCalls.front();
+    CVariant response;
+    if (HandleMethodCall(request, response, transport, client))
+    {
+      responses.append(response);
+      hasResponse = true;
+    }
+  }
+
+  return hasResponse;
+}
+
+void CJSONRPC::HandleConcurrently(const std::vector<const CVariant*>& requests, std::vector<CVariant>& responses, std::vector<bool>& hasResponses, ITransportLayer *transport, IClient *client)
+{
+  struct SCall
+  {
+    const CVariant* request;
+    CVariant response;
+    bool hasResponse = false;
+  };
+
+  struct SBatch
+  {
+    std::vector<SCall> calls;
+    size_t next = 0;
+    size_t done = 0;
+    CCriticalSection section;
+    XbmcThreads::ConditionVariable finished;
+  };
+
+  std::shared_ptr<SBatch> batch = std::make_shared<SBatch>();
+  batch->calls.resize(requests.size());
+  for (size_t i = 0; i < requests.size(); i++)
+    batch->calls[i].request = requests[i];
+
+  // every runner takes the next call until none are left. The requests are
+  // only touched while a call is running, which this thread waits for, but
+  // a runner may start late and needs the batch to still be around.
+  auto run = [batch, transport, client]() {
+    CSingleLock lock(batch->section);
+    while (batch->next < batch->calls.size())
+    {
+      SCall& call = batch->calls[batch->next++];
+      {
+        CSingleExit exit(batch->section);
+        call.hasResponse = HandleMethodCall(*call.request, call.response, transport, client);
+      }
+      batch->done++;
+    }
+    batch->finished.notifyAll();
+  };
+
+  // this thread is a runner as well, so the batch is handled even if no worker is free
+  size_t runners = std::min(requests.size(), static_cast<size_t>(BATCH_MAX_CONCURRENCY));
+  for (size_t i = 1; i < runners; i++)
+    CJobManager::GetInstance().Submit([run]() { run(); }, CJob::PRIORITY_DEDICATED);
+  run();
+
+  CSingleLock lock(batch->section);
+  while (batch->done < batch->calls.size())
+    batch->finished.wait(lock);
+
+  for (auto& call : batch->calls)
+  {
+    responses.push_back(std::move(call.response));
+    hasResponses.push_back(call.hasResponse);
+  }
+}
+
+bool CJSONRPC::IsReadOnlyCall(const CVariant& request)
+{
+  if (!IsProperJSONRPC(request))
+    return false;
+
+  std::string methodName = request["method"].asString();
+  StringUtils::ToLower(methodName);
+
+  return CJSONServiceDescription::IsReadOnly(methodName);
+}
+
 inline bool CJSONRPC::IsProperJSONRPC(const CVariant& inputroot)
 {
   return inputroot.isMember("jsonrpc") && inputroot["jsonrpc"].isString() && inputroot["jsonrpc"] == CVariant("2.0") && inputroot.isMember("method") && inputroot["method"].isString() && (!inputroot.isMember("params") || inputroot["params"].isArray() || inputroot["params"].isObject());
@@ -12,6 +12,7 @@
 #include <map>
 #include <stdio.h>
 #include <string>
+#include <vector>
 
 #include "JSONRPCUtils.h"
 #include "JSONServiceDescription.h"
@@ -63,6 +64,9 @@ namespace JSONRPC
 
   private:
     static bool HandleMethodCall(const CVariant& request, CVariant& response, ITransportLayer *transport, IClient *client);
+    static bool HandleBatchCall(const CVariant& requests, CVariant& responses, ITransportLayer *transport, IClient *client);
+    static void HandleConcurrently(const std::vector<const CVariant*>& requests, std::vector<CVariant>& responses, std::vector<bool>& hasResponses, ITransportLayer *transport, IClient *client);
+    static bool IsReadOnlyCall(const CVariant& request);
     static inline bool IsProperJSONRPC(const CVariant& inputroot);
 
     inline static void BuildResponse(const CVariant& request, JSONRPC_STATUS code, const CVariant& result, CVariant& response);
@@ -630,9 +630,23 @@ bool JSONSchemaTypeDefinition::Parse(const CVariant &value, bool isParameter /*
 
 JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &outputValue, CVariant &errorData)
 {
-  if (!name.empty())
-    errorData["name"] = name;
-  SchemaValueTypeToJson(type, errorData["type"]);
+  JSONRPC_STATUS status = checkValue(value, outputValue, errorData);
+
+  // the error data is only put together for invalid values, an extended
+  // type which failed has already described itself
+  if (status != OK)
+  {
+    if (!name.empty() && !errorData.isMember("name"))
+      errorData["name"] = name;
+    if (!errorData.isMember("type"))
+      SchemaValueTypeToJson(type, errorData["type"]);
+  }
+
+  return status;
+}
+
+JSONRPC_STATUS JSONSchemaTypeDefinition::checkValue(const CVariant &value, CVariant &outputValue, CVariant &errorData)
+{
   std::string errorMessage;
 
   if (referencedType != NULL && !referencedTypeSet)
@@ -662,7 +676,7 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
       if (unionTypes.at(unionIndex)->Check(value, testOutput, dummyError) == OK)
       {
         ok = true;
-        outputValue = testOutput;
+        outputValue = std::move(testOutput);
         break;
       }
     }
@@ -723,10 +737,12 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
       for (unsigned int arrayIndex = 0; arrayIndex < value.size(); arrayIndex++)
       {
         CVariant temp;
-        JSONRPC_STATUS status = itemType->Check(value[arrayIndex], temp, errorData["property"]);
-        outputValue.push_back(temp);
+        CVariant itemError;
+        JSONRPC_STATUS status = itemType->Check(value[arrayIndex], temp, itemError);
+        outputValue.push_back(std::move(temp));
         if (status != OK)
         {
+          errorData["property"] = std::move(itemError);
           CLog::Log(LOGDEBUG, "JSONRPC: Array element at index %u does not match in type %s", arrayIndex, name.c_str());
           errorMessage = StringUtils::Format("array element at index %u does not match", arrayIndex);
           errorData["message"] = errorMessage.c_str();
@@ -759,9 +775,11 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
       unsigned int arrayIndex;
       for (arrayIndex = 0; arrayIndex < std::min(items.size(), (size_t)value.size()); arrayIndex++)
       {
-        JSONRPC_STATUS status = items.at(arrayIndex)->Check(value[arrayIndex], outputValue[arrayIndex], errorData["property"]);
+        CVariant itemError;
+        JSONRPC_STATUS status = items.at(arrayIndex)->Check(value[arrayIndex], outputValue[arrayIndex], itemError);
         if (status != OK)
         {
+          errorData["property"] = std::move(itemError);
           CLog::Log(LOGDEBUG, "JSONRPC: Array element at index %u does not match with items schema in type %s", arrayIndex, name.c_str());
           return status;
         }
@@ -829,9 +847,11 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
     {
       if (value.isMember(propertiesIterator->second->name))
       {
-        JSONRPC_STATUS status = propertiesIterator->second->Check(value[propertiesIterator->second->name], outputValue[propertiesIterator->second->name], errorData["property"]);
+        CVariant propertyError;
+        JSONRPC_STATUS status = propertiesIterator->second->Check(value[propertiesIterator->second->name], outputValue[propertiesIterator->second->name], propertyError);
         if (status != OK)
         {
+          errorData["property"] = std::move(propertyError);
           CLog::Log(LOGDEBUG, "JSONRPC: Invalid property \"%s\" in type %s", propertiesIterator->second->name.c_str(), name.c_str());
           return status;
         }
@@ -871,9 +891,11 @@ JSONRPC_STATUS JSONSchemaTypeDefinition::Check(const CVariant &value, CVariant &
             continue;
           }
 
-          JSONRPC_STATUS status = additionalProperties->Check(value[iter->first], outputValue[iter->first], errorData["property"]);
+          CVariant propertyError;
+          JSONRPC_STATUS status = additionalProperties->Check(value[iter->first], outputValue[iter->first], propertyError);
           if (status != OK)
           {
+            errorData["property"] = std::move(propertyError);
             CLog::Log(LOGDEBUG, "JSONRPC: Invalid additional property \"%s\" in type %s", iter->first.c_str(), name.c_str());
             return status;
           }
@@ -1167,6 +1189,32 @@ void JSONSchemaTypeDefinition::Set(const JSONSchemaTypeDefinitionPtr typeDefinit
   referencedTypeSet = true;
 }
 
+void JSONSchemaTypeDefinition::Resolve(std::set<const JSONSchemaTypeDefinition*> &resolved)
+{
+  // recursive types contain themselves
+  if (!resolved.insert(this).second)
+    return;
+
+  if (referencedType != NULL && !referencedTypeSet)
+    Set(referencedType);
+
+  std::vector<JSONSchemaTypeDefinitionPtr> definitions;
+  definitions.insert(definitions.end(), extends.begin(), extends.end());
+  definitions.insert(definitions.end(), unionTypes.begin(), unionTypes.end());
+  definitions.insert(definitions.end(), items.begin(), items.end());
+  definitions.insert(definitions.end(), additionalItems.begin(), additionalItems.end());
+  for (JSONSchemaTypeDefinition::CJsonSchemaPropertiesMap::JSONSchemaPropertiesIterator property = properties.begin(); property != properties.end(); ++property)
+    definitions.push_back(property->second);
+  if (additionalProperties != NULL)
+    definitions.push_back(additionalProperties);
+
+  for (const auto& definition : definitions)
+  {
+    if (definition != NULL)
+      definition->Resolve(resolved);
+  }
+}
+
 JSONSchemaTypeDefinition::CJsonSchemaPropertiesMap::CJsonSchemaPropertiesMap() :
    m_propertiesmap(std::map<std::string, JSONSchemaTypeDefinitionPtr>())
 {
@@ -1288,7 +1336,6 @@ JSONRPC_STATUS JsonRpcMethod::Check(const CVariant &requestParameters, ITranspor
       // parameters
       unsigned int handled = 0;
       CVariant errorData = CVariant(CVariant::VariantTypeObject);
-      errorData["method"] = name;
 
       // Loop through all the parameters to check
       for (unsigned int i = 0; i < parameters.size(); i++)
@@ -1298,7 +1345,8 @@ JSONRPC_STATUS JsonRpcMethod::Check(const CVariant &requestParameters, ITranspor
         if (status != OK)
         {
           // Return the error data object in the outputParameters reference
-          outputParameters = errorData;
+          errorData["method"] = name;
+          outputParameters = std::move(errorData);
           return status;
         }
       }
@@ -1306,8 +1354,9 @@ JSONRPC_STATUS JsonRpcMethod::Check(const CVariant &requestParameters, ITranspor
       // Check if there were unnecessary parameters
       if (handled < requestParameters.size())
       {
+        errorData["method"] = name;
         errorData["message"] = "Too many parameters";
-        outputParameters = errorData;
+        outputParameters = std::move(errorData);
         return InvalidParams;
       }
 
@@ -1356,13 +1405,17 @@ JSONRPC_STATUS JsonRpcMethod::checkParameter(const CVariant &requestParameters,
   // Let's check if the parameter has been provided
   if (ParameterExists(requestParameters, type->name, position))
   {
-    // Get the parameter
-    CVariant parameterValue = GetParameter(requestParameters, type->name, position);
+    // Get the parameter without copying it
+    const CVariant &parameterValue = IsValueMember(requestParameters, type->name) ? requestParameters[type->name] : requestParameters[position];
 
     // Evaluate the type of the parameter
-    JSONRPC_STATUS status = type->Check(parameterValue, outputParameters[type->name], errorData["stack"]);
+    CVariant parameterError;
+    JSONRPC_STATUS status = type->Check(parameterValue, outputParameters[type->name], parameterError);
     if (status != OK)
+    {
+      errorData["stack"] = std::move(parameterError);
       return status;
+    }
 
     // The parameter was present and valid
     handled++;
@@ -1383,6 +1436,16 @@ JSONRPC_STATUS JsonRpcMethod::checkParameter(const CVariant &requestParameters,
   return OK;
 }
 
+void CJSONServiceDescription::ResolveTypes()
+{
+  std::set<const JSONSchemaTypeDefinition*> resolved;
+  for (CJsonRpcMethodMap::JsonRpcMethodIterator method = m_actionMap.begin(); method != m_actionMap.end(); ++method)
+  {
+    for (const auto& parameter : method->second.parameters)
+      parameter->Resolve(resolved);
+  }
+}
+
 void CJSONServiceDescription::Cleanup()
 {
   // reset all of the static data
@@ -1872,6 +1935,15 @@ JSONRPC_STATUS CJSONServiceDescription::CheckCall(const char* const method, cons
   return MethodNotFound;
 }
 
+bool CJSONServiceDescription::IsReadOnly(const std::string &method)
+{
+  CJsonRpcMethodMap::JsonRpcMethodIterator iter = m_actionMap.find(method);
+  if (iter == m_actionMap.end())
+    return false;
+
+  return iter->second.permission == ReadData;
+}
+
 JSONSchemaTypeDefinitionPtr CJSONServiceDescription::GetType(const std::string &identification)
 {
   std::map<std::string, JSONSchemaTypeDefinitionPtr>::iterator iter = m_types.find(identification);
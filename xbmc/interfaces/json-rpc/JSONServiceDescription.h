@@ -12,6 +12,7 @@
 #include <vector>
 #include <limits>
 #include <memory>
+#include <set>
 
 #include "JSONUtils.h"
 #include "utils/Variant.h"
@@ -41,6 +42,13 @@ namespace JSONRPC
     void Print(bool isParameter, bool isGlobal, bool printDefault, bool printDescriptions, CVariant &output) const;
     void Set(const JSONSchemaTypeDefinitionPtr typeDefinition);
 
+    /*!
+     \brief Resolves the referenced types of this definition and all
+     the definitions it contains ahead of the first check
+     \param resolved Definitions which have already been resolved
+     */
+    void Resolve(std::set<const JSONSchemaTypeDefinition*> &resolved);
+
     std::string missingReference;
 
     /*!
@@ -211,6 +219,9 @@ namespace JSONRPC
      \brief Type definition for additional properties
      */
     JSONSchemaTypeDefinitionPtr additionalProperties;
+
+  private:
+    JSONRPC_STATUS checkValue(const CVariant &value, CVariant &outputValue, CVariant &errorData);
   };
 
   /*!
@@ -380,8 +391,21 @@ namespace JSONRPC
      */
     static JSONRPC_STATUS CheckCall(const char* method, const CVariant &requestParameters, ITransportLayer *transport, IClient *client, bool notification, MethodCall &methodCall, CVariant &outputParameters);
 
+    /*!
+     \brief Checks whether the given method only needs the permission to read data
+     \param method Called method in lower case
+     \return True if the method exists and has no side effects
+     */
+    static bool IsReadOnly(const std::string &method);
+
     static JSONSchemaTypeDefinitionPtr GetType(const std::string &identification);
 
+    /*!
+     \brief Resolves the referenced types of all methods so calls
+     are checked without modifying the shared type definitions
+     */
+    static void ResolveTypes();
+
     static void Cleanup();
 
   private:
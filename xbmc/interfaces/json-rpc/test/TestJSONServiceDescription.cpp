@@ -0,0 +1,129 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "interfaces/json-rpc/IClient.h"
+#include "interfaces/json-rpc/ITransportLayer.h"
+#include "interfaces/json-rpc/JSONRPC.h"
+#include "interfaces/json-rpc/JSONServiceDescription.h"
+#include "utils/JSONVariantParser.h"
+#include "utils/Variant.h"
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include <gtest/gtest.h>
+
+using namespace JSONRPC;
+
+#define GET_MOVIES_PARAMETERS \
+  "{ \"properties\": [ \"title\", \"year\", \"genre\", \"rating\", \"playcount\", \"file\", \"art\", \"cast\", \"streamdetails\" ], " \
+  "\"limits\": { \"start\": 0, \"end\": 50 }, " \
+  "\"sort\": { \"method\": \"title\", \"order\": \"ascending\", \"ignorearticle\": true }, " \
+  "\"filter\": { \"field\": \"playcount\", \"operator\": \"is\", \"value\": \"0\" } }"
+
+namespace
+{
+class CTestTransport : public ITransportLayer
+{
+public:
+  bool PrepareDownload(const char* path, CVariant& details, std::string& protocol) override { return false; }
+  bool Download(const char* path, CVariant& result) override { return false; }
+  int GetCapabilities() override { return Response | Announcing; }
+};
+
+class CTestClient : public IClient
+{
+public:
+  int GetPermissionFlags() override { return OPERATION_PERMISSION_ALL; }
+  int GetAnnouncementFlags() override { return 0; }
+  bool SetAnnouncementFlags(int flags) override { return true; }
+};
+}
+
+class TestJSONServiceDescription : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    CJSONRPC::Initialize();
+  }
+
+  void TearDown() override
+  {
+    CJSONRPC::Cleanup();
+  }
+
+  JSONRPC_STATUS CheckCall(const char* method, const std::string& parameters, CVariant& outputParameters)
+  {
+    CVariant requestParameters;
+    if (!CJSONVariantParser::Parse(parameters, requestParameters))
+      return InvalidParams;
+
+    MethodCall methodCall = nullptr;
+    return CJSONServiceDescription::CheckCall(method, requestParameters, &transport, &client, false, methodCall, outputParameters);
+  }
+
+  /*! \brief Check the same call over and over and return the number of checks per second. */
+  double Benchmark(const char* method, const std::string& parameters, int calls)
+  {
+    CVariant requestParameters;
+    EXPECT_TRUE(CJSONVariantParser::Parse(parameters, requestParameters));
+
+    int failed = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < calls; i++)
+    {
+      MethodCall methodCall = nullptr;
+      CVariant outputParameters;
+      if (CJSONServiceDescription::CheckCall(method, requestParameters, &transport, &client, false, methodCall, outputParameters) != OK)
+        failed++;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(0, failed);
+    return calls / elapsed.count();
+  }
+
+  CTestTransport transport;
+  CTestClient client;
+};
+
+TEST_F(TestJSONServiceDescription, ChecksValidCall)
+{
+  CVariant outputParameters;
+  ASSERT_EQ(OK, CheckCall("VideoLibrary.GetMovies", GET_MOVIES_PARAMETERS, outputParameters));
+
+  // the checked parameters are passed on along with the defaults of the missing ones
+  EXPECT_EQ(9U, outputParameters["properties"].size());
+  EXPECT_EQ(50, outputParameters["limits"]["end"].asInteger());
+  EXPECT_STREQ("title", outputParameters["sort"]["method"].asString().c_str());
+  EXPECT_STREQ("playcount", outputParameters["filter"]["field"].asString().c_str());
+}
+
+TEST_F(TestJSONServiceDescription, RejectsInvalidCall)
+{
+  CVariant outputParameters;
+  EXPECT_EQ(InvalidParams, CheckCall("VideoLibrary.GetMovies", "{ \"properties\": [ \"nosuchproperty\" ] }", outputParameters));
+  EXPECT_EQ(InvalidParams, CheckCall("VideoLibrary.GetMovies", "{ \"limits\": { \"start\": \"zero\" } }", outputParameters));
+  EXPECT_EQ(MethodNotFound, CheckCall("VideoLibrary.GetNothing", "{}", outputParameters));
+}
+
+// Not run by default, measures the calls checked per second.
+// Run it with --gtest_also_run_disabled_tests.
+TEST_F(TestJSONServiceDescription, DISABLED_Benchmark)
+{
+  const int calls = 20000;
+
+  std::cout << "[ BENCH    ] JSONRPC.Ping: "
+            << static_cast<int>(Benchmark("JSONRPC.Ping", "{}", calls)) << " checks/s" << std::endl;
+  std::cout << "[ BENCH    ] VideoLibrary.GetMovies: "
+            << static_cast<int>(Benchmark("VideoLibrary.GetMovies", GET_MOVIES_PARAMETERS, calls)) << " checks/s" << std::endl;
+  std::cout << "[ BENCH    ] Player.Open: "
+            << static_cast<int>(Benchmark("Player.Open", "{ \"item\": { \"file\": \"/media/movie.mkv\" }, \"options\": { \"resume\": true } }", calls)) << " checks/s" << std::endl;
+}
@@ -0,0 +1,189 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "FileItem.h"
+#include "interfaces/AnnouncementManager.h"
+#include "interfaces/IAnnouncer.h"
+#include "platform/linux/XTimeUtils.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/Variant.h"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// longer than the time states are held back for
+#define SETTLE_TIME 500
+
+using namespace ANNOUNCEMENT;
+
+namespace
+{
+struct RecordedAnnouncement
+{
+  AnnouncementFlag flag;
+  std::string sender;
+  std::string message;
+  CVariant data;
+};
+
+class CRecordingAnnouncer : public IAnnouncer
+{
+public:
+  void Announce(AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data) override
+  {
+    CSingleLock lock(m_critSection);
+    m_announcements.push_back({ flag, sender, message, data });
+    m_event.Set();
+  }
+
+  /*! \brief Wait for the given number of announcements and then a while longer for any more. */
+  std::vector<RecordedAnnouncement> Wait(size_t count)
+  {
+    XbmcThreads::EndTime end(10000);
+    CSingleLock lock(m_critSection);
+    while (m_announcements.size() < count && !end.IsTimePast())
+    {
+      CSingleExit ex(m_critSection);
+      m_event.WaitMSec(100);
+    }
+
+    {
+      CSingleExit ex(m_critSection);
+      Sleep(SETTLE_TIME);
+    }
+    return m_announcements;
+  }
+
+private:
+  CCriticalSection m_critSection;
+  CEvent m_event;
+  std::vector<RecordedAnnouncement> m_announcements;
+};
+}
+
+class TestAnnouncementManager : public testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    manager.AddAnnouncer(&announcer);
+    manager.Start();
+  }
+
+  void TearDown() override
+  {
+    manager.Deinitialize();
+  }
+
+  static CVariant PropertyChanged(int playerId, const std::string &property, const CVariant &value)
+  {
+    CVariant data;
+    data["player"]["playerid"] = playerId;
+    data["property"][property] = value;
+    return data;
+  }
+
+  static std::shared_ptr<const CFileItem> Item(const std::string &path)
+  {
+    return std::make_shared<CFileItem>(path, false);
+  }
+
+  CAnnouncementManager manager;
+  CRecordingAnnouncer announcer;
+};
+
+TEST_F(TestAnnouncementManager, MergesPropertyChangesOfAPlayer)
+{
+  manager.Announce(Player, "xbmc", "OnPropertyChanged", PropertyChanged(1, "speed", 1));
+  manager.Announce(Player, "xbmc", "OnPropertyChanged", PropertyChanged(1, "shuffled", true));
+  manager.Announce(Player, "xbmc", "OnPropertyChanged", PropertyChanged(1, "speed", 2));
+
+  // the later value of each property wins
+  auto announcements = announcer.Wait(1);
+  ASSERT_EQ(1U, announcements.size());
+  EXPECT_STREQ("OnPropertyChanged", announcements[0].message.c_str());
+  EXPECT_EQ(1, announcements[0].data["player"]["playerid"].asInteger());
+  EXPECT_EQ(2, announcements[0].data["property"]["speed"].asInteger());
+  EXPECT_TRUE(announcements[0].data["property"]["shuffled"].asBoolean());
+}
+
+TEST_F(TestAnnouncementManager, KeepsPropertyChangesOfPlayersApart)
+{
+  manager.Announce(Player, "xbmc", "OnPropertyChanged", PropertyChanged(0, "speed", 1));
+  manager.Announce(Player, "xbmc", "OnPropertyChanged", PropertyChanged(1, "speed", 2));
+
+  // the second change can't be merged, the first one is delivered before it
+  auto announcements = announcer.Wait(2);
+  ASSERT_EQ(2U, announcements.size());
+  EXPECT_EQ(0, announcements[0].data["player"]["playerid"].asInteger());
+  EXPECT_EQ(1, announcements[0].data["property"]["speed"].asInteger());
+  EXPECT_EQ(1, announcements[1].data["player"]["playerid"].asInteger());
+  EXPECT_EQ(2, announcements[1].data["property"]["speed"].asInteger());
+}
+
+TEST_F(TestAnnouncementManager, FlushesPendingStatesOfTheNamespaceFirst)
+{
+  manager.Announce(Player, "xbmc", "OnPropertyChanged", PropertyChanged(1, "speed", 1));
+  manager.Announce(Player, "xbmc", "OnPlay");
+
+  // clients see the announcements of a namespace in order
+  auto announcements = announcer.Wait(2);
+  ASSERT_EQ(2U, announcements.size());
+  EXPECT_STREQ("OnPropertyChanged", announcements[0].message.c_str());
+  EXPECT_STREQ("OnPlay", announcements[1].message.c_str());
+}
+
+TEST_F(TestAnnouncementManager, DoesNotHoldBackOtherNamespaces)
+{
+  manager.Announce(VideoLibrary, "xbmc", "OnUpdate", Item("/movies/movie.mkv"));
+  manager.Announce(Player, "xbmc", "OnPlay");
+
+  // the pending state of another namespace doesn't delay the announcement
+  auto announcements = announcer.Wait(2);
+  ASSERT_EQ(2U, announcements.size());
+  EXPECT_EQ(Player, announcements[0].flag);
+  EXPECT_STREQ("OnPlay", announcements[0].message.c_str());
+  EXPECT_EQ(VideoLibrary, announcements[1].flag);
+  EXPECT_STREQ("OnUpdate", announcements[1].message.c_str());
+}
+
+TEST_F(TestAnnouncementManager, DeliversPendingStatesOldestFirst)
+{
+  manager.Announce(AudioLibrary, "xbmc", "OnUpdate", Item("/music/song.mp3"));
+  manager.Announce(VideoLibrary, "xbmc", "OnUpdate", Item("/movies/movie.mkv"));
+  manager.Announce(AudioLibrary, "xbmc", "OnUpdate", Item("/music/song.mp3"));
+
+  // the repeated update is folded into the first one and keeps its place
+  auto announcements = announcer.Wait(2);
+  ASSERT_EQ(2U, announcements.size());
+  EXPECT_EQ(AudioLibrary, announcements[0].flag);
+  EXPECT_EQ(VideoLibrary, announcements[1].flag);
+}
+
+TEST_F(TestAnnouncementManager, DoesNotFoldUpdatesOfDistinctItemsOrData)
+{
+  CVariant watched;
+  watched["playcount"] = 1;
+
+  manager.Announce(VideoLibrary, "xbmc", "OnUpdate", Item("/movies/first.mkv"));
+  manager.Announce(VideoLibrary, "xbmc", "OnUpdate", Item("/movies/second.mkv"));
+  manager.Announce(VideoLibrary, "xbmc", "OnUpdate", Item("/movies/first.mkv"), watched);
+
+  // only identical updates of the same item are folded
+  auto announcements = announcer.Wait(3);
+  ASSERT_EQ(3U, announcements.size());
+  EXPECT_FALSE(announcements[0].data.isMember("playcount"));
+  EXPECT_FALSE(announcements[1].data.isMember("playcount"));
+  EXPECT_EQ(1, announcements[2].data["playcount"].asInteger());
+}
@@ -12,6 +12,7 @@
 
 #include "ServiceBroker.h"
 #include "dialogs/GUIDialogProgress.h"
+#include "filesystem/MultiPathDirectory.h"
 #include "guilib/GUIComponent.h"
 #include "guilib/GUIWindowManager.h"
 #include "GUIUserMessages.h"
@@ -122,6 +123,17 @@ void CMusicLibraryQueue::ScanLibrary(const std::string& strDirectory, int flags
   AddJob(new CMusicLibraryScanningJob(strDirectory, flags, showProgress));
 }
 
+void CMusicLibraryQueue::ScanChangedPaths(const std::set<std::string>& directories, int flags /* = 0 */)
+{
+  if (directories.empty())
+    return;
+
+  std::string directory = directories.size() == 1 ? *directories.begin()
+                                                  : XFILE::CMultiPathDirectory::ConstructMultiPath(directories);
+  flags |= MUSIC_INFO::CMusicInfoScanner::SCAN_CHANGED | MUSIC_INFO::CMusicInfoScanner::SCAN_BACKGROUND;
+  AddJob(new CMusicLibraryScanningJob(directory, flags, false));
+}
+
 void CMusicLibraryQueue::StartAlbumScan(const std::string & strDirectory, bool refresh)
 {
   int flags = MUSIC_INFO::CMusicInfoScanner::SCAN_ALBUMS;
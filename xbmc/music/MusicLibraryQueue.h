@@ -58,6 +58,15 @@ public:
    */
   void ScanLibrary(const std::string& strDirectory, int flags = 0, bool showProgress = true);
 
+  /*!
+   \brief Enqueue a background scan of directories known to have changed.
+   Only the given directories and subdirectories not yet in the library are scanned,
+   unchanged subdirectories are not walked.
+   \param[in] directories Changed directories
+   \param[in] flags Additional flags for the scanning process, e.g. SCAN_ONLINE
+   */
+  void ScanChangedPaths(const std::set<std::string>& directories, int flags = 0);
+
   /*!
    \brief Enqueue an album scraping job fetching additional album data.
    \param[in] strDirectory Virtual path that identifies which albums to process or "" (empty string) for all albums
@@ -9,11 +9,16 @@
 #include "MusicInfoScanner.h"
 
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
 #include <utility>
+#include <vector>
 
 #include "ServiceBroker.h"
 #include "addons/AddonManager.h"
 #include "addons/AddonSystemSettings.h"
+#include "addons/AudioDecoder.h"
 #include "addons/Scraper.h"
 #include "dialogs/GUIDialogExtendedProgressBar.h"
 #include "dialogs/GUIDialogProgress.h"
@@ -26,6 +31,7 @@
 #include "filesystem/File.h"
 #include "filesystem/MusicDatabaseDirectory.h"
 #include "filesystem/MusicDatabaseDirectory/DirectoryNode.h"
+#include "filesystem/MultiPathDirectory.h"
 #include "filesystem/SmartPlaylistDirectory.h"
 #include "GUIInfoManager.h"
 #include "guilib/GUIComponent.h"
@@ -46,6 +52,9 @@
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
 #include "TextureCache.h"
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
 #include "threads/SystemClock.h"
 #include "Util.h"
 #include "utils/Digest.h"
@@ -62,6 +71,143 @@ using namespace MUSIC_GRABBER;
 using namespace ADDON;
 using KODI::UTILITY::CDigest;
 
+namespace
+{
+// tags of a folder are read by this many threads, hides the round trip
+// time of network shares where every open and read waits on the server
+const unsigned int MAX_CONCURRENT_TAG_READS = 4;
+
+// audio decoder add-ons are free to keep global state in their library,
+// only one of their instances is created and used at a time
+CCriticalSection audioDecoderSection;
+}
+
+namespace MUSIC_INFO
+{
+/*!
+ \brief Loads music tags with a pool of threads that lives for the whole scan.
+ The thread calling Read takes part, items are handed out in order through an
+ atomic index.
+ */
+class CTagReader : public IRunnable
+{
+public:
+  CTagReader(const std::atomic<bool>& stop, unsigned int threads) : m_stop(stop)
+  {
+    for (unsigned int i = 1; i < threads; i++)
+    {
+      m_workers.emplace_back(new CThread(this, "MusicTagReader"));
+      m_workers.back()->Create();
+    }
+  }
+
+  ~CTagReader() override
+  {
+    {
+      CSingleLock lock(m_section);
+      m_quit = true;
+    }
+    m_work.notifyAll();
+
+    for (auto& worker : m_workers)
+      worker->StopThread(true);
+  }
+
+  /*!
+   \brief Loads the tags of the items that have none yet
+   \param items the items to read, their tags must exist already
+   \param shared false reads on the calling thread only
+   \param progress called on the calling thread with the number of items done
+   */
+  void Read(const std::vector<CFileItemPtr>& items, bool shared, const std::function<void(size_t)>& progress)
+  {
+    {
+      CSingleLock lock(m_section);
+      m_items = &items;
+      m_shared = shared;
+      m_next = 0;
+      m_done = 0;
+    }
+    if (shared)
+      m_work.notifyAll();
+
+    for (size_t i = m_next++; i < items.size() && !m_stop; i = m_next++)
+    {
+      Load(*items[i]);
+      progress(++m_done);
+    }
+
+    CSingleLock lock(m_section);
+    while (m_busy > 0)
+    {
+      m_finished.wait(lock);
+      size_t done = m_done;
+      CSingleExit exit(m_section);
+      progress(done);
+    }
+    m_items = nullptr;
+  }
+
+  void Run() override
+  {
+    CSingleLock lock(m_section);
+    while (!m_quit)
+    {
+      if (!m_items || !m_shared || m_next >= m_items->size() || m_stop)
+      {
+        m_work.wait(lock);
+        continue;
+      }
+
+      const std::vector<CFileItemPtr>& items = *m_items;
+      m_busy++;
+      {
+        CSingleExit exit(m_section);
+        for (size_t i = m_next++; i < items.size() && !m_stop; i = m_next++)
+        {
+          Load(*items[i]);
+          m_done++;
+          m_finished.notifyAll();
+        }
+      }
+      m_busy--;
+      m_finished.notifyAll();
+    }
+  }
+
+private:
+  static void Load(CFileItem& item)
+  {
+    CMusicInfoTag& tag = *item.GetMusicInfoTag();
+    if (tag.Loaded())
+      return;
+
+    // add-on loaders are created, used and destroyed under the lock, it's
+    // released right away for all others
+    CSingleLock lock(audioDecoderSection);
+    std::unique_ptr<IMusicInfoTagLoader> pLoader(CMusicInfoTagLoaderFactory::CreateLoader(item));
+    if (dynamic_cast<CAudioDecoder*>(pLoader.get()) == nullptr)
+      lock.Leave();
+
+    if (pLoader)
+      pLoader->Load(item.GetPath(), tag);
+  }
+
+  const std::atomic<bool>& m_stop;
+  std::vector<std::unique_ptr<CThread>> m_workers;
+
+  CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_work;
+  XbmcThreads::ConditionVariable m_finished;
+  const std::vector<CFileItemPtr>* m_items = nullptr; //!< guarded by m_section
+  bool m_shared = false; //!< guarded by m_section
+  bool m_quit = false; //!< guarded by m_section
+  int m_busy = 0; //!< helper threads reading, guarded by m_section
+  std::atomic<size_t> m_next{0};
+  std::atomic<size_t> m_done{0};
+};
+}
+
 CMusicInfoScanner::CMusicInfoScanner()
 : m_fileCountReader(this, "MusicFileCounter")
 {
@@ -111,6 +257,9 @@ void CMusicInfoScanner::Process()
       // Reset progress vars
       m_currentItem=0;
       m_itemCount=-1;
+      m_filesRead = 0;
+
+      m_tagReader.reset(new CTagReader(m_bStop, MAX_CONCURRENT_TAG_READS));
 
       // Create the thread to count all files to be scanned
       if (m_handle)
@@ -138,6 +287,9 @@ void CMusicInfoScanner::Process()
           continue;
         }
 
+        if (m_flags & SCAN_CHANGED)
+          m_idSourcePath = m_musicDatabase.GetSourceFromPath(*it);
+
         // Clear list of albums added by this scan
         m_albumsAdded.clear();
         bool scancomplete = DoScan(*it);
@@ -184,11 +336,14 @@ void CMusicInfoScanner::Process()
       }
 
       m_fileCountReader.StopThread();
+      m_tagReader.reset();
 
       m_musicDatabase.EmptyCache();
 
       tick = XbmcThreads::SystemClockMillis() - tick;
       CLog::Log(LOGNOTICE, "My Music: Scanning for music info using worker thread, operation took %s", StringUtils::SecondsToTimeString(tick / 1000).c_str());
+      if (tick > 0)
+        CLog::Log(LOGNOTICE, "My Music: Read tags of %u files, %.1f files/s", m_filesRead, m_filesRead * 1000.0 / tick);
     }
     if (m_scanType == 1) // load album info
     {
@@ -297,6 +452,13 @@ void CMusicInfoScanner::Start(const std::string& strDirectory, int flags)
     m_musicDatabase.GetPaths(m_pathsToScan);
     m_idSourcePath = -1;
   }
+  else if ((flags & SCAN_CHANGED) && URIUtils::IsMultiPath(strDirectory))
+  { // set of changed folders, the source is looked up per folder
+    std::vector<std::string> paths;
+    CMultiPathDirectory::GetPaths(strDirectory, paths);
+    m_pathsToScan.insert(paths.begin(), paths.end());
+    m_idSourcePath = -1;
+  }
   else
   {
     m_pathsToScan.insert(strDirectory);    
@@ -540,6 +702,11 @@ bool CMusicInfoScanner::DoScan(const std::string& strDirectory)
     if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList())
     {
       std::string strPath=pItem->GetPath();
+      // known subfolders have their own change notification
+      std::string subHash;
+      if ((m_flags & SCAN_CHANGED) && m_musicDatabase.GetPathHash(strPath, subHash))
+        continue;
+
       if (!DoScan(strPath))
       {
         m_bStop = true;
@@ -554,11 +721,9 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
 {
   std::vector<std::string> regexps = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_audioExcludeFromScanRegExps;
 
+  std::vector<CFileItemPtr> tagItems;
   for (int i = 0; i < items.Size(); ++i)
   {
-    if (m_bStop)
-      return INFO_CANCELLED;
-
     CFileItemPtr pItem = items[i];
 
     if (CUtil::ExcludeFileOrFolder(pItem->GetPath(), regexps))
@@ -567,18 +732,28 @@ CInfoScanner::INFO_RET CMusicInfoScanner::ScanTags(const CFileItemList& items,
     if (pItem->m_bIsFolder || pItem->IsPlayList() || pItem->IsPicture() || pItem->IsLyrics())
       continue;
 
-    m_currentItem++;
-
-    CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
-    if (!tag.Loaded())
-    {
-      std::unique_ptr<IMusicInfoTagLoader> pLoader (CMusicInfoTagLoaderFactory::CreateLoader(*pItem));
-      if (NULL != pLoader.get())
-        pLoader->Load(pItem->GetPath(), tag);
-    }
+    // create the tag here, the readers only fill it
+    pItem->GetMusicInfoTag();
+    tagItems.push_back(pItem);
+  }
 
+  // optical drives are read one file at a time to avoid seeking back and forth
+  bool optical = !tagItems.empty() && (tagItems.front()->IsCDDA() || tagItems.front()->IsOnDVD());
+  int firstItem = m_currentItem;
+  m_tagReader->Read(tagItems, !optical, [this, firstItem](size_t done)
+  {
+    m_currentItem = firstItem + static_cast<int>(done);
     if (m_handle && m_itemCount>0)
       m_handle->SetPercentage(static_cast<float>(m_currentItem * 100) / static_cast<float>(m_itemCount));
+  });
+  m_filesRead += static_cast<unsigned int>(tagItems.size());
+
+  if (m_bStop)
+    return INFO_CANCELLED;
+
+  for (const auto& pItem : tagItems)
+  {
+    CMusicInfoTag& tag = *pItem->GetMusicInfoTag();
 
     if (!tag.Loaded() && !pItem->HasCueDocument())
     {
@@ -15,12 +15,16 @@
 #include "threads/Thread.h"
 #include "threads/IRunnable.h"
 
+#include <atomic>
+#include <memory>
+
 class CAlbum;
 class CArtist;
 class CGUIDialogProgressBarHandle;
 
 namespace MUSIC_INFO
 {
+class CTagReader;
 
 class CMusicInfoScanner : public IRunnable, public CInfoScanner
 {
@@ -32,7 +36,8 @@ public:
                     SCAN_BACKGROUND = 1 << 1,
                     SCAN_RESCAN     = 1 << 2,
                     SCAN_ARTISTS    = 1 << 3,
-                    SCAN_ALBUMS     = 1 << 4 };
+                    SCAN_ALBUMS     = 1 << 4,
+                    SCAN_CHANGED    = 1 << 5 }; ///< only scan the given (multi)path and its new subfolders
 
   CMusicInfoScanner();
   ~CMusicInfoScanner() override;
@@ -227,7 +232,9 @@ protected:
 
   int m_currentItem;
   int m_itemCount;
-  bool m_bStop;
+  unsigned int m_filesRead = 0; //!< files whose tags were read by the current scan
+  std::unique_ptr<CTagReader> m_tagReader; //!< reads tags during a scan of files
+  std::atomic<bool> m_bStop;
   bool m_needsCleanup = false;
   int m_scanType = 0; // 0 - load from files, 1 - albums, 2 - artists
   int m_idSourcePath;
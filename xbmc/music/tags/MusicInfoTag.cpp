@@ -676,69 +676,80 @@ void CMusicInfoTag::SetSong(const CSong& song)
 
 void CMusicInfoTag::Serialize(CVariant& value) const
 {
-  value["url"] = m_strURL;
-  value["title"] = m_strTitle;
-  if (m_type.compare(MediaTypeArtist) == 0 && m_artist.size() == 1)
-    value["artist"] = m_artist[0];
-  else
-    value["artist"] = m_artist;
-  // There are situations where the individual artist(s) are not queried from the song_artist and artist tables e.g. playlist,
-  // only artist description from song table. Since processing of the ARTISTS tag was added the individual artists may not always
-  // be accurately derived by simply splitting the artist desc. Hence m_artist is only populated when the individual artists are
-  // queried, whereas GetArtistString() will always return the artist description.
-  // To avoid empty artist array in JSON, when m_artist is empty then an attempt is made to split the artist desc into artists.
-  // A longer term solution would be to ensure that when individual artists are to be returned then the song_artist and artist tables
-  // are queried.
-  if (m_artist.empty())
-    value["artist"] = StringUtils::Split(GetArtistString(), CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_musicItemSeparator);
-
-  value["displayartist"] = GetArtistString();
-  value["displayalbumartist"] = GetAlbumArtistString();
-  value["sortartist"] = GetArtistSort();
-  value["album"] = m_strAlbum;
-  value["albumartist"] = m_albumArtist;
-  value["sortalbumartist"] = m_strAlbumArtistSort;
-  value["genre"] = m_genre;
-  value["duration"] = m_iDuration;
-  value["track"] = GetTrackNumber();
-  value["disc"] = GetDiscNumber();
-  value["loaded"] = m_bLoaded;
-  value["year"] = m_dwReleaseDate.wYear;
-  value["musicbrainztrackid"] = m_strMusicBrainzTrackID;
-  value["musicbrainzartistid"] = m_musicBrainzArtistID;
-  value["musicbrainzalbumid"] = m_strMusicBrainzAlbumID;
-  value["musicbrainzreleasegroupid"] = m_strMusicBrainzReleaseGroupID;
-  value["musicbrainzalbumartistid"] = m_musicBrainzAlbumArtistID;
-  value["comment"] = m_strComment;
-  value["contributors"] = CVariant(CVariant::VariantTypeArray);
-  for (const auto& role : m_musicRoles)
+  CMusicInfoTag::SerializeFields(value, std::set<std::string>());
+}
+
+void CMusicInfoTag::SerializeFields(CVariant& value, const std::set<std::string>& fields) const
+{
+  if (IsWanted(fields, "url")) value["url"] = m_strURL;
+  if (IsWanted(fields, "title")) value["title"] = m_strTitle;
+  if (IsWanted(fields, "artist"))
   {
-    CVariant contributor;
-    contributor["name"] = role.GetArtist();
-    contributor["role"] = role.GetRoleDesc();
-    contributor["roleid"] = role.GetRoleId();
-    contributor["artistid"] = (int)(role.GetArtistId());
-    value["contributors"].push_back(contributor);
+    if (m_type.compare(MediaTypeArtist) == 0 && m_artist.size() == 1)
+      value["artist"] = m_artist[0];
+    else
+      value["artist"] = m_artist;
+    // There are situations where the individual artist(s) are not queried from the song_artist and artist tables e.g. playlist,
+    // only artist description from song table. Since processing of the ARTISTS tag was added the individual artists may not always
+    // be accurately derived by simply splitting the artist desc. Hence m_artist is only populated when the individual artists are
+    // queried, whereas GetArtistString() will always return the artist description.
+    // To avoid empty artist array in JSON, when m_artist is empty then an attempt is made to split the artist desc into artists.
+    // A longer term solution would be to ensure that when individual artists are to be returned then the song_artist and artist tables
+    // are queried.
+    if (m_artist.empty())
+      value["artist"] = StringUtils::Split(GetArtistString(), CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_musicItemSeparator);
+  }
+
+  if (IsWanted(fields, "displayartist")) value["displayartist"] = GetArtistString();
+  if (IsWanted(fields, "displayalbumartist")) value["displayalbumartist"] = GetAlbumArtistString();
+  if (IsWanted(fields, "sortartist")) value["sortartist"] = GetArtistSort();
+  if (IsWanted(fields, "album")) value["album"] = m_strAlbum;
+  if (IsWanted(fields, "albumartist")) value["albumartist"] = m_albumArtist;
+  if (IsWanted(fields, "sortalbumartist")) value["sortalbumartist"] = m_strAlbumArtistSort;
+  if (IsWanted(fields, "genre")) value["genre"] = m_genre;
+  if (IsWanted(fields, "duration")) value["duration"] = m_iDuration;
+  if (IsWanted(fields, "track")) value["track"] = GetTrackNumber();
+  if (IsWanted(fields, "disc")) value["disc"] = GetDiscNumber();
+  if (IsWanted(fields, "loaded")) value["loaded"] = m_bLoaded;
+  if (IsWanted(fields, "year")) value["year"] = m_dwReleaseDate.wYear;
+  if (IsWanted(fields, "musicbrainztrackid")) value["musicbrainztrackid"] = m_strMusicBrainzTrackID;
+  if (IsWanted(fields, "musicbrainzartistid")) value["musicbrainzartistid"] = m_musicBrainzArtistID;
+  if (IsWanted(fields, "musicbrainzalbumid")) value["musicbrainzalbumid"] = m_strMusicBrainzAlbumID;
+  if (IsWanted(fields, "musicbrainzreleasegroupid")) value["musicbrainzreleasegroupid"] = m_strMusicBrainzReleaseGroupID;
+  if (IsWanted(fields, "musicbrainzalbumartistid")) value["musicbrainzalbumartistid"] = m_musicBrainzAlbumArtistID;
+  if (IsWanted(fields, "comment")) value["comment"] = m_strComment;
+  if (IsWanted(fields, "contributors"))
+  {
+    value["contributors"] = CVariant(CVariant::VariantTypeArray);
+    for (const auto& role : m_musicRoles)
+    {
+      CVariant contributor;
+      contributor["name"] = role.GetArtist();
+      contributor["role"] = role.GetRoleDesc();
+      contributor["roleid"] = role.GetRoleId();
+      contributor["artistid"] = (int)(role.GetArtistId());
+      value["contributors"].push_back(contributor);
+    }
   }
-  value["displaycomposer"] = GetArtistStringForRole("composer");   //TCOM
-  value["displayconductor"] = GetArtistStringForRole("conductor"); //TPE3
-  value["displayorchestra"] = GetArtistStringForRole("orchestra");
-  value["displaylyricist"] = GetArtistStringForRole("lyricist");   //TEXT
-  value["mood"] = StringUtils::Split(m_strMood, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_musicItemSeparator);
-  value["recordlabel"] = m_strRecordLabel;
-  value["rating"] = m_Rating;
-  value["userrating"] = m_Userrating;
-  value["votes"] = m_Votes;
-  value["playcount"] = m_iTimesPlayed;
-  value["lastplayed"] = m_lastPlayed.IsValid() ? m_lastPlayed.GetAsDBDateTime() : StringUtils::Empty;
-  value["dateadded"] = m_dateAdded.IsValid() ? m_dateAdded.GetAsDBDateTime() : StringUtils::Empty;
-  value["lyrics"] = m_strLyrics;
-  value["albumid"] = m_iAlbumId;
-  value["compilationartist"] = m_bCompilation;
-  value["compilation"] = m_bCompilation;
-  if (m_type.compare(MediaTypeAlbum) == 0)
+  if (IsWanted(fields, "displaycomposer")) value["displaycomposer"] = GetArtistStringForRole("composer");   //TCOM
+  if (IsWanted(fields, "displayconductor")) value["displayconductor"] = GetArtistStringForRole("conductor"); //TPE3
+  if (IsWanted(fields, "displayorchestra")) value["displayorchestra"] = GetArtistStringForRole("orchestra");
+  if (IsWanted(fields, "displaylyricist")) value["displaylyricist"] = GetArtistStringForRole("lyricist");   //TEXT
+  if (IsWanted(fields, "mood")) value["mood"] = StringUtils::Split(m_strMood, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_musicItemSeparator);
+  if (IsWanted(fields, "recordlabel")) value["recordlabel"] = m_strRecordLabel;
+  if (IsWanted(fields, "rating")) value["rating"] = m_Rating;
+  if (IsWanted(fields, "userrating")) value["userrating"] = m_Userrating;
+  if (IsWanted(fields, "votes")) value["votes"] = m_Votes;
+  if (IsWanted(fields, "playcount")) value["playcount"] = m_iTimesPlayed;
+  if (IsWanted(fields, "lastplayed")) value["lastplayed"] = m_lastPlayed.IsValid() ? m_lastPlayed.GetAsDBDateTime() : StringUtils::Empty;
+  if (IsWanted(fields, "dateadded")) value["dateadded"] = m_dateAdded.IsValid() ? m_dateAdded.GetAsDBDateTime() : StringUtils::Empty;
+  if (IsWanted(fields, "lyrics")) value["lyrics"] = m_strLyrics;
+  if (IsWanted(fields, "albumid")) value["albumid"] = m_iAlbumId;
+  if (IsWanted(fields, "compilationartist")) value["compilationartist"] = m_bCompilation;
+  if (IsWanted(fields, "compilation")) value["compilation"] = m_bCompilation;
+  if (m_type.compare(MediaTypeAlbum) == 0 && IsWanted(fields, "releasetype"))
     value["releasetype"] = CAlbum::ReleaseTypeToString(m_albumReleaseType);
-  else if (m_type.compare(MediaTypeSong) == 0)
+  else if (m_type.compare(MediaTypeSong) == 0 && IsWanted(fields, "albumreleasetype"))
     value["albumreleasetype"] = CAlbum::ReleaseTypeToString(m_albumReleaseType);
 }
 
@@ -162,6 +162,7 @@ public:
 
   void Archive(CArchive& ar) override;
   void Serialize(CVariant& ar) const override;
+  void SerializeFields(CVariant& value, const std::set<std::string>& fields) const override;
   void ToSortable(SortItem& sortable, Field field) const override;
 
   void Clear();
@@ -10,10 +10,18 @@
 #include "filesystem/File.h"
 #include <taglib/tiostream.h>
 
+#include <algorithm>
+
 using namespace XFILE;
 using namespace TagLib;
 using namespace MUSIC_INFO;
 
+// Most tags are at the start of a file (ID3v2, FLAC, Vorbis, MP4 with the moov
+// atom first), ID3v1 and APE tags at its end. Each region is read with a single
+// request, on network shares every small read of TagLib costs a round trip.
+#define TAG_HEAD_SIZE (64 * 1024)
+#define TAG_TAIL_SIZE (8 * 1024)
+
 /*!
  * Construct a File object and opens the \a file.  \a file should be a
  * be an XBMC Vfile.
@@ -33,6 +41,16 @@ TagLibVFSStream::TagLibVFSStream(const std::string& strFileName, bool readOnly)
   }
   m_strFileName = strFileName;
   m_bIsReadOnly = readOnly || !m_bIsOpen;
+
+  if (readOnly && m_bIsOpen)
+  {
+    int64_t length = m_file.GetLength();
+    if (length > 0 && length <= LONG_MAX)
+    {
+      m_length = static_cast<long>(length);
+      m_bReadAhead = true;
+    }
+  }
 }
 
 /*!
@@ -56,6 +74,28 @@ FileName TagLibVFSStream::name() const
  */
 ByteVector TagLibVFSStream::readBlock(TagLib::ulong length)
 {
+  if (m_bReadAhead)
+  {
+    // take what the tag regions hold and read the rest from the file
+    ByteVector byteVector = readTagRegion(m_position, length);
+    long position = m_position + byteVector.size();
+    if (byteVector.size() < length && position < m_length)
+    {
+      ByteVector rest(static_cast<TagLib::uint>(length - byteVector.size()));
+      if (m_file.GetPosition() != position)
+        m_file.Seek(position, SEEK_SET);
+      ssize_t read = m_file.Read(rest.data(), rest.size());
+      if (read > 0)
+      {
+        rest.resize(read);
+        byteVector.append(rest);
+      }
+    }
+
+    m_position += byteVector.size();
+    return byteVector;
+  }
+
   ByteVector byteVector(static_cast<TagLib::uint>(length));
   ssize_t read = m_file.Read(byteVector.data(), length);
   if (read > 0)
@@ -66,6 +106,44 @@ ByteVector TagLibVFSStream::readBlock(TagLib::ulong length)
   return byteVector;
 }
 
+ByteVector TagLibVFSStream::readTagRegion(long position, TagLib::ulong length)
+{
+  ByteVector* region;
+  bool* regionRead;
+  long start;
+  if (position < TAG_HEAD_SIZE)
+  {
+    region = &m_head;
+    regionRead = &m_bHeadRead;
+    start = 0;
+  }
+  else if (position >= m_length - TAG_TAIL_SIZE && position < m_length)
+  {
+    region = &m_tail;
+    regionRead = &m_bTailRead;
+    start = m_length - TAG_TAIL_SIZE;
+  }
+  else
+    return ByteVector();
+
+  // a region is only read once, if that fails everything is read from the file
+  if (!*regionRead)
+  {
+    *regionRead = true;
+    long size = std::min<long>(region == &m_head ? TAG_HEAD_SIZE : TAG_TAIL_SIZE, m_length - start);
+    region->resize(static_cast<TagLib::uint>(size));
+    if (m_file.Seek(start, SEEK_SET) != start ||
+        m_file.Read(region->data(), size) != static_cast<ssize_t>(size))
+      region->clear();
+  }
+
+  long offset = position - start;
+  if (offset >= static_cast<long>(region->size()))
+    return ByteVector();
+
+  return region->mid(static_cast<TagLib::uint>(offset), static_cast<TagLib::uint>(std::min<TagLib::ulong>(length, region->size() - offset)));
+}
+
 /*!
  * Attempts to write the block \a data at the current get pointer.  If the
  * file is currently only opened read only -- i.e. readOnly() returns true --
@@ -236,6 +314,25 @@ bool TagLibVFSStream::isOpen() const
  */
 void TagLibVFSStream::seek(long offset, Position p)
 {
+  if (m_bReadAhead)
+  {
+    // the file is only moved to the position when a read goes past the tag regions
+    long position;
+    if (p == Beginning)
+      position = offset;
+    else if (p == Current)
+      position = m_position + offset;
+    else if (p == End)
+      position = m_length + offset;
+    else
+      return; // wrong Position value
+
+    // broken files may make taglib seek outside the file, keep the position
+    // within it so the same part isn't parsed over and over
+    m_position = std::max(0L, std::min(position, m_length));
+    return;
+  }
+
   const long fileLen = length();
   if (m_bIsReadOnly && fileLen > 0)
   {
@@ -294,6 +391,9 @@ void TagLibVFSStream::clear()
  */
 long TagLibVFSStream::tell() const
 {
+  if (m_bReadAhead)
+    return m_position;
+
   int64_t pos = m_file.GetPosition();
   if(pos > LONG_MAX)
     return -1;
@@ -306,6 +406,9 @@ long TagLibVFSStream::tell() const
  */
 long TagLibVFSStream::length()
 {
+  if (m_bReadAhead)
+    return m_length;
+
   return (long)m_file.GetLength();
 }
 
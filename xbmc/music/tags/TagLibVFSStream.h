@@ -112,10 +112,25 @@ namespace MUSIC_INFO
     static TagLib::uint bufferSize() { return 1024; };
 
   private:
+    /*!
+     * Returns the bytes at \a position up to \a length from the tag region at
+     * the start or the end of a read only file, reading the region on first use.
+     * The result is shorter than \a length where the region ends.
+     */
+    TagLib::ByteVector readTagRegion(long position, TagLib::ulong length);
+
     std::string   m_strFileName;
     XFILE::CFile  m_file;
     bool          m_bIsReadOnly;
     bool          m_bIsOpen;
+
+    bool               m_bReadAhead = false; ///< read only with a known length, reads go through the tag regions
+    long               m_length = 0;
+    long               m_position = 0;
+    TagLib::ByteVector m_head;
+    TagLib::ByteVector m_tail;
+    bool               m_bHeadRead = false;
+    bool               m_bTailRead = false;
   };
 }
 
@@ -0,0 +1,101 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "filesystem/File.h"
+#include "music/tags/TagLibVFSStream.h"
+#include "test/TestUtils.h"
+
+#include <string>
+
+#include <gtest/gtest.h>
+
+// larger than the tag regions at the start and the end together
+#define TEST_FILE_SIZE (200 * 1024)
+
+using namespace MUSIC_INFO;
+
+class TestTagLibVFSStream : public ::testing::Test
+{
+protected:
+  void SetUp() override
+  {
+    for (size_t i = 0; i < TEST_FILE_SIZE; i++)
+      content += static_cast<char>(i * 7 % 251);
+
+    file = XBMC_CREATETEMPFILE(".bin");
+    ASSERT_NE(nullptr, file);
+    ASSERT_EQ(static_cast<ssize_t>(content.size()), file->Write(content.c_str(), content.size()));
+    file->Flush();
+  }
+
+  void TearDown() override
+  {
+    XBMC_DELETETEMPFILE(file);
+  }
+
+  std::string Read(TagLibVFSStream& stream, long position, TagLib::ulong length)
+  {
+    stream.seek(position);
+    TagLib::ByteVector data = stream.readBlock(length);
+    return std::string(data.data(), data.size());
+  }
+
+  std::string content;
+  XFILE::CFile* file = nullptr;
+};
+
+TEST_F(TestTagLibVFSStream, ReadsThroughTagRegions)
+{
+  TagLibVFSStream stream(XBMC_TEMPFILEPATH(file), true);
+  ASSERT_TRUE(stream.isOpen());
+  EXPECT_EQ(TEST_FILE_SIZE, stream.length());
+
+  // within the start, the middle and the end of the file
+  EXPECT_EQ(content.substr(0, 10), Read(stream, 0, 10));
+  EXPECT_EQ(content.substr(1000, 4096), Read(stream, 1000, 4096));
+  EXPECT_EQ(content.substr(100000, 100), Read(stream, 100000, 100));
+  EXPECT_EQ(content.substr(TEST_FILE_SIZE - 128), Read(stream, TEST_FILE_SIZE - 128, 128));
+
+  // across the end of a region and past the end of the file
+  EXPECT_EQ(content.substr(60 * 1024, 10 * 1024), Read(stream, 60 * 1024, 10 * 1024));
+  EXPECT_EQ(content.substr(TEST_FILE_SIZE - 10), Read(stream, TEST_FILE_SIZE - 10, 100));
+  EXPECT_TRUE(Read(stream, TEST_FILE_SIZE, 10).empty());
+}
+
+TEST_F(TestTagLibVFSStream, ReadsSequentially)
+{
+  TagLibVFSStream stream(XBMC_TEMPFILEPATH(file), true);
+  ASSERT_TRUE(stream.isOpen());
+
+  // blocks of an odd size cross both region boundaries
+  std::string read;
+  for (TagLib::ByteVector data = stream.readBlock(3000); !data.isEmpty(); data = stream.readBlock(3000))
+  {
+    read.append(data.data(), data.size());
+    EXPECT_EQ(static_cast<long>(read.size()), stream.tell());
+  }
+  EXPECT_EQ(content, read);
+}
+
+TEST_F(TestTagLibVFSStream, KeepsPositionWithinFile)
+{
+  TagLibVFSStream stream(XBMC_TEMPFILEPATH(file), true);
+  ASSERT_TRUE(stream.isOpen());
+
+  stream.seek(-128, TagLib::IOStream::End);
+  EXPECT_EQ(TEST_FILE_SIZE - 128, stream.tell());
+
+  stream.seek(-10, TagLib::IOStream::Current);
+  EXPECT_EQ(TEST_FILE_SIZE - 138, stream.tell());
+
+  stream.seek(100, TagLib::IOStream::End);
+  EXPECT_EQ(TEST_FILE_SIZE, stream.tell());
+
+  stream.seek(-TEST_FILE_SIZE - 100, TagLib::IOStream::Current);
+  EXPECT_EQ(0, stream.tell());
+}
@@ -8,10 +8,51 @@
 
 #include "EventPacket.h"
 #include "Socket.h"
-#include "utils/log.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+
+#include <vector>
 
 using namespace EVENTPACKET;
 
+// packets kept for reuse, enough for bursts of a few clients
+#define PACKET_POOL_SIZE 256
+
+static CCriticalSection packetPoolSection;
+static std::vector<void*> packetPool;
+
+void* CEventPacket::operator new(size_t size)
+{
+  if (size == sizeof(CEventPacket))
+  {
+    CSingleLock lock(packetPoolSection);
+    if (!packetPool.empty())
+    {
+      void* ptr = packetPool.back();
+      packetPool.pop_back();
+      return ptr;
+    }
+  }
+  return ::operator new(size);
+}
+
+void CEventPacket::operator delete(void* ptr, size_t size)
+{
+  if (ptr == NULL)
+    return;
+
+  if (size == sizeof(CEventPacket))
+  {
+    CSingleLock lock(packetPoolSection);
+    if (packetPool.size() < PACKET_POOL_SIZE)
+    {
+      packetPool.push_back(ptr);
+      return;
+    }
+  }
+  ::operator delete(ptr);
+}
+
 /************************************************************************/
 /* CEventPacket                                                         */
 /************************************************************************/
@@ -67,18 +108,9 @@ bool CEventPacket::Parse(int datasize, const void *data)
     // forward past reserved bytes
     buf += 10;
 
-    if (m_pPayload)
-    {
-      free(m_pPayload);
-      m_pPayload = NULL;
-    }
-
-    m_pPayload = malloc(m_iPayloadSize);
-    if (!m_pPayload)
-    {
-      CLog::Log(LOGERROR, "ES: Out of memory");
-      return false;
-    }
+    // the payload of a single packet fits into the packet itself
+    FreePayload();
+    m_pPayload = m_payload;
     memcpy(m_pPayload, buf, (size_t)m_iPayloadSize);
   }
   m_bValid = true;
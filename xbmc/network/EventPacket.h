@@ -222,7 +222,7 @@ namespace EVENTPACKET
       Parse(datasize, data);
     }
 
-    virtual      ~CEventPacket() { free(m_pPayload); }
+    virtual      ~CEventPacket() { FreePayload(); }
     virtual bool Parse(int datasize, const void *data);
     bool         IsValid() const { return m_bValid; }
     PacketType   Type() const { return m_eType; }
@@ -233,16 +233,28 @@ namespace EVENTPACKET
     unsigned int ClientToken() const { return m_iClientToken; }
     void         SetPayload(unsigned int psize, void *payload)
     {
-      free(m_pPayload);
+      FreePayload();
       m_pPayload = payload;
       m_iPayloadSize = psize;
     }
 
+    // deleted packets are kept for reuse, a client may send thousands per second
+    static void* operator new(size_t size);
+    static void  operator delete(void* ptr, size_t size);
+
   protected:
+    void         FreePayload()
+    {
+      if (m_pPayload != m_payload)
+        free(m_pPayload);
+      m_pPayload = NULL;
+    }
+
     bool           m_bValid;
     unsigned int   m_iSeq;
     unsigned int   m_iTotalPackets;
     unsigned char  m_header[32];
+    unsigned char  m_payload[PACKET_SIZE - HEADER_SIZE]; // payload of a single packet
     void*          m_pPayload;
     unsigned int   m_iPayloadSize;
     unsigned int   m_iClientToken;
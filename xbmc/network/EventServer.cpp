@@ -25,12 +25,16 @@
 #include <cassert>
 #include <map>
 #include <queue>
+#include <vector>
 
 using namespace EVENTSERVER;
 using namespace EVENTPACKET;
 using namespace EVENTCLIENT;
 using namespace SOCKETS;
 
+// datagrams received with a single call
+#define PACKET_BATCH 32
+
 /************************************************************************/
 /* CEventServer                                                         */
 /************************************************************************/
@@ -140,7 +144,7 @@ void CEventServer::Process()
 void CEventServer::Run()
 {
   CSocketListener listener;
-  int packetSize = 0;
+  int packetCount = 0;
 
   CLog::Log(LOGNOTICE, "ES: Starting UDP Event server on port %d", m_iPort);
 
@@ -153,7 +157,7 @@ void CEventServer::Run()
     CLog::Log(LOGERROR, "ES: Could not create socket, aborting!");
     return;
   }
-  m_pPacketBuffer = (unsigned char *)malloc(PACKET_SIZE);
+  m_pPacketBuffer = (unsigned char *)malloc(PACKET_SIZE * PACKET_BATCH);
 
   if (!m_pPacketBuffer)
   {
@@ -195,10 +199,11 @@ void CEventServer::Run()
       // start listening until we timeout
       if (listener.Listen(m_iListenTimeout))
       {
-        CAddress addr;
-        if ((packetSize = m_pSocket->Read(addr, PACKET_SIZE, (void *)m_pPacketBuffer)) > -1)
+        CAddress addrs[PACKET_BATCH];
+        int packetSizes[PACKET_BATCH];
+        if ((packetCount = m_pSocket->ReadBatch(addrs, PACKET_BATCH, PACKET_SIZE, m_pPacketBuffer, packetSizes)) > 0)
         {
-          ProcessPacket(addr, packetSize);
+          ProcessPackets(addrs, packetSizes, packetCount);
         }
       }
     }
@@ -223,31 +228,49 @@ void CEventServer::Run()
   Cleanup();
 }
 
-void CEventServer::ProcessPacket(CAddress& addr, int pSize)
+void CEventServer::ProcessPackets(CAddress* addrs, const int* packetSizes, int count)
+{
+  // parse the whole batch first, so the lock the application thread takes
+  // for each action is only taken once per batch
+  std::vector<CEventPacket*> packets(count);
+  std::vector<unsigned long> clientTokens(count);
+  for (int i = 0; i < count; i++)
+    packets[i] = ParsePacket(addrs[i], m_pPacketBuffer + i * PACKET_SIZE, packetSizes[i], clientTokens[i]);
+
+  CSingleLock lock(m_critSection);
+  for (int i = 0; i < count; i++)
+  {
+    if (packets[i])
+      AddPacket(addrs[i], clientTokens[i], packets[i]);
+  }
+}
+
+CEventPacket* CEventServer::ParsePacket(CAddress& addr, const unsigned char* buffer, int pSize, unsigned long& clientToken)
 {
   // check packet validity
-  CEventPacket* packet = new CEventPacket(pSize, m_pPacketBuffer);
+  CEventPacket* packet = new CEventPacket(pSize, buffer);
   if(packet == NULL)
   {
     CLog::Log(LOGERROR, "ES: Out of memory, cannot accept packet");
-    return;
+    return NULL;
   }
 
-  unsigned int clientToken;
-
   if (!packet->IsValid())
   {
     CLog::Log(LOGDEBUG, "ES: Received invalid packet");
     delete packet;
-    return;
+    return NULL;
   }
 
   clientToken = packet->ClientToken();
   if (!clientToken)
     clientToken = addr.ULong(); // use IP if packet doesn't have a token
 
-  CSingleLock lock(m_critSection);
+  return packet;
+}
 
+void CEventServer::AddPacket(CAddress& addr, unsigned long clientToken, CEventPacket* packet)
+{
   // first check if we have a client for this address
   std::map<unsigned long, CEventClient*>::iterator iter = m_clients.find(clientToken);
 
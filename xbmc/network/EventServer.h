@@ -60,7 +60,9 @@ namespace EVENTSERVER
     CEventServer();
     void Cleanup();
     void Run();
-    void ProcessPacket(SOCKETS::CAddress& addr, int packetSize);
+    void ProcessPackets(SOCKETS::CAddress* addrs, const int* packetSizes, int count);
+    EVENTPACKET::CEventPacket* ParsePacket(SOCKETS::CAddress& addr, const unsigned char* buffer, int packetSize, unsigned long& clientToken);
+    void AddPacket(SOCKETS::CAddress& addr, unsigned long clientToken, EVENTPACKET::CEventPacket* packet);
     void ProcessEvents();
     void RefreshClients();
 
@@ -175,6 +175,36 @@ int CPosixUDPSocket::Read(CAddress& addr, const int buffersize, void *buffer)
                        (struct sockaddr*)&addr.saddr, &addr.size);
 }
 
+#if defined(TARGET_LINUX)
+int CPosixUDPSocket::ReadBatch(CAddress* addrs, const int count, const int buffersize,
+                               unsigned char *buffers, int *sizes)
+{
+  // a single call receives all datagrams that are ready
+  std::vector<struct mmsghdr> msgs(count);
+  std::vector<struct iovec> iovs(count);
+  for (int i = 0; i < count; i++)
+  {
+    if (m_ipv6Socket)
+      addrs[i].SetAddress("::");
+    iovs[i].iov_base = buffers + i * buffersize;
+    iovs[i].iov_len = buffersize;
+    memset(&msgs[i], 0, sizeof(msgs[i]));
+    msgs[i].msg_hdr.msg_name = &addrs[i].saddr;
+    msgs[i].msg_hdr.msg_namelen = sizeof(addrs[i].saddr);
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+
+  int res = recvmmsg(m_iSock, msgs.data(), count, MSG_DONTWAIT, NULL);
+  for (int i = 0; i < res; i++)
+  {
+    sizes[i] = (int)msgs[i].msg_len;
+    addrs[i].size = msgs[i].msg_hdr.msg_namelen;
+  }
+  return res;
+}
+#endif
+
 int CPosixUDPSocket::SendTo(const CAddress& addr, const int buffersize,
                           const void *buffer)
 {
@@ -172,6 +172,16 @@ namespace SOCKETS
 
     // read datagrams, return no. of bytes read or -1 or error
     virtual int Read(CAddress& addr, const int buffersize, void *buffer) = 0;
+
+    // read up to count datagrams that are ready, at least one, into count
+    // consecutive buffers of buffersize bytes each, their sizes are stored in
+    // sizes, return no. of datagrams read or -1 on error
+    virtual int ReadBatch(CAddress* addrs, const int count, const int buffersize,
+                          unsigned char *buffers, int *sizes)
+    {
+      sizes[0] = Read(addrs[0], buffersize, buffers);
+      return sizes[0] < 0 ? -1 : 1;
+    }
     virtual bool Broadcast(const CAddress& addr, const int datasize,
                            const void* data) = 0;
   };
@@ -195,6 +205,10 @@ namespace SOCKETS
     bool Listen(int timeout);
     int SendTo(const CAddress& addr, const int datasize, const void* data) override;
     int Read(CAddress& addr, const int buffersize, void *buffer) override;
+#if defined(TARGET_LINUX)
+    int ReadBatch(CAddress* addrs, const int count, const int buffersize,
+                  unsigned char *buffers, int *sizes) override;
+#endif
     bool Broadcast(const CAddress& addr, const int datasize, const void* data) override
     {
       //! @todo implement
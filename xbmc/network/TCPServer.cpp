@@ -12,6 +12,16 @@
 #include <memory.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
+#include <algorithm>
+#if defined(TARGET_POSIX)
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+#if defined(TARGET_LINUX)
+#include <sys/epoll.h>
+#endif
 
 #include "settings/AdvancedSettings.h"
 #include "settings/SettingsComponent.h"
@@ -49,6 +59,30 @@ static const bdaddr_t bt_bdaddr_local = {{0, 0, 0, 0xff, 0xff, 0xff}};
 using namespace JSONRPC;
 
 #define RECEIVEBUFFER 1024
+#define MAX_EVENTS 64
+// chunks written with a single call
+#define MAX_OUTPUT_CHUNKS 16
+// announcements queued for a client before it is considered stuck
+#define MAX_ANNOUNCEMENT_SIZE (4 * 1024 * 1024)
+
+static bool SetNonBlocking(SOCKET socket)
+{
+#ifdef TARGET_WINDOWS
+  u_long nonblocking = 1;
+  return ioctlsocket(socket, FIONBIO, &nonblocking) == 0;
+#else
+  return fcntl(socket, F_SETFL, fcntl(socket, F_GETFL) | O_NONBLOCK) == 0;
+#endif
+}
+
+static bool WouldBlock()
+{
+#ifdef TARGET_WINDOWS
+  return WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+  return errno == EAGAIN || errno == EWOULDBLOCK;
+#endif
+}
 
 CTCPServer *CTCPServer::ServerInstance = NULL;
 
@@ -105,118 +139,212 @@ CTCPServer::CTCPServer(int port, bool nonlocal) : CThread("TCPServer")
   m_port = port;
   m_nonlocal = nonlocal;
   m_sdpd = NULL;
+  m_epoll = -1;
 }
 
 void CTCPServer::Process()
 {
   m_bStop = false;
 
+  std::vector<SSocketEvent> events;
   while (!m_bStop)
   {
-    SOCKET          max_fd = 0;
-    fd_set          rfds;
-    struct timeval  to     = {1, 0};
-    FD_ZERO(&rfds);
-
-    for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); ++it)
+    if (!WaitForEvents(events, 1000))
     {
-      FD_SET(*it, &rfds);
-      if ((intptr_t)*it > (intptr_t)max_fd)
-        max_fd = *it;
+      CLog::Log(LOGERROR, "JSONRPC Server: Waiting for socket events failed");
+      Sleep(1000);
+      Initialize();
+      continue;
     }
 
-    for (unsigned int i = 0; i < m_connections.size(); i++)
+    for (const auto& event : events)
     {
-      FD_SET(m_connections[i]->m_socket, &rfds);
-      if ((intptr_t)m_connections[i]->m_socket > (intptr_t)max_fd)
-        max_fd = m_connections[i]->m_socket;
+      if (std::find(m_servers.begin(), m_servers.end(), event.socket) != m_servers.end())
+      {
+        if (!AcceptConnection(event.socket))
+          break;
+        continue;
+      }
+
+      auto it = std::find_if(m_connections.begin(), m_connections.end(), [&event](const CTCPClient* client) {
+        return client->m_socket == event.socket;
+      });
+      if (it == m_connections.end())
+        continue;
+
+      size_t index = it - m_connections.begin();
+      bool close = event.error && !event.read;
+      if (!close && event.write)
+        close = !m_connections[index]->Flush();
+      if (!close && event.read)
+        close = !ReceiveFromClient(index);
+
+      if (close)
+      {
+        CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
+        CloseConnection(index);
+      }
     }
+  }
 
-    int res = select((intptr_t)max_fd+1, &rfds, NULL, NULL, &to);
+  Deinitialize();
+}
+
+void CTCPServer::Watch(SOCKET socket, bool server)
+{
+#if defined(TARGET_LINUX)
+  if (m_epoll < 0)
+    return;
+
+  // clients are edge triggered, so output queued by other threads is
+  // picked up once the socket becomes writable again
+  struct epoll_event event = {};
+  event.events = server ? EPOLLIN : (EPOLLIN | EPOLLOUT | EPOLLET);
+  event.data.fd = socket;
+  if (epoll_ctl(m_epoll, EPOLL_CTL_ADD, socket, &event) < 0)
+    CLog::Log(LOGERROR, "JSONRPC Server: Failed to watch socket: %d", errno);
+#endif
+}
+
+void CTCPServer::Unwatch(SOCKET socket)
+{
+#if defined(TARGET_LINUX)
+  if (m_epoll >= 0 && socket != INVALID_SOCKET)
+    epoll_ctl(m_epoll, EPOLL_CTL_DEL, socket, NULL);
+#endif
+}
+
+bool CTCPServer::WaitForEvents(std::vector<SSocketEvent> &events, int timeout)
+{
+  events.clear();
+
+#if defined(TARGET_LINUX)
+  if (m_epoll >= 0)
+  {
+    struct epoll_event ready[MAX_EVENTS];
+    int res = epoll_wait(m_epoll, ready, MAX_EVENTS, timeout);
     if (res < 0)
+      return errno == EINTR;
+
+    for (int i = 0; i < res; i++)
+    {
+      events.push_back({ static_cast<SOCKET>(ready[i].data.fd),
+                         (ready[i].events & (EPOLLIN | EPOLLHUP)) != 0,
+                         (ready[i].events & EPOLLOUT) != 0,
+                         (ready[i].events & EPOLLERR) != 0 });
+    }
+    return true;
+  }
+#endif
+
+  // without epoll the sockets are polled level triggered, output queued
+  // while waiting is written on the next round at the latest
+  std::vector<struct pollfd> fds;
+  for (const auto& server : m_servers)
+    fds.push_back({ server, POLLIN, 0 });
+  for (const auto& connection : m_connections)
+    fds.push_back({ connection->m_socket, static_cast<short>(connection->HasOutput() ? (POLLIN | POLLOUT) : POLLIN), 0 });
+
+#if defined(TARGET_WINDOWS)
+  int res = WSAPoll(fds.data(), static_cast<ULONG>(fds.size()), timeout);
+#else
+  int res = poll(fds.data(), fds.size(), timeout);
+  if (res < 0 && errno == EINTR)
+    return true;
+#endif
+  if (res < 0)
+    return false;
+
+  for (const auto& fd : fds)
+  {
+    if (fd.revents != 0)
+      events.push_back({ fd.fd, (fd.revents & (POLLIN | POLLHUP)) != 0, (fd.revents & POLLOUT) != 0, (fd.revents & (POLLERR | POLLNVAL)) != 0 });
+  }
+  return true;
+}
+
+bool CTCPServer::AcceptConnection(SOCKET server)
+{
+  CLog::Log(LOGDEBUG, "JSONRPC Server: New connection detected");
+  CTCPClient *newconnection = new CTCPClient();
+  newconnection->m_socket = accept(server, (sockaddr*)&newconnection->m_cliaddr, &newconnection->m_addrlen);
+
+  if (newconnection->m_socket == INVALID_SOCKET)
+  {
+    CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed: %d", errno);
+    delete newconnection;
+    if (EBADF == errno)
     {
-      CLog::Log(LOGERROR, "JSONRPC Server: Select failed");
       Sleep(1000);
       Initialize();
+      return false;
     }
-    else if (res > 0)
+    return true;
+  }
+
+  if (!SetNonBlocking(newconnection->m_socket))
+  {
+    CLog::Log(LOGERROR, "JSONRPC Server: Failed to set new connection non-blocking");
+    closesocket(newconnection->m_socket);
+    delete newconnection;
+    return true;
+  }
+
+  CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
+  {
+    CSingleLock lock(m_connectionsSection);
+    m_connections.push_back(newconnection);
+  }
+  Watch(newconnection->m_socket, false);
+  return true;
+}
+
+bool CTCPServer::ReceiveFromClient(size_t index)
+{
+  // read until the socket is drained, clients are watched edge triggered
+  while (true)
+  {
+    char buffer[RECEIVEBUFFER] = {};
+    int nread = recv(m_connections[index]->m_socket, (char*)&buffer, RECEIVEBUFFER, 0);
+    if (nread < 0 && WouldBlock())
+      return true;
+    if (nread <= 0)
+      return false;
+
+    std::string response;
+    if (m_connections[index]->IsNew())
     {
-      for (int i = m_connections.size() - 1; i >= 0; i--)
-      {
-        int socket = m_connections[i]->m_socket;
-        if (FD_ISSET(socket, &rfds))
-        {
-          char buffer[RECEIVEBUFFER] = {};
-          int  nread = 0;
-          nread = recv(socket, (char*)&buffer, RECEIVEBUFFER, 0);
-          bool close = false;
-          if (nread > 0)
-          {
-            std::string response;
-            if (m_connections[i]->IsNew())
-            {
-              CWebSocket *websocket = CWebSocketManager::Handle(buffer, nread, response);
-
-              if (!response.empty())
-                m_connections[i]->Send(response.c_str(), response.size());
-
-              if (websocket != NULL)
-              {
-                // Replace the CTCPClient with a CWebSocketClient
-                CWebSocketClient *websocketClient = new CWebSocketClient(websocket, *(m_connections[i]));
-                delete m_connections[i];
-                m_connections.erase(m_connections.begin() + i);
-                m_connections.insert(m_connections.begin() + i, websocketClient);
-              }
-            }
-
-            if (response.size() <= 0)
-              m_connections[i]->PushBuffer(this, buffer, nread);
-
-            close = m_connections[i]->Closing();
-          }
-          else
-            close = true;
+      CWebSocket *websocket = CWebSocketManager::Handle(buffer, nread, response);
 
-          if (close)
-          {
-            CLog::Log(LOGINFO, "JSONRPC Server: Disconnection detected");
-            m_connections[i]->Disconnect();
-            delete m_connections[i];
-            m_connections.erase(m_connections.begin() + i);
-          }
-        }
-      }
+      if (!response.empty())
+        m_connections[index]->Send(response.c_str(), response.size());
 
-      for (std::vector<SOCKET>::iterator it = m_servers.begin(); it != m_servers.end(); ++it)
+      if (websocket != NULL)
       {
-        if (FD_ISSET(*it, &rfds))
-        {
-          CLog::Log(LOGDEBUG, "JSONRPC Server: New connection detected");
-          CTCPClient *newconnection = new CTCPClient();
-          newconnection->m_socket = accept(*it, (sockaddr*)&newconnection->m_cliaddr, &newconnection->m_addrlen);
-
-          if (newconnection->m_socket == INVALID_SOCKET)
-          {
-            CLog::Log(LOGERROR, "JSONRPC Server: Accept of new connection failed: %d", errno);
-            if (EBADF == errno)
-            {
-              Sleep(1000);
-              Initialize();
-              break;
-            }
-          }
-          else
-          {
-            CLog::Log(LOGINFO, "JSONRPC Server: New connection added");
-            m_connections.push_back(newconnection);
-          }
-        }
+        // Replace the CTCPClient with a CWebSocketClient
+        CWebSocketClient *websocketClient = new CWebSocketClient(websocket, *(m_connections[index]));
+        CSingleLock lock(m_connectionsSection);
+        delete m_connections[index];
+        m_connections[index] = websocketClient;
       }
     }
+
+    if (response.size() <= 0)
+      m_connections[index]->PushBuffer(this, buffer, nread);
+
+    if (m_connections[index]->Closing())
+      return false;
   }
+}
 
-  Deinitialize();
+void CTCPServer::CloseConnection(size_t index)
+{
+  Unwatch(m_connections[index]->m_socket);
+
+  CSingleLock lock(m_connectionsSection);
+  m_connections[index]->Disconnect();
+  delete m_connections[index];
+  m_connections.erase(m_connections.begin() + index);
 }
 
 bool CTCPServer::PrepareDownload(const char *path, CVariant &details, std::string &protocol)
@@ -236,18 +364,24 @@ int CTCPServer::GetCapabilities()
 
 void CTCPServer::Announce(ANNOUNCEMENT::AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
 {
-  std::string str = IJSONRPCAnnouncer::AnnouncementToJSONRPC(flag, sender, message, data, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_jsonOutputCompact);
+  CSingleLock lock(m_connectionsSection);
 
+  // filter first, the notification is only serialized if any client wants it
+  std::vector<CTCPClient*> clients;
   for (unsigned int i = 0; i < m_connections.size(); i++)
   {
-    {
-      CSingleLock lock (m_connections[i]->m_critSection);
-      if ((m_connections[i]->GetAnnouncementFlags() & flag) == 0)
-        continue;
-    }
-
-    m_connections[i]->Send(str.c_str(), str.size());
+    CSingleLock clientLock (m_connections[i]->m_critSection);
+    if ((m_connections[i]->GetAnnouncementFlags() & flag) != 0)
+      clients.push_back(m_connections[i]);
   }
+
+  if (clients.empty())
+    return;
+
+  std::string str = IJSONRPCAnnouncer::AnnouncementToJSONRPC(flag, sender, message, data, CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_jsonOutputCompact);
+
+  for (auto client : clients)
+    client->SendAnnouncement(str.c_str(), str.size());
 }
 
 bool CTCPServer::Initialize()
@@ -261,6 +395,14 @@ bool CTCPServer::Initialize()
 
   if (started)
   {
+#if defined(TARGET_LINUX)
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (m_epoll < 0)
+      CLog::Log(LOGWARNING, "JSONRPC Server: epoll not available, falling back to poll");
+#endif
+    for (const auto& server : m_servers)
+      Watch(server, true);
+
     CServiceBroker::GetAnnouncementManager()->AddAnnouncer(this);
     CLog::Log(LOGINFO, "JSONRPC Server: Successfully initialized");
     return true;
@@ -474,13 +616,22 @@ bool CTCPServer::InitializeTCP()
 
 void CTCPServer::Deinitialize()
 {
-  for (unsigned int i = 0; i < m_connections.size(); i++)
   {
-    m_connections[i]->Disconnect();
-    delete m_connections[i];
+    CSingleLock lock(m_connectionsSection);
+    for (unsigned int i = 0; i < m_connections.size(); i++)
+    {
+      m_connections[i]->Disconnect();
+      delete m_connections[i];
+    }
+
+    m_connections.clear();
   }
 
-  m_connections.clear();
+#if defined(TARGET_LINUX)
+  if (m_epoll >= 0)
+    close(m_epoll);
+#endif
+  m_epoll = -1;
 
   for (unsigned int i = 0; i < m_servers.size(); i++)
     closesocket(m_servers[i]);
@@ -505,6 +656,8 @@ CTCPServer::CTCPClient::CTCPClient()
   m_endBrackets = 0;
   m_beginChar = 0;
   m_endChar = 0;
+  m_outputOffset = 0;
+  m_announcementSize = 0;
 
   m_addrlen = sizeof(m_cliaddr);
 }
@@ -538,12 +691,95 @@ bool CTCPServer::CTCPClient::SetAnnouncementFlags(int flags)
 
 void CTCPServer::CTCPClient::Send(const char *data, unsigned int size)
 {
-  unsigned int sent = 0;
-  do
+  Queue(data, size, false);
+}
+
+void CTCPServer::CTCPClient::SendAnnouncement(const char *data, unsigned int size)
+{
+  Queue(data, size, true);
+}
+
+void CTCPServer::CTCPClient::Queue(const char *data, unsigned int size, bool announcement)
+{
+  CSingleLock lock (m_critSection);
+  if (m_socket == INVALID_SOCKET || size == 0)
+    return;
+
+  // a large reply still being written is fine, announcements piling up
+  // behind it are not
+  if (announcement && m_announcementSize > 0 && m_announcementSize + size > MAX_ANNOUNCEMENT_SIZE)
   {
-    CSingleLock lock (m_critSection);
-    sent += send(m_socket, data + sent, size - sent, 0);
-  } while (sent < size);
+    // the reading side notices the shutdown and closes the connection
+    CLog::Log(LOGWARNING, "JSONRPC Server: Client does not keep up with its announcements, closing connection");
+    shutdown(m_socket, SHUT_RDWR);
+    return;
+  }
+
+  m_output.push_back({std::string(data, size), announcement});
+  if (announcement)
+    m_announcementSize += size;
+  if (!FlushOutput())
+    shutdown(m_socket, SHUT_RDWR);
+}
+
+bool CTCPServer::CTCPClient::Flush()
+{
+  CSingleLock lock (m_critSection);
+  return FlushOutput();
+}
+
+bool CTCPServer::CTCPClient::HasOutput()
+{
+  CSingleLock lock (m_critSection);
+  return !m_output.empty();
+}
+
+bool CTCPServer::CTCPClient::FlushOutput()
+{
+  while (!m_output.empty() && m_socket != INVALID_SOCKET)
+  {
+#if defined(TARGET_POSIX)
+    // write all queued chunks with a single call
+    struct iovec iov[MAX_OUTPUT_CHUNKS];
+    struct msghdr msg = {};
+    size_t count = 0;
+    for (auto it = m_output.begin(); it != m_output.end() && count < MAX_OUTPUT_CHUNKS; ++it, ++count)
+    {
+      size_t offset = count == 0 ? m_outputOffset : 0;
+      iov[count].iov_base = const_cast<char*>(it->data.data()) + offset;
+      iov[count].iov_len = it->data.size() - offset;
+    }
+    msg.msg_iov = iov;
+    msg.msg_iovlen = count;
+
+#ifdef MSG_NOSIGNAL
+    ssize_t sent = sendmsg(m_socket, &msg, MSG_NOSIGNAL);
+#else
+    ssize_t sent = sendmsg(m_socket, &msg, 0);
+#endif
+#else
+    int sent = send(m_socket, m_output.front().data.data() + m_outputOffset, static_cast<int>(m_output.front().data.size() - m_outputOffset), 0);
+#endif
+    if (sent < 0)
+      return WouldBlock();
+
+    size_t written = static_cast<size_t>(sent);
+    while (written > 0)
+    {
+      size_t left = m_output.front().data.size() - m_outputOffset;
+      if (written < left)
+      {
+        m_outputOffset += written;
+        break;
+      }
+      written -= left;
+      if (m_output.front().announcement)
+        m_announcementSize -= m_output.front().data.size();
+      m_output.pop_front();
+      m_outputOffset = 0;
+    }
+  }
+  return true;
 }
 
 void CTCPServer::CTCPClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
@@ -641,6 +877,9 @@ void CTCPServer::CTCPClient::Copy(const CTCPClient& client)
   m_beginChar         = client.m_beginChar;
   m_endChar           = client.m_endChar;
   m_buffer            = client.m_buffer;
+  m_output            = client.m_output;
+  m_outputOffset      = client.m_outputOffset;
+  m_announcementSize  = client.m_announcementSize;
 }
 
 CTCPServer::CWebSocketClient::CWebSocketClient(CWebSocket *websocket)
@@ -675,6 +914,16 @@ CTCPServer::CWebSocketClient& CTCPServer::CWebSocketClient::operator=(const CWeb
 }
 
 void CTCPServer::CWebSocketClient::Send(const char *data, unsigned int size)
+{
+  SendFrames(data, size, false);
+}
+
+void CTCPServer::CWebSocketClient::SendAnnouncement(const char *data, unsigned int size)
+{
+  SendFrames(data, size, true);
+}
+
+void CTCPServer::CWebSocketClient::SendFrames(const char *data, unsigned int size, bool announcement)
 {
   const CWebSocketMessage *msg = m_websocket->Send(WebSocketTextFrame, data, size);
   if (msg == NULL || !msg->IsComplete())
@@ -682,7 +931,7 @@ void CTCPServer::CWebSocketClient::Send(const char *data, unsigned int size)
 
   std::vector<const CWebSocketFrame *> frames = msg->GetFrames();
   for (unsigned int index = 0; index < frames.size(); index++)
-    CTCPClient::Send(frames.at(index)->GetFrameData(), (unsigned int)frames.at(index)->GetFrameLength());
+    Queue(frames.at(index)->GetFrameData(), (unsigned int)frames.at(index)->GetFrameLength(), announcement);
 }
 
 void CTCPServer::CWebSocketClient::PushBuffer(CTCPServer *host, const char *buffer, int length)
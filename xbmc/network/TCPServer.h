@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <deque>
+#include <string>
 #include <vector>
 #include <sys/socket.h>
 
@@ -44,6 +46,21 @@ namespace JSONRPC
     bool InitializeTCP();
     void Deinitialize();
 
+    struct SSocketEvent
+    {
+      SOCKET socket;
+      bool read;
+      bool write;
+      bool error;
+    };
+
+    void Watch(SOCKET socket, bool server);
+    void Unwatch(SOCKET socket);
+    bool WaitForEvents(std::vector<SSocketEvent> &events, int timeout);
+    bool AcceptConnection(SOCKET server);
+    bool ReceiveFromClient(size_t index);
+    void CloseConnection(size_t index);
+
     class CTCPClient : public IClient
     {
     public:
@@ -58,7 +75,20 @@ namespace JSONRPC
       int GetAnnouncementFlags() override;
       bool SetAnnouncementFlags(int flags) override;
 
+      /*! \brief Queue data for the client and write as much as the socket takes
+       without blocking.
+       */
       virtual void Send(const char *data, unsigned int size);
+      /*! \brief Queue an announcement for the client. A client whose queued
+       announcements exceed the limit is shut down, so a stuck client cannot
+       hold up the others. Replies to its own requests don't count.
+       */
+      virtual void SendAnnouncement(const char *data, unsigned int size);
+      /*! \brief Write queued output, called when the socket is writable.
+       \return false if the connection failed
+       */
+      bool Flush();
+      bool HasOutput();
       virtual void PushBuffer(CTCPServer *host, const char *buffer, int length);
       virtual void Disconnect();
 
@@ -72,12 +102,24 @@ namespace JSONRPC
 
     protected:
       void Copy(const CTCPClient& client);
+      void Queue(const char *data, unsigned int size, bool announcement);
     private:
+      bool FlushOutput();
+
+      struct SOutput
+      {
+        std::string data;
+        bool announcement;
+      };
+
       bool m_new;
       int m_announcementflags;
       int m_beginBrackets, m_endBrackets;
       char m_beginChar, m_endChar;
       std::string m_buffer;
+      std::deque<SOutput> m_output; ///< output not taken by the socket yet
+      size_t m_outputOffset; ///< bytes of the first output chunk already written
+      size_t m_announcementSize; ///< bytes of announcements in the output
     };
 
     class CWebSocketClient : public CTCPClient
@@ -90,6 +132,7 @@ namespace JSONRPC
       ~CWebSocketClient() override;
 
       void Send(const char *data, unsigned int size) override;
+      void SendAnnouncement(const char *data, unsigned int size) override;
       void PushBuffer(CTCPServer *host, const char *buffer, int length) override;
       void Disconnect() override;
 
@@ -97,10 +140,14 @@ namespace JSONRPC
       bool Closing() const override { return m_websocket != NULL && m_websocket->GetState() == WebSocketStateClosed; }
 
     private:
+      void SendFrames(const char *data, unsigned int size, bool announcement);
+
       CWebSocket *m_websocket;
     };
 
     std::vector<CTCPClient*> m_connections;
+    CCriticalSection m_connectionsSection; ///< held by other threads using m_connections and while changing it
+    int m_epoll;
     std::vector<SOCKET> m_servers;
     int m_port;
     bool m_nonlocal;
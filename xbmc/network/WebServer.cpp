@@ -7,17 +7,22 @@
  */
 
 #include "WebServer.h"
+#include "WebServerWorkers.h"
 
 #include <algorithm>
 #include <memory>
 #include <stdexcept>
 #include <utility>
+#include <vector>
 
 #if defined(TARGET_POSIX)
+#include <fcntl.h>
 #include <pthread.h>
+#include <unistd.h>
 #endif
 
 #include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
 #include "network/httprequesthandler/HTTPRequestHandlerUtils.h"
 #include "network/httprequesthandler/IHTTPRequestHandler.h"
 #include "settings/AdvancedSettings.h"
@@ -36,6 +41,14 @@
 
 #define MAX_POST_BUFFER_SIZE 2048
 
+#define MAX_CONNECTIONS        512
+// in the pooled mode connections only cost a socket and their buffers
+#define MAX_CONNECTIONS_POOLED 4096
+// threads polling the connections in the pooled mode, files are opened and read by the workers
+#define POLLING_THREADS        4
+// data of a file read by a worker at a time in the pooled mode
+#define FILE_READAHEAD_SIZE    (64 * 1024)
+
 #define PAGE_FILE_NOT_FOUND "<html><head><title>File not found</title></head><body>File not found</body></html>"
 #define NOT_SUPPORTED       "<html><head><title>Not Supported</title></head><body>The method you are trying to use is not supported by this server</body></html>"
 
@@ -53,6 +66,13 @@ typedef struct {
   bool boundaryWritten;
   std::string contentType;
   uint64_t writePosition;
+  // in the pooled mode the file is read ahead by the workers while the connection is suspended
+  CWebServerWorkers* workers;
+  struct MHD_Connection* connection;
+  std::vector<char> readBuffer;
+  uint64_t readPosition;
+  size_t readLength;
+  bool readFailed;
 } HttpFileDownloadContext;
 
 CWebServer::CWebServer()
@@ -75,6 +95,8 @@ CWebServer::CWebServer()
 #endif
 }
 
+CWebServer::~CWebServer() = default;
+
 static MHD_Response* create_response(size_t size, const void* data, int free, int copy)
 {
   MHD_ResponseMemoryMode mode = MHD_RESPMEM_PERSISTENT;
@@ -86,6 +108,28 @@ static MHD_Response* create_response(size_t size, const void* data, int free, in
   return MHD_create_response_from_buffer(size, const_cast<void*>(data), mode);
 }
 
+static MHD_Response* create_file_response(const std::string& filePath, uint64_t offset, uint64_t size)
+{
+#if defined(TARGET_POSIX) && (MHD_VERSION >= 0x00094400)
+  // only plain files on a local filesystem can be handed over as a file descriptor
+  std::string localPath = CSpecialProtocol::TranslatePath(filePath);
+  if (localPath.empty() || URIUtils::IsURL(localPath))
+    return nullptr;
+
+  int fd = open(localPath.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0)
+    return nullptr;
+
+  // libmicrohttpd closes the file descriptor along with the response
+  MHD_Response* response = MHD_create_response_from_fd_at_offset64(size, fd, offset);
+  if (response == nullptr)
+    close(fd);
+  return response;
+#else
+  return nullptr;
+#endif
+}
+
 int CWebServer::AskForAuthentication(const HTTPRequest& request) const
 {
   struct MHD_Response *response = create_response(0, nullptr, MHD_NO, MHD_NO);
@@ -175,6 +219,10 @@ int CWebServer::HandlePartialRequest(struct MHD_Connection *connection, Connecti
   // reset con_cls and set it if still necessary
   *con_cls = nullptr;
 
+  // the request handler has been run by a worker, the connection is resumed to respond
+  if (conHandler->handled)
+    return RespondToRequest(conHandler->requestHandler, conHandler->handleResult, conHandler.get());
+
   if (!IsAuthenticated(request))
     return AskForAuthentication(request);
 
@@ -198,11 +246,13 @@ int CWebServer::HandlePartialRequest(struct MHD_Connection *connection, Connecti
             // handle If-Modified-Since or If-Unmodified-Since
             std::string ifModifiedSince = HTTPRequestHandlerUtils::GetRequestHeaderValue(connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_IF_MODIFIED_SINCE);
             std::string ifUnmodifiedSince = HTTPRequestHandlerUtils::GetRequestHeaderValue(connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_IF_UNMODIFIED_SINCE);
+            // If-None-Match takes precedence over If-Modified-Since and is handled once the entity tag is known
+            std::string ifNoneMatch = HTTPRequestHandlerUtils::GetRequestHeaderValue(connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_IF_NONE_MATCH);
 
             CDateTime ifModifiedSinceDate;
             CDateTime ifUnmodifiedSinceDate;
             // handle If-Modified-Since (but only if the response is cacheable)
-            if (cacheable &&
+            if (cacheable && ifNoneMatch.empty() &&
               ifModifiedSinceDate.SetFromRFC1123DateTime(ifModifiedSince) &&
               lastModified.GetAsUTCDateTime() <= ifModifiedSinceDate)
             {
@@ -237,7 +287,7 @@ int CWebServer::HandlePartialRequest(struct MHD_Connection *connection, Connecti
         return MHD_YES;
       }
 
-      return HandleRequest(handler);
+      return DispatchRequest(conHandler, handler, con_cls);
     }
   }
   // this is a subsequent call to AnswerToConnection for this request
@@ -263,7 +313,7 @@ int CWebServer::HandlePartialRequest(struct MHD_Connection *connection, Connecti
         return SendErrorResponse(request, conHandler->errorStatus, request.method);
 
       // we have handled all POST data so it's time to invoke the IHTTPRequestHandler
-      return HandleRequest(conHandler->requestHandler);
+      return DispatchRequest(conHandler, conHandler->requestHandler, con_cls);
     }
 
     // it's unusual to get more than one call to AnswerToConnection for none-POST requests, but let's handle it anyway
@@ -295,12 +345,55 @@ int CWebServer::HandlePostField(void *cls, enum MHD_ValueKind kind, const char *
 }
 
 int CWebServer::HandleRequest(const std::shared_ptr<IHTTPRequestHandler>& handler)
+{
+  if (handler == nullptr)
+    return MHD_NO;
+
+  return RespondToRequest(handler, handler->HandleRequest());
+}
+
+int CWebServer::DispatchRequest(std::unique_ptr<ConnectionHandler>& connectionHandler, const std::shared_ptr<IHTTPRequestHandler>& handler, void **con_cls)
+{
+  if (m_workers == nullptr || handler == nullptr || !handler->IsLongRunning())
+    return HandleRequest(handler);
+
+  // the connection isn't polled until the worker is done with the request handler
+  ConnectionHandler* conHandler = connectionHandler.get();
+  struct MHD_Connection* connection = handler->GetRequest().connection;
+  conHandler->requestHandler = handler;
+  *con_cls = conHandler;
+  MHD_suspend_connection(connection);
+
+  bool queued = m_workers->Queue([this, conHandler, connection]() {
+    conHandler->handleResult = conHandler->requestHandler->HandleRequest();
+    // the file to download may be on a slow source so it is opened here as well
+    if (conHandler->handleResult == MHD_YES &&
+        conHandler->requestHandler->GetResponseDetails().type == HTTPFileDownload)
+      conHandler->fileStatus = OpenFileDownload(conHandler->requestHandler, conHandler->file);
+    conHandler->handled = true;
+    MHD_resume_connection(connection);
+  });
+
+  if (!queued)
+  {
+    MHD_resume_connection(connection);
+    *con_cls = nullptr;
+    return HandleRequest(handler);
+  }
+
+  // as ownership of the connection handler has been passed to libmicrohttpd we must not destroy it
+  connectionHandler.release();
+
+  return MHD_YES;
+}
+
+int CWebServer::RespondToRequest(const std::shared_ptr<IHTTPRequestHandler>& handler, int handleResult, const ConnectionHandler* connectionHandler /* = nullptr */)
 {
   if (handler == nullptr)
     return MHD_NO;
 
   HTTPRequest request = handler->GetRequest();
-  int ret = handler->HandleRequest();
+  int ret = handleResult;
   if (ret == MHD_NO)
   {
     CLog::Log(LOGERROR, "CWebServer[%hu]: failed to handle HTTP request for %s", m_port, request.pathUrl.c_str());
@@ -309,6 +402,23 @@ int CWebServer::HandleRequest(const std::shared_ptr<IHTTPRequestHandler>& handle
 
   const HTTPResponseDetails &responseDetails = handler->GetResponseDetails();
   struct MHD_Response *response = nullptr;
+
+  // handle If-None-Match (but only if the response is cacheable)
+  std::string etag;
+  if ((request.method == GET || request.method == HEAD) &&
+      responseDetails.status == MHD_HTTP_OK && handler->CanBeCached() &&
+      handler->GetETag(etag) && IsRequestCacheable(request) && IsETagMatched(request, etag))
+  {
+    response = create_response(0, nullptr, MHD_NO, MHD_NO);
+    if (response == nullptr)
+    {
+      CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP 304 response", m_port);
+      return MHD_NO;
+    }
+
+    return FinalizeRequest(handler, MHD_HTTP_NOT_MODIFIED, response);
+  }
+
   switch (responseDetails.type)
   {
     case HTTPNone:
@@ -320,8 +430,24 @@ int CWebServer::HandleRequest(const std::shared_ptr<IHTTPRequestHandler>& handle
       break;
 
     case HTTPFileDownload:
-      ret = CreateFileDownloadResponse(handler, response);
+    {
+      std::shared_ptr<XFILE::CFile> file;
+      int fileStatus;
+      // in the pooled mode the file has already been opened by a worker
+      if (connectionHandler != nullptr && connectionHandler->fileStatus != 0)
+      {
+        file = connectionHandler->file;
+        fileStatus = connectionHandler->fileStatus;
+      }
+      else
+        fileStatus = OpenFileDownload(handler, file);
+
+      if (fileStatus != MHD_HTTP_OK)
+        return SendErrorResponse(request, fileStatus, request.method);
+
+      ret = CreateFileDownloadResponse(handler, file, response);
       break;
+    }
 
     case HTTPMemoryDownloadNoFreeNoCopy:
     case HTTPMemoryDownloadNoFreeCopy:
@@ -365,6 +491,11 @@ int CWebServer::FinalizeRequest(const std::shared_ptr<IHTTPRequestHandler>& hand
   if (handler->GetLastModifiedDate(lastModified) && lastModified.IsValid())
     handler->AddResponseHeader(MHD_HTTP_HEADER_LAST_MODIFIED, lastModified.GetAsRFC1123DateTime());
 
+  // if the request handler has set an entity tag and it hasn't been set as a header, add it
+  std::string etag;
+  if (handler->GetETag(etag) && !handler->HasResponseHeader(MHD_HTTP_HEADER_ETAG))
+    handler->AddResponseHeader(MHD_HTTP_HEADER_ETAG, etag);
+
   // check if the request handler has set Cache-Control and add it if not
   if (!handler->HasResponseHeader(MHD_HTTP_HEADER_CACHE_CONTROL))
   {
@@ -457,6 +588,27 @@ bool CWebServer::IsRequestCacheable(const HTTPRequest& request) const
   return true;
 }
 
+bool CWebServer::IsETagMatched(const HTTPRequest& request, const std::string &etag) const
+{
+  std::string ifNoneMatch = HTTPRequestHandlerUtils::GetRequestHeaderValue(request.connection, MHD_HEADER_KIND, MHD_HTTP_HEADER_IF_NONE_MATCH);
+  if (ifNoneMatch.empty())
+    return false;
+
+  // If-None-Match uses the weak comparison, the W/ prefix doesn't matter
+  std::vector<std::string> tags = StringUtils::Split(ifNoneMatch, ",");
+  for (auto tag : tags)
+  {
+    tag = StringUtils::Trim(tag);
+    if (StringUtils::StartsWith(tag, "W/"))
+      tag.erase(0, 2);
+
+    if (tag == "*" || tag == etag)
+      return true;
+  }
+
+  return false;
+}
+
 bool CWebServer::IsRequestRanged(const HTTPRequest& request, const CDateTime &lastModified) const
 {
   // parse the Range header and store it in the request object
@@ -713,28 +865,36 @@ int CWebServer::CreateRedirect(struct MHD_Connection *connection, const std::str
   return MHD_YES;
 }
 
-int CWebServer::CreateFileDownloadResponse(const std::shared_ptr<IHTTPRequestHandler>& handler, struct MHD_Response *&response) const
+int CWebServer::OpenFileDownload(const std::shared_ptr<IHTTPRequestHandler>& handler, std::shared_ptr<XFILE::CFile>& file) const
 {
-  if (handler == nullptr)
-    return MHD_NO;
-
-  const HTTPRequest &request = handler->GetRequest();
-  const HTTPResponseDetails &responseDetails = handler->GetResponseDetails();
-  HttpResponseRanges responseRanges = handler->GetResponseData();
-
-  std::shared_ptr<XFILE::CFile> file = std::make_shared<XFILE::CFile>();
   std::string filePath = handler->GetResponseFile();
 
   // access check
   if (!CFileUtils::CheckFileAccessAllowed(filePath))
-    return SendErrorResponse(request, MHD_HTTP_NOT_FOUND, request.method);
+    return MHD_HTTP_NOT_FOUND;
 
+  file = std::make_shared<XFILE::CFile>();
   if (!file->Open(filePath, XFILE::READ_NO_CACHE))
   {
     CLog::Log(LOGERROR, "CWebServer[%hu]: Failed to open %s", m_port, filePath.c_str());
-    return SendErrorResponse(request, MHD_HTTP_NOT_FOUND, request.method);
+    file.reset();
+    return MHD_HTTP_NOT_FOUND;
   }
 
+  return MHD_HTTP_OK;
+}
+
+int CWebServer::CreateFileDownloadResponse(const std::shared_ptr<IHTTPRequestHandler>& handler, const std::shared_ptr<XFILE::CFile>& file, struct MHD_Response *&response) const
+{
+  if (handler == nullptr || file == nullptr)
+    return MHD_NO;
+
+  const HTTPRequest &request = handler->GetRequest();
+  const HTTPResponseDetails &responseDetails = handler->GetResponseDetails();
+  HttpResponseRanges responseRanges = handler->GetResponseData();
+
+  std::string filePath = handler->GetResponseFile();
+
   bool ranged = false;
   uint64_t fileLength = static_cast<uint64_t>(file->GetLength());
 
@@ -814,18 +974,30 @@ int CWebServer::CreateFileDownloadResponse(const std::shared_ptr<IHTTPRequestHan
     // set the initial write position
     context->ranges.GetFirstPosition(context->writePosition);
 
-    // create the response object
-    response = MHD_create_response_from_callback(totalLength, 2048,
-                                                  &CWebServer::ContentReaderCallback,
-                                                  context.get(),
-                                                  &CWebServer::ContentReaderFreeCallback);
+    // a single range of a local file is sent straight from its file descriptor,
+    // so libmicrohttpd can use sendfile() instead of copying it through our buffers
+    if (m_sendFile && context->rangeCountTotal == 1)
+      response = create_file_response(filePath, context->writePosition, totalLength);
+
     if (response == nullptr)
     {
-      CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP response for %s to be filled from %s", m_port, request.pathUrl.c_str(), filePath.c_str());
-      return MHD_NO;
-    }
+      // in the pooled mode the file is read by the workers instead of the polling threads
+      context->workers = m_workers.get();
+      context->connection = request.connection;
+
+      // create the response object
+      response = MHD_create_response_from_callback(totalLength, 2048,
+                                                    &CWebServer::ContentReaderCallback,
+                                                    context.get(),
+                                                    &CWebServer::ContentReaderFreeCallback);
+      if (response == nullptr)
+      {
+        CLog::Log(LOGERROR, "CWebServer[%hu]: failed to create a HTTP response for %s to be filled from %s", m_port, request.pathUrl.c_str(), filePath.c_str());
+        return MHD_NO;
+      }
 
-    context.release(); // ownership was passed to mhd
+      context.release(); // ownership was passed to mhd
+    }
 
     // add Content-Range header
     if (ranged)
@@ -935,6 +1107,34 @@ void CWebServer::LogRequest(const char* uri) const
   CLog::Log(LOGDEBUG, "CWebServer[%hu]: request received for %s", m_port, uri);
 }
 
+static bool IsReadAhead(const HttpFileDownloadContext* context)
+{
+  return context->writePosition >= context->readPosition &&
+         context->writePosition < context->readPosition + context->readLength;
+}
+
+static void ReadAhead(HttpFileDownloadContext* context, uint64_t position, size_t length)
+{
+  context->readPosition = position;
+  context->readLength = 0;
+  context->readBuffer.resize(length);
+
+  // seek to the position if necessary
+  if (context->file->GetPosition() < 0 || position != static_cast<uint64_t>(context->file->GetPosition()))
+    context->file->Seek(position);
+
+  while (context->readLength < length)
+  {
+    ssize_t res = context->file->Read(context->readBuffer.data() + context->readLength, length - context->readLength);
+    if (res <= 0)
+      break;
+
+    context->readLength += res;
+  }
+
+  context->readFailed = context->readLength == 0;
+}
+
 ssize_t CWebServer::ContentReaderCallback(void *cls, uint64_t pos, char *buf, size_t max)
 {
   HttpFileDownloadContext *context = (HttpFileDownloadContext *)cls;
@@ -965,6 +1165,33 @@ ssize_t CWebServer::ContentReaderCallback(void *cls, uint64_t pos, char *buf, si
   uint64_t maximum = (uint64_t)max;
   int written = 0;
 
+  // check if the current position is within this range
+  // if not, set it to the start position
+  if (context->writePosition < start || context->writePosition > end)
+    context->writePosition = start;
+
+  // in the pooled mode the data has to be read ahead by a worker
+  if (context->workers != nullptr && !IsReadAhead(context))
+  {
+    // the worker didn't get any data at this position
+    if (context->readFailed && context->readPosition == context->writePosition)
+      return -1;
+
+    uint64_t position = context->writePosition;
+    size_t length = static_cast<size_t>(std::min<uint64_t>(FILE_READAHEAD_SIZE, end - position + 1));
+
+    // the connection isn't polled until the worker has read the data, we are called again afterwards
+    MHD_suspend_connection(context->connection);
+    if (context->workers->Queue([context, position, length]() {
+          ReadAhead(context, position, length);
+          MHD_resume_connection(context->connection);
+        }))
+      return 0;
+
+    MHD_resume_connection(context->connection);
+    ReadAhead(context, position, length);
+  }
+
   if (context->rangeCountTotal > 1 && !context->boundaryWritten)
   {
     // add a newline before any new multipart boundary
@@ -991,19 +1218,27 @@ ssize_t CWebServer::ContentReaderCallback(void *cls, uint64_t pos, char *buf, si
     context->boundaryWritten = true;
   }
 
-  // check if the current position is within this range
-  // if not, set it to the start position
-  if (context->writePosition < start || context->writePosition > end)
-    context->writePosition = start;
   // adjust the maximum number of read bytes
   maximum = std::min(maximum, end - context->writePosition + 1);
 
-  // seek to the position if necessary
-  if (context->file->GetPosition() < 0 || context->writePosition != static_cast<uint64_t>(context->file->GetPosition()))
-    context->file->Seek(context->writePosition);
+  ssize_t res;
+  if (context->workers != nullptr)
+  {
+    // copy the data read ahead by the worker
+    uint64_t offset = context->writePosition - context->readPosition;
+    res = static_cast<ssize_t>(std::min<uint64_t>(maximum, context->readLength - offset));
+    if (res > 0)
+      memcpy(buf, context->readBuffer.data() + offset, res);
+  }
+  else
+  {
+    // seek to the position if necessary
+    if (context->file->GetPosition() < 0 || context->writePosition != static_cast<uint64_t>(context->file->GetPosition()))
+      context->file->Seek(context->writePosition);
 
-  // read data from the file
-  ssize_t res = context->file->Read(buf, static_cast<size_t>(maximum));
+    // read data from the file
+    res = context->file->Read(buf, static_cast<size_t>(maximum));
+  }
   if (res <= 0)
     return -1;
 
@@ -1106,18 +1341,40 @@ struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
 
   MHD_set_panic_func(&panicHandlerForMHD, nullptr);
 
+  // one thread per connection
+  // WARNING: set MHD_OPTION_CONNECTION_TIMEOUT to something higher than 1
+  // otherwise on libmicrohttpd 0.4.4-1 it spins a busy loop
+  unsigned int threading = MHD_USE_THREAD_PER_CONNECTION
+#if (MHD_VERSION >= 0x00095207)
+                         | MHD_USE_INTERNAL_POLLING_THREAD /* MHD_USE_THREAD_PER_CONNECTION must be used only with MHD_USE_INTERNAL_POLLING_THREAD since 0.9.54 */
+#endif
+                         ;
+  unsigned int connectionLimit = MAX_CONNECTIONS;
+  unsigned int pollingThreads = 0;
+#if (MHD_VERSION >= 0x00095208)
+  if (m_workers != nullptr)
+  {
+    // a few threads polling all connections, long running requests are handled by the workers
+    threading = MHD_USE_INTERNAL_POLLING_THREAD | MHD_ALLOW_SUSPEND_RESUME |
+                (MHD_is_feature_supported(MHD_FEATURE_EPOLL) == MHD_YES ? MHD_USE_EPOLL : MHD_USE_AUTO);
+    connectionLimit = MAX_CONNECTIONS_POOLED;
+    pollingThreads = POLLING_THREADS;
+  }
+#endif
+
+  struct MHD_OptionItem threadingOptions[] = {
+    { MHD_OPTION_CONNECTION_LIMIT, static_cast<intptr_t>(connectionLimit), nullptr },
+    { MHD_OPTION_THREAD_STACK_SIZE, static_cast<intptr_t>(m_thread_stacksize), nullptr },
+    { pollingThreads > 0 ? MHD_OPTION_THREAD_POOL_SIZE : MHD_OPTION_END, static_cast<intptr_t>(pollingThreads), nullptr },
+    { MHD_OPTION_END, 0, nullptr }
+  };
+
   if (CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(CSettings::SETTING_SERVICES_WEBSERVERSSL) &&
       MHD_is_feature_supported(MHD_FEATURE_SSL) == MHD_YES &&
       LoadCert(m_key, m_cert))
     // SSL enabled
     return MHD_start_daemon(flags |
-                          // one thread per connection
-                          // WARNING: set MHD_OPTION_CONNECTION_TIMEOUT to something higher than 1
-                          // otherwise on libmicrohttpd 0.4.4-1 it spins a busy loop
-                          MHD_USE_THREAD_PER_CONNECTION
-#if (MHD_VERSION >= 0x00095207)
-                          | MHD_USE_INTERNAL_POLLING_THREAD /* MHD_USE_THREAD_PER_CONNECTION must be used only with MHD_USE_INTERNAL_POLLING_THREAD since 0.9.54 */
-#endif
+                          threading
                           | MHD_USE_DEBUG /* Print MHD error messages to log */
                           | MHD_USE_SSL
                           ,
@@ -1127,11 +1384,10 @@ struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
                           &CWebServer::AnswerToConnection,
                           this,
 
-                          MHD_OPTION_CONNECTION_LIMIT, 512,
+                          MHD_OPTION_ARRAY, threadingOptions,
                           MHD_OPTION_CONNECTION_TIMEOUT, timeout,
                           MHD_OPTION_URI_LOG_CALLBACK, &CWebServer::UriRequestLogger, this,
                           MHD_OPTION_EXTERNAL_LOGGER, &logFromMHD, 0,
-                          MHD_OPTION_THREAD_STACK_SIZE, m_thread_stacksize,
                           MHD_OPTION_HTTPS_MEM_KEY, m_key.c_str(),
                           MHD_OPTION_HTTPS_MEM_CERT, m_cert.c_str(),
                           MHD_OPTION_HTTPS_PRIORITIES, ciphers,
@@ -1139,13 +1395,7 @@ struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
 
   // No SSL
   return MHD_start_daemon(flags |
-                          // one thread per connection
-                          // WARNING: set MHD_OPTION_CONNECTION_TIMEOUT to something higher than 1
-                          // otherwise on libmicrohttpd 0.4.4-1 it spins a busy loop
-                          MHD_USE_THREAD_PER_CONNECTION
-#if (MHD_VERSION >= 0x00095207)
-                          | MHD_USE_INTERNAL_POLLING_THREAD /* MHD_USE_THREAD_PER_CONNECTION must be used only with MHD_USE_INTERNAL_POLLING_THREAD since 0.9.54 */
-#endif
+                          threading
                           | MHD_USE_DEBUG /* Print MHD error messages to log */
                           ,
                           port,
@@ -1154,11 +1404,10 @@ struct MHD_Daemon* CWebServer::StartMHD(unsigned int flags, int port)
                           &CWebServer::AnswerToConnection,
                           this,
 
-                          MHD_OPTION_CONNECTION_LIMIT, 512,
+                          MHD_OPTION_ARRAY, threadingOptions,
                           MHD_OPTION_CONNECTION_TIMEOUT, timeout,
                           MHD_OPTION_URI_LOG_CALLBACK, &CWebServer::UriRequestLogger, this,
                           MHD_OPTION_EXTERNAL_LOGGER, &logFromMHD, 0,
-                          MHD_OPTION_THREAD_STACK_SIZE, m_thread_stacksize,
                           MHD_OPTION_END);
 }
 
@@ -1167,6 +1416,15 @@ bool CWebServer::Start(uint16_t port, const std::string &username, const std::st
   SetCredentials(username, password);
   if (!m_running)
   {
+    m_sendFile = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_webserverSendFile;
+
+    unsigned int workers = 0;
+#if (MHD_VERSION >= 0x00095208)
+    workers = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_webserverWorkers;
+    if (workers > 0)
+      m_workers.reset(new CWebServerWorkers(workers));
+#endif
+
     int v6testSock;
     if ((v6testSock = socket(AF_INET6, SOCK_STREAM, 0)) >= 0)
     {
@@ -1179,10 +1437,16 @@ bool CWebServer::Start(uint16_t port, const std::string &username, const std::st
     if (m_running)
     {
       m_port = port;
-      CLog::Log(LOGNOTICE, "CWebServer[%hu]: Started", m_port);
+      if (m_workers != nullptr)
+        CLog::Log(LOGNOTICE, "CWebServer[%hu]: Started with %u workers", m_port, workers);
+      else
+        CLog::Log(LOGNOTICE, "CWebServer[%hu]: Started", m_port);
     }
     else
+    {
       CLog::Log(LOGERROR, "CWebServer[%hu]: Failed to start", port);
+      m_workers.reset();
+    }
   }
 
   return m_running;
@@ -1193,12 +1457,17 @@ bool CWebServer::Stop()
   if (!m_running)
     return true;
 
+  // the workers resume the connections they hold before the daemons are stopped
+  if (m_workers != nullptr)
+    m_workers->Stop();
+
   if (m_daemon_ip6 != nullptr)
     MHD_stop_daemon(m_daemon_ip6);
 
   if (m_daemon_ip4 != nullptr)
     MHD_stop_daemon(m_daemon_ip4);
 
+  m_workers.reset();
   m_running = false;
   CLog::Log(LOGNOTICE, "CWebServer[%hu]: Stopped", m_port);
   m_port = 0;
@@ -20,12 +20,13 @@ namespace XFILE
 }
 class CDateTime;
 class CVariant;
+class CWebServerWorkers;
 
 class CWebServer
 {
 public:
   CWebServer();
-  virtual ~CWebServer() = default;
+  virtual ~CWebServer();
 
   bool Start(uint16_t port, const std::string &username, const std::string &password);
   bool Stop();
@@ -44,6 +45,10 @@ protected:
     std::shared_ptr<IHTTPRequestHandler> requestHandler;
     struct MHD_PostProcessor *postprocessor;
     int errorStatus;
+    bool handled; ///< the request handler was run by a worker
+    int handleResult;
+    std::shared_ptr<XFILE::CFile> file; ///< file to download opened by the worker
+    int fileStatus; ///< HTTP status of opening the file, 0 if it hasn't been opened
 
     explicit ConnectionHandler(const std::string& uri)
       : fullUri(uri)
@@ -51,6 +56,9 @@ protected:
       , requestHandler(nullptr)
       , postprocessor(nullptr)
       , errorStatus(MHD_HTTP_OK)
+      , handled(false)
+      , handleResult(MHD_NO)
+      , fileStatus(0)
     { }
   } ConnectionHandler;
 
@@ -59,6 +67,8 @@ protected:
   virtual int HandlePartialRequest(struct MHD_Connection *connection, ConnectionHandler* connectionHandler, const HTTPRequest& request,
                                    const char *upload_data, size_t *upload_data_size, void **con_cls);
   virtual int HandleRequest(const std::shared_ptr<IHTTPRequestHandler>& handler);
+  int DispatchRequest(std::unique_ptr<ConnectionHandler>& connectionHandler, const std::shared_ptr<IHTTPRequestHandler>& handler, void **con_cls);
+  int RespondToRequest(const std::shared_ptr<IHTTPRequestHandler>& handler, int handleResult, const ConnectionHandler* connectionHandler = nullptr);
   virtual int FinalizeRequest(const std::shared_ptr<IHTTPRequestHandler>& handler, int responseStatus, struct MHD_Response *response);
 
 private:
@@ -71,6 +81,7 @@ private:
 
   bool IsRequestCacheable(const HTTPRequest& request) const;
   bool IsRequestRanged(const HTTPRequest& request, const CDateTime &lastModified) const;
+  bool IsETagMatched(const HTTPRequest& request, const std::string &etag) const;
 
   void SetupPostDataProcessing(const HTTPRequest& request, ConnectionHandler *connectionHandler, std::shared_ptr<IHTTPRequestHandler> handler, void **con_cls) const;
   bool ProcessPostData(const HTTPRequest& request, ConnectionHandler *connectionHandler, const char *upload_data, size_t *upload_data_size, void **con_cls) const;
@@ -80,7 +91,8 @@ private:
   int CreateRangedMemoryDownloadResponse(const std::shared_ptr<IHTTPRequestHandler>& handler, struct MHD_Response *&response) const;
 
   int CreateRedirect(struct MHD_Connection *connection, const std::string &strURL, struct MHD_Response *&response) const;
-  int CreateFileDownloadResponse(const std::shared_ptr<IHTTPRequestHandler>& handler, struct MHD_Response *&response) const;
+  int OpenFileDownload(const std::shared_ptr<IHTTPRequestHandler>& handler, std::shared_ptr<XFILE::CFile>& file) const;
+  int CreateFileDownloadResponse(const std::shared_ptr<IHTTPRequestHandler>& handler, const std::shared_ptr<XFILE::CFile>& file, struct MHD_Response *&response) const;
   int CreateErrorResponse(struct MHD_Connection *connection, int responseType, HTTPMethod method, struct MHD_Response *&response) const;
   int CreateMemoryDownloadResponse(struct MHD_Connection *connection, const void *data, size_t size, bool free, bool copy, struct MHD_Response *&response) const;
 
@@ -123,4 +135,6 @@ private:
   std::string m_cert;
   mutable CCriticalSection m_critSection;
   std::vector<IHTTPRequestHandler *> m_requestHandlers;
+  std::unique_ptr<CWebServerWorkers> m_workers; ///< only set in the pooled mode
+  bool m_sendFile = true; ///< whether local files are sent from their file descriptor
 };
@@ -0,0 +1,69 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "WebServerWorkers.h"
+
+#include "threads/SingleLock.h"
+
+CWebServerWorkers::CWebServerWorkers(unsigned int threads)
+{
+  for (unsigned int i = 0; i < threads; i++)
+  {
+    m_threads.emplace_back(new CThread(this, "WebServerWorker"));
+    m_threads.back()->Create();
+  }
+}
+
+CWebServerWorkers::~CWebServerWorkers()
+{
+  Stop();
+}
+
+bool CWebServerWorkers::Queue(const Job& job)
+{
+  CSingleLock lock(m_section);
+  if (m_stop || m_threads.empty())
+    return false;
+
+  m_jobs.push_back(job);
+  m_queued.notify();
+  return true;
+}
+
+void CWebServerWorkers::Stop()
+{
+  {
+    CSingleLock lock(m_section);
+    m_stop = true;
+    m_queued.notifyAll();
+  }
+
+  // queued jobs hold suspended connections, they are still run
+  for (auto& thread : m_threads)
+    thread->StopThread(true);
+  m_threads.clear();
+}
+
+void CWebServerWorkers::Run()
+{
+  CSingleLock lock(m_section);
+  while (!m_stop || !m_jobs.empty())
+  {
+    if (m_jobs.empty())
+    {
+      m_queued.wait(lock);
+      continue;
+    }
+
+    Job job = std::move(m_jobs.front());
+    m_jobs.pop_front();
+
+    CSingleExit exit(m_section);
+    job();
+  }
+}
@@ -0,0 +1,56 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/IRunnable.h"
+#include "threads/Thread.h"
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+/*!
+ \brief Fixed pool of threads running the long running requests of the web server.
+
+ In the pooled mode a few threads poll all connections of the web server, a
+ request handler blocking on them would hold up every other connection. Such
+ requests are queued to the workers instead while their connection is
+ suspended.
+ */
+class CWebServerWorkers : public IRunnable
+{
+public:
+  typedef std::function<void()> Job;
+
+  explicit CWebServerWorkers(unsigned int threads);
+  ~CWebServerWorkers() override;
+
+  /*! \brief Queue a job to be run by one of the workers.
+   \return false if the workers are stopped and the job has to be run by the caller
+   */
+  bool Queue(const Job& job);
+
+  /*! \brief Stop the workers once all queued jobs are done.
+   */
+  void Stop();
+
+  // implementation of IRunnable
+  void Run() override;
+
+private:
+  bool m_stop = false;
+  std::deque<Job> m_jobs;
+
+  std::vector<std::unique_ptr<CThread>> m_threads;
+  CCriticalSection m_section;
+  XbmcThreads::ConditionVariable m_queued;
+};
@@ -9,8 +9,10 @@
 #include <map>
 
 #include "HTTPImageTransformationHandler.h"
+#include "TextureCache.h"
 #include "TextureCacheJob.h"
 #include "URL.h"
+#include "filesystem/File.h"
 #include "filesystem/ImageFile.h"
 #include "network/WebServer.h"
 #include "network/httprequesthandler/HTTPRequestHandlerUtils.h"
@@ -86,7 +88,7 @@ CHTTPImageTransformationHandler::CHTTPImageTransformationHandler(const HTTPReque
 CHTTPImageTransformationHandler::~CHTTPImageTransformationHandler()
 {
   m_responseData.clear();
-  delete m_buffer;
+  delete[] m_buffer;
   m_buffer = NULL;
 }
 
@@ -142,9 +144,16 @@ int CHTTPImageTransformationHandler::HandleRequest()
     imagePath += StringUtils::Join(urlOptions, "&");
   }
 
-  // resize the image into the local buffer
+  // take the transformed image from the texture cache, it's only decoded and
+  // resized once no matter how many identical requests come in at the same time
   size_t bufferSize;
-  if (!CTextureCacheJob::ResizeTexture(imagePath, m_buffer, bufferSize))
+  bool transformed = StringUtils::StartsWith(imagePath, "image://") && LoadCachedImage(imagePath, bufferSize);
+
+  // otherwise resize the image into the local buffer
+  if (!transformed)
+    transformed = CTextureCacheJob::ResizeTexture(imagePath, m_buffer, bufferSize);
+
+  if (!transformed)
   {
     m_response.status = MHD_HTTP_INTERNAL_SERVER_ERROR;
     m_response.type = HTTPError;
@@ -168,6 +177,40 @@ int CHTTPImageTransformationHandler::HandleRequest()
   return MHD_YES;
 }
 
+bool CHTTPImageTransformationHandler::LoadCachedImage(const std::string &imagePath, size_t &bufferSize)
+{
+  CTextureDetails details;
+  if (!CTextureCache::GetInstance().CacheImage(imagePath, details))
+    return false;
+
+  XFILE::CFile file;
+  if (!file.Open(CTextureCache::GetCachedPath(details.file), XFILE::READ_NO_CACHE))
+    return false;
+
+  int64_t length = file.GetLength();
+  if (length <= 0)
+    return false;
+
+  m_buffer = new uint8_t[length];
+  if (file.Read(m_buffer, length) != length)
+  {
+    delete[] m_buffer;
+    m_buffer = NULL;
+    return false;
+  }
+  bufferSize = static_cast<size_t>(length);
+
+  // the cached image is either a JPEG or a PNG
+  std::string ext = URIUtils::GetExtension(details.file);
+  StringUtils::ToLower(ext);
+  m_response.contentType = CMime::GetMimeType(ext);
+
+  // the cached file only changes along with the hash of the source image
+  m_etag = StringUtils::Format("\"%s-%s\"", URIUtils::GetFileName(details.file).c_str(), details.hash.c_str());
+
+  return true;
+}
+
 bool CHTTPImageTransformationHandler::GetLastModifiedDate(CDateTime &lastModified) const
 {
   if (!m_lastModified.IsValid())
@@ -176,3 +219,12 @@ bool CHTTPImageTransformationHandler::GetLastModifiedDate(CDateTime &lastModifie
   lastModified = m_lastModified;
   return true;
 }
+
+bool CHTTPImageTransformationHandler::GetETag(std::string &etag) const
+{
+  if (m_etag.empty())
+    return false;
+
+  etag = m_etag;
+  return true;
+}
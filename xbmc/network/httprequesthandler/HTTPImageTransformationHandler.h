@@ -27,7 +27,9 @@ public:
 
   bool CanHandleRanges() const override { return true; }
   bool CanBeCached() const override { return true; }
+  bool IsLongRunning() const override { return true; }
   bool GetLastModifiedDate(CDateTime &lastModified) const override;
+  bool GetETag(std::string &etag) const override;
 
   HttpResponseRanges GetResponseData() const override { return m_responseData; }
 
@@ -38,8 +40,11 @@ protected:
   explicit CHTTPImageTransformationHandler(const HTTPRequest &request);
 
 private:
+  bool LoadCachedImage(const std::string &imagePath, size_t &bufferSize);
+
   std::string m_url;
   CDateTime m_lastModified;
+  std::string m_etag;
 
   uint8_t* m_buffer;
   HttpResponseRanges m_responseData;
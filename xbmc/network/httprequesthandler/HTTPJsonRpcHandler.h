@@ -26,6 +26,8 @@ public:
 
   int HandleRequest() override;
 
+  bool IsLongRunning() const override { return true; }
+
   HttpResponseRanges GetResponseData() const override;
 
   int GetPriority() const override { return 5; }
@@ -126,6 +126,14 @@ public:
   */
   virtual bool CanBeCached() const { return false; }
 
+  /*!
+   * \brief Whether handling the request may block for a long time.
+   *
+   * \details If the web server polls its connections with a few threads such
+   * requests are handled by one of its workers.
+   */
+  virtual bool IsLongRunning() const { return false; }
+
   /*!
   * \brief Returns the maximum age (in seconds) for which the response can be cached.
   *
@@ -140,6 +148,14 @@ public:
   */
   virtual bool GetLastModifiedDate(CDateTime &lastModified) const { return false; }
 
+  /*!
+  * \brief Returns the strong entity tag of the response data.
+  *
+  * \details This is only used if the response can be cached. It is only
+  * asked for after the request has been handled.
+  */
+  virtual bool GetETag(std::string &etag) const { return false; }
+
   /*!
    * \brief Returns the ranges with raw data belonging to the response.
    *
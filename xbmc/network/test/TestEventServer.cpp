@@ -0,0 +1,206 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "network/EventClient.h"
+#include "network/EventPacket.h"
+#include "network/EventServer.h"
+#include "platform/linux/XTimeUtils.h"
+#include "settings/Settings.h"
+#include "settings/SettingsComponent.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/StringUtils.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+// packets sent per second and for how long
+#define PACKET_RATE 10000
+#define PACKET_SECONDS 2
+#define CLIENT_TOKEN 0x4b6f6469
+
+using namespace EVENTPACKET;
+
+class TestEventServer : public testing::Test
+{
+protected:
+  class CTestEventServer : public EVENTSERVER::CEventServer
+  {
+  public:
+    /*! \brief Take the next action of any client, as ExecuteNextAction() does but without executing it. */
+    bool TakeNextAction(EVENTCLIENT::CEventAction& action)
+    {
+      CSingleLock lock(m_critSection);
+      for (auto& client : m_clients)
+      {
+        if (client.second->GetNextAction(action))
+          return true;
+      }
+      return false;
+    }
+  };
+
+  TestEventServer()
+  {
+    std::random_device rd;
+    std::mt19937 mt(rd());
+    std::uniform_int_distribution<uint16_t> dist(49152, 65535);
+    port = dist(mt);
+  }
+
+  void SetUp() override
+  {
+    const std::shared_ptr<CSettings> settings = CServiceBroker::GetSettingsComponent()->GetSettings();
+    settings->SetInt(CSettings::SETTING_SERVICES_ESPORT, port);
+    settings->SetInt(CSettings::SETTING_SERVICES_ESPORTRANGE, 1);
+    settings->SetBool(CSettings::SETTING_SERVICES_ESALLINTERFACES, false);
+
+    server.StartServer();
+    XbmcThreads::EndTime end(5000);
+    while (!server.Running() && !end.IsTimePast())
+      Sleep(10);
+    ASSERT_TRUE(server.Running());
+
+    client = socket(AF_INET, SOCK_DGRAM, 0);
+    ASSERT_GE(client, 0);
+
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    ASSERT_EQ(0, connect(client, (struct sockaddr*)&addr, sizeof(addr)));
+  }
+
+  void TearDown() override
+  {
+    if (client >= 0)
+      close(client);
+    server.StopServer(true);
+  }
+
+  /*! \brief Build a single packet PT_ACTION datagram queuing the given action. */
+  static std::string CreateActionPacket(const std::string& action)
+  {
+    std::string payload;
+    payload += static_cast<char>(AT_BUTTON);
+    payload += action;
+    payload += '\0';
+
+    unsigned char header[HEADER_SIZE] = {};
+    memcpy(header, HEADER_SIG, HEADER_SIG_LENGTH);
+    header[4] = 2; // major version
+    header[5] = 0; // minor version
+    uint16_t type = htons(PT_ACTION);
+    memcpy(header + 6, &type, 2);
+    uint32_t sequence = htonl(1);
+    memcpy(header + 8, &sequence, 4);
+    uint32_t total = htonl(1);
+    memcpy(header + 12, &total, 4);
+    uint16_t payloadSize = htons(static_cast<uint16_t>(payload.size()));
+    memcpy(header + 16, &payloadSize, 2);
+    uint32_t token = htonl(CLIENT_TOKEN);
+    memcpy(header + 18, &token, 4);
+
+    return std::string(reinterpret_cast<char*>(header), HEADER_SIZE) + payload;
+  }
+
+  uint16_t port;
+  int client = -1;
+  CTestEventServer server;
+};
+
+TEST_F(TestEventServer, PacketsAreRecycled)
+{
+  std::string data = CreateActionPacket("select");
+
+  CEventPacket* packet = new CEventPacket(static_cast<int>(data.size()), data.c_str());
+  ASSERT_TRUE(packet->IsValid());
+  EXPECT_EQ(PT_ACTION, packet->Type());
+  EXPECT_EQ(data.size() - HEADER_SIZE, packet->PayloadSize());
+  delete packet;
+
+  // the next packet takes the place of the deleted one
+  CEventPacket* recycled = new CEventPacket(static_cast<int>(data.size()), data.c_str());
+  EXPECT_EQ(packet, recycled);
+  ASSERT_TRUE(recycled->IsValid());
+  EXPECT_EQ(0, memcmp(recycled->Payload(), data.c_str() + HEADER_SIZE, recycled->PayloadSize()));
+  delete recycled;
+}
+
+TEST_F(TestEventServer, HandlesLoadWithLowLatency)
+{
+  const int count = PACKET_RATE * PACKET_SECONDS;
+  std::vector<std::chrono::steady_clock::time_point> sent(count);
+  std::vector<double> latencies;
+  latencies.reserve(count);
+
+  // take the actions as the application thread would, only more often
+  std::atomic_bool sending(true);
+  std::thread receiver([&]() {
+    XbmcThreads::EndTime end((PACKET_SECONDS + 5) * 1000);
+    while (static_cast<int>(latencies.size()) < count && !end.IsTimePast())
+    {
+      EVENTCLIENT::CEventAction action;
+      if (!server.TakeNextAction(action))
+      {
+        if (!sending && end.MillisLeft() > 1000)
+          end.Set(1000); // everything still in flight arrives within a second
+        std::this_thread::sleep_for(std::chrono::microseconds(200));
+        continue;
+      }
+
+      auto now = std::chrono::steady_clock::now();
+      int index = std::stoi(action.actionName.substr(action.actionName.find(':') + 1));
+      std::chrono::duration<double, std::milli> latency = now - sent[index];
+      latencies.push_back(latency.count());
+    }
+  });
+
+  // send in slices of a millisecond to keep the rate steady
+  auto start = std::chrono::steady_clock::now();
+  const int perSlice = PACKET_RATE / 1000;
+  for (int i = 0; i < count; i++)
+  {
+    if (i % perSlice == 0)
+      std::this_thread::sleep_until(start + std::chrono::milliseconds(i / perSlice));
+
+    std::string data = CreateActionPacket(StringUtils::Format("test:%d", i));
+    sent[i] = std::chrono::steady_clock::now();
+    send(client, data.c_str(), data.size(), 0);
+  }
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+  sending = false;
+  receiver.join();
+
+  ASSERT_FALSE(latencies.empty());
+  std::sort(latencies.begin(), latencies.end());
+  double median = latencies[latencies.size() / 2];
+  double percentile99 = latencies[latencies.size() * 99 / 100];
+
+  std::cout << "[ BENCH    ] " << static_cast<int>(count / elapsed.count()) << " packets/s: "
+            << latencies.size() << " of " << count << " actions, "
+            << "median " << median << " ms, 99th percentile " << percentile99 << " ms" << std::endl;
+
+  // loopback datagrams are rarely dropped, the bounds are loose for busy machines
+  EXPECT_GE(latencies.size(), static_cast<size_t>(count * 9 / 10));
+  EXPECT_LT(median, 50.0);
+}
@@ -0,0 +1,156 @@
+/*
+ *  Copyright (C) 2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "ServiceBroker.h"
+#include "interfaces/AnnouncementManager.h"
+#include "interfaces/json-rpc/JSONRPC.h"
+#include "network/TCPServer.h"
+#include "platform/linux/XTimeUtils.h"
+#include "threads/SystemClock.h"
+#include "utils/StringUtils.h"
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <memory>
+#include <random>
+#include <string>
+
+#include <gtest/gtest.h>
+
+// calls of the batch, each echoes an id of REPLY_ID_SIZE bytes
+#define REPLY_CALLS 6
+#define REPLY_ID_SIZE (1024 * 1024)
+#define ANNOUNCEMENTS 20
+
+class TestTCPServer : public testing::Test
+{
+protected:
+  TestTCPServer()
+  {
+    std::random_device rd;
+    std::mt19937 mt(rd());
+    std::uniform_int_distribution<uint16_t> dist(49152, 65535);
+    port = dist(mt);
+  }
+
+  void SetUp() override
+  {
+    announcementManager = std::make_shared<ANNOUNCEMENT::CAnnouncementManager>();
+    announcementManager->Start();
+    CServiceBroker::RegisterAnnouncementManager(announcementManager);
+    JSONRPC::CJSONRPC::Initialize();
+
+    ASSERT_TRUE(JSONRPC::CTCPServer::StartServer(port, false));
+  }
+
+  void TearDown() override
+  {
+    if (client >= 0)
+      close(client);
+    JSONRPC::CTCPServer::StopServer(true);
+    JSONRPC::CJSONRPC::Cleanup();
+    announcementManager->Deinitialize();
+    CServiceBroker::UnregisterAnnouncementManager();
+  }
+
+  bool Connect()
+  {
+    client = socket(AF_INET, SOCK_STREAM, 0);
+    if (client < 0)
+      return false;
+
+    struct timeval timeout = { 1, 0 };
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    return connect(client, (struct sockaddr*)&addr, sizeof(addr)) == 0;
+  }
+
+  bool SendAll(const std::string& data)
+  {
+    size_t sent = 0;
+    while (sent < data.size())
+    {
+      ssize_t result = send(client, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+      if (result <= 0)
+        return false;
+      sent += result;
+    }
+    return true;
+  }
+
+  /*! \brief Wait until the server has started to reply, without reading it. */
+  bool WaitForReply(unsigned int timeout)
+  {
+    XbmcThreads::EndTime end(timeout);
+    char c;
+    while (!end.IsTimePast())
+    {
+      if (recv(client, &c, 1, MSG_PEEK | MSG_DONTWAIT) > 0)
+        return true;
+      Sleep(10);
+    }
+    return false;
+  }
+
+  static size_t Count(const std::string& data, const std::string& what)
+  {
+    size_t count = 0;
+    for (size_t pos = data.find(what); pos != std::string::npos; pos = data.find(what, pos + what.size()))
+      count++;
+    return count;
+  }
+
+  uint16_t port;
+  int client = -1;
+  std::shared_ptr<ANNOUNCEMENT::CAnnouncementManager> announcementManager;
+};
+
+TEST_F(TestTCPServer, ReceivesReplyLargerThanTheLimitWhileAnnouncing)
+{
+  ASSERT_TRUE(Connect());
+
+  // the batch reply is larger than the limit of queued announcements
+  const std::string id(REPLY_ID_SIZE, 'x');
+  std::string request = "[";
+  for (int i = 0; i < REPLY_CALLS; i++)
+    request += StringUtils::Format("%s{\"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Ping\", \"id\": \"%d%s\"}", i > 0 ? "," : "", i, id.c_str());
+  request += "]";
+  ASSERT_TRUE(SendAll(request));
+
+  // the reply is queued but not read, announcements are queued behind it
+  ASSERT_TRUE(WaitForReply(10000));
+  for (int i = 0; i < ANNOUNCEMENTS; i++)
+  {
+    CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::Other, "xbmc", "OnTestAnnouncement");
+    Sleep(20);
+  }
+
+  // the whole reply and all announcements arrive on the open connection
+  std::string received;
+  char buffer[64 * 1024];
+  XbmcThreads::EndTime end(30000);
+  while (!end.IsTimePast() &&
+         (Count(received, "\"pong\"") < REPLY_CALLS || Count(received, "OnTestAnnouncement") < ANNOUNCEMENTS))
+  {
+    ssize_t read = recv(client, buffer, sizeof(buffer), 0);
+    if (read == 0)
+      break;
+    if (read > 0)
+      received.append(buffer, read);
+  }
+
+  EXPECT_EQ(static_cast<size_t>(REPLY_CALLS), Count(received, "\"pong\""));
+  EXPECT_EQ(static_cast<size_t>(ANNOUNCEMENTS), Count(received, "OnTestAnnouncement"));
+}
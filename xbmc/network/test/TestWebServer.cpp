@@ -14,21 +14,33 @@
 #include <stdlib.h>
 
 #include <gtest/gtest.h>
+#include "TextureCache.h"
+#include "TextureDatabase.h"
 #include "URL.h"
 #include "filesystem/CurlFile.h"
 #include "filesystem/File.h"
 #include "interfaces/json-rpc/JSONRPC.h"
 #include "network/WebServer.h"
 #include "network/httprequesthandler/HTTPVfsHandler.h"
+#include "network/httprequesthandler/HTTPImageTransformationHandler.h"
 #include "network/httprequesthandler/HTTPJsonRpcHandler.h"
+#include "ServiceBroker.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/MediaSourceSettings.h"
+#include "settings/SettingsComponent.h"
 #include "test/TestUtils.h"
 #include "utils/JSONVariantParser.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
 #include <random>
+#include <thread>
+#include <vector>
 
 using namespace XFILE;
 
@@ -40,6 +52,7 @@ using namespace XFILE;
 #define TEST_FILES_DATA_RANGES  "range1;range2;range3"
 #define TEST_FILES_HTML         TEST_FILES_DATA ".html"
 #define TEST_FILES_RANGES       TEST_FILES_DATA "-ranges.txt"
+#define TEST_FILES_IMAGE        TEST_FILES_DATA ".png"
 
 class TestWebServer : public testing::Test
 {
@@ -65,10 +78,12 @@ protected:
   void SetUp() override
   {
     SetupMediaSources();
+    CTextureCache::GetInstance().Initialize();
 
     webserver.Start(webserverPort, "", "");
     webserver.RegisterRequestHandler(&m_jsonRpcHandler);
     webserver.RegisterRequestHandler(&m_vfsHandler);
+    webserver.RegisterRequestHandler(&m_imageTransformationHandler);
   }
 
   void TearDown() override
@@ -76,9 +91,11 @@ protected:
     if (webserver.IsStarted())
       webserver.Stop();
 
+    webserver.UnregisterRequestHandler(&m_imageTransformationHandler);
     webserver.UnregisterRequestHandler(&m_vfsHandler);
     webserver.UnregisterRequestHandler(&m_jsonRpcHandler);
 
+    CTextureCache::GetInstance().Deinitialize();
     TearDownMediaSources();
   }
 
@@ -121,6 +138,16 @@ protected:
     return GetUrl(path);
   }
 
+  std::string GetUrlOfTransformedTestImage(unsigned int width)
+  {
+    // the image is transformed through the texture cache, like the web interface requests it
+    std::string path = CTextureUtils::GetWrappedImageURL(URIUtils::AddFileToFolder(sourcePath, TEST_FILES_IMAGE));
+    path = CURL::Encode(path);
+    path = URIUtils::AddFileToFolder("image", path);
+
+    return GetUrl(path) + StringUtils::Format("?width=%u", width);
+  }
+
   bool GetLastModifiedOfTestFile(const std::string& testFile, CDateTime& lastModified)
   {
     CFile file;
@@ -334,6 +361,47 @@ protected:
     }
   }
 
+  void CheckTransformedTestImageResponse(const CCurlFile& curl, const std::string& result, int httpStatus, const std::string& etag)
+  {
+    // get the HTTP header details
+    const CHttpHeader& httpHeader = curl.GetHttpHeader();
+
+    // check the protocol line for the expected HTTP status
+    std::string httpStatusString = StringUtils::Format(" %d ", httpStatus);
+    std::string protocolLine = httpHeader.GetProtoLine();
+    ASSERT_TRUE(protocolLine.find(httpStatusString) != std::string::npos);
+
+    // the entity tag is sent along with the image and the 304 Not Modified response
+    EXPECT_STREQ(etag.c_str(), httpHeader.GetValue(MHD_HTTP_HEADER_ETAG).c_str());
+
+    if (httpStatus == MHD_HTTP_NOT_MODIFIED)
+      EXPECT_TRUE(result.empty());
+    else
+      EXPECT_FALSE(result.empty());
+  }
+
+  bool RestartWithWorkers(unsigned int workers)
+  {
+    // restart the webserver polling its connections and handling long running requests with workers
+    webserver.Stop();
+    unsigned int& webserverWorkers = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_webserverWorkers;
+    webserverWorkers = workers;
+    bool started = webserver.Start(webserverPort, "", "");
+    webserverWorkers = 0;
+    return started;
+  }
+
+  bool RestartWithSendFile(bool sendFile)
+  {
+    // restart the webserver sending local files from their file descriptor or through the content reader callback
+    webserver.Stop();
+    bool& webserverSendFile = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_webserverSendFile;
+    webserverSendFile = sendFile;
+    bool started = webserver.Start(webserverPort, "", "");
+    webserverSendFile = true;
+    return started;
+  }
+
   std::string GenerateRangeHeaderValue(unsigned int start, unsigned int end)
   {
     return StringUtils::Format("bytes=%u-%u", start, end);
@@ -342,6 +410,7 @@ protected:
   CWebServer webserver;
   CHTTPJsonRpcHandler m_jsonRpcHandler;
   CHTTPVfsHandler m_vfsHandler;
+  CHTTPImageTransformationHandler m_imageTransformationHandler;
   std::string baseUrl;
   std::string sourcePath;
   uint16_t webserverPort;
@@ -477,6 +546,34 @@ TEST_F(TestWebServer, CanReadDataOverJsonRpcWithHttpPost)
   JSONRPC::CJSONRPC::Cleanup();
 }
 
+TEST_F(TestWebServer, CanReadDataOverJsonRpcWithHttpPostBatch)
+{
+  // initialized JSON-RPC
+  JSONRPC::CJSONRPC::Initialize();
+
+  std::string result;
+  CCurlFile curl;
+  curl.SetMimeType("application/json");
+  ASSERT_TRUE(curl.Post(GetUrl(TEST_URL_JSONRPC), "[ { \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Version\", \"id\": 1 }, "
+                                                   "{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Ping\", \"id\": 2 }, "
+                                                   "{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Version\" }, "
+                                                   "{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Version\", \"id\": 3 } ]", result));
+  ASSERT_FALSE(result.empty());
+
+  // the read only calls are handled concurrently but answered in the order of the batch
+  CVariant resultObj;
+  ASSERT_TRUE(CJSONVariantParser::Parse(result, resultObj));
+  ASSERT_TRUE(resultObj.isArray());
+  ASSERT_EQ(3U, resultObj.size());
+  EXPECT_EQ(1, resultObj[0]["id"].asInteger());
+  EXPECT_EQ(2, resultObj[1]["id"].asInteger());
+  EXPECT_EQ(3, resultObj[2]["id"].asInteger());
+  EXPECT_STREQ("pong", resultObj[1]["result"].asString().c_str());
+
+  // uninitialize JSON-RPC
+  JSONRPC::CJSONRPC::Cleanup();
+}
+
 TEST_F(TestWebServer, CanModifyOverJsonRpcWithHttpPost)
 {
   // initialized JSON-RPC
@@ -547,6 +644,33 @@ TEST_F(TestWebServer, CanGetFile)
   CheckHtmlTestFileResponse(curl);
 }
 
+TEST_F(TestWebServer, CanHandleRequestsWithWorkers)
+{
+  ASSERT_TRUE(RestartWithWorkers(2));
+
+  // initialized JSON-RPC
+  JSONRPC::CJSONRPC::Initialize();
+
+  std::string result;
+  CCurlFile curl_jsonrpc;
+  curl_jsonrpc.SetMimeType("application/json");
+  ASSERT_TRUE(curl_jsonrpc.Post(GetUrl(TEST_URL_JSONRPC), "{ \"jsonrpc\": \"2.0\", \"method\": \"JSONRPC.Version\", \"id\": 1 }", result));
+
+  CVariant resultObj;
+  ASSERT_TRUE(CJSONVariantParser::Parse(result, resultObj));
+  EXPECT_TRUE(resultObj.isObject() && resultObj.isMember("result"));
+
+  // uninitialize JSON-RPC
+  JSONRPC::CJSONRPC::Cleanup();
+
+  CCurlFile curl_file;
+  curl_file.SetRequestHeader(MHD_HTTP_HEADER_RANGE, "");
+  ASSERT_TRUE(curl_file.Get(GetUrlOfTestFile(TEST_FILES_HTML), result));
+  ASSERT_STREQ(TEST_FILES_DATA, result.c_str());
+
+  CheckHtmlTestFileResponse(curl_file);
+}
+
 TEST_F(TestWebServer, CanGetFileForcingNoCache)
 {
   // check non-cacheable HTML with Control-Cache: no-cache
@@ -648,6 +772,85 @@ TEST_F(TestWebServer, CanGetCachedFileWithNewerIfModifiedSinceForcingNoCache)
   CheckRangesTestFileResponse(curl);
 }
 
+TEST_F(TestWebServer, CanGetTransformedImageWithETag)
+{
+  std::string result;
+  CCurlFile curl;
+  ASSERT_TRUE(curl.Get(GetUrlOfTransformedTestImage(8), result));
+
+  // the entity tag is a quoted strong tag
+  std::string etag = curl.GetHttpHeader().GetValue(MHD_HTTP_HEADER_ETAG);
+  ASSERT_GT(etag.size(), 2U);
+  EXPECT_EQ('"', etag.front());
+  EXPECT_EQ('"', etag.back());
+  CheckTransformedTestImageResponse(curl, result, MHD_HTTP_OK, etag);
+}
+
+TEST_F(TestWebServer, CanGetCachedTransformedImageWithMatchingIfNoneMatch)
+{
+  // get the entity tag of the transformed image
+  std::string result;
+  CCurlFile curl;
+  ASSERT_TRUE(curl.Get(GetUrlOfTransformedTestImage(8), result));
+  std::string etag = curl.GetHttpHeader().GetValue(MHD_HTTP_HEADER_ETAG);
+  ASSERT_FALSE(etag.empty());
+
+  // get the image again with a matching If-None-Match value
+  CCurlFile curl_cached;
+  curl_cached.SetRequestHeader(MHD_HTTP_HEADER_IF_NONE_MATCH, "\"other\", " + etag);
+  ASSERT_TRUE(curl_cached.Get(GetUrlOfTransformedTestImage(8), result));
+  CheckTransformedTestImageResponse(curl_cached, result, MHD_HTTP_NOT_MODIFIED, etag);
+}
+
+TEST_F(TestWebServer, CanGetCachedTransformedImageWithMismatchingIfNoneMatch)
+{
+  // get the entity tag of the transformed image
+  std::string result;
+  CCurlFile curl;
+  ASSERT_TRUE(curl.Get(GetUrlOfTransformedTestImage(8), result));
+  std::string etag = curl.GetHttpHeader().GetValue(MHD_HTTP_HEADER_ETAG);
+  ASSERT_FALSE(etag.empty());
+
+  // get the image again with a mismatching If-None-Match value
+  CCurlFile curl_cached;
+  curl_cached.SetRequestHeader(MHD_HTTP_HEADER_IF_NONE_MATCH, "\"other\"");
+  ASSERT_TRUE(curl_cached.Get(GetUrlOfTransformedTestImage(8), result));
+  CheckTransformedTestImageResponse(curl_cached, result, MHD_HTTP_OK, etag);
+}
+
+TEST_F(TestWebServer, CanGetCachedTransformedImageWithAnyIfNoneMatch)
+{
+  // get the entity tag of the transformed image
+  std::string result;
+  CCurlFile curl;
+  ASSERT_TRUE(curl.Get(GetUrlOfTransformedTestImage(8), result));
+  std::string etag = curl.GetHttpHeader().GetValue(MHD_HTTP_HEADER_ETAG);
+  ASSERT_FALSE(etag.empty());
+
+  // any entity tag matches "*"
+  CCurlFile curl_cached;
+  curl_cached.SetRequestHeader(MHD_HTTP_HEADER_IF_NONE_MATCH, "*");
+  ASSERT_TRUE(curl_cached.Get(GetUrlOfTransformedTestImage(8), result));
+  CheckTransformedTestImageResponse(curl_cached, result, MHD_HTTP_NOT_MODIFIED, etag);
+}
+
+TEST_F(TestWebServer, CanGetCachedTransformedImageWithMatchingIfNoneMatchForcingNoCache)
+{
+  // get the entity tag of the transformed image
+  std::string result;
+  CCurlFile curl;
+  ASSERT_TRUE(curl.Get(GetUrlOfTransformedTestImage(8), result));
+  std::string etag = curl.GetHttpHeader().GetValue(MHD_HTTP_HEADER_ETAG);
+  ASSERT_FALSE(etag.empty());
+
+  // a matching If-None-Match value is ignored when forcing no caching
+  CCurlFile curl_cached;
+  curl_cached.SetRequestHeader(MHD_HTTP_HEADER_IF_NONE_MATCH, etag);
+  curl_cached.SetRequestHeader(MHD_HTTP_HEADER_CACHE_CONTROL, "no-cache");
+  ASSERT_TRUE(curl_cached.Get(GetUrlOfTransformedTestImage(8), result));
+  CheckTransformedTestImageResponse(curl_cached, result, MHD_HTTP_OK, etag);
+}
+
 TEST_F(TestWebServer, CanGetCachedFileWithOlderIfUnmodifiedSince)
 {
   // get the last modified date of the file
@@ -832,6 +1035,159 @@ TEST_F(TestWebServer, CanGetRangedFileRangeFirstSecondLast)
   CheckRangesTestFileResponse(curl, result, ranges);
 }
 
+TEST_F(TestWebServer, CanGetRangedFileWithWorkers)
+{
+  // multiple ranges are read by the workers instead of being sent from the file descriptor
+  ASSERT_TRUE(RestartWithWorkers(2));
+
+  const std::string rangedFileContent = TEST_FILES_DATA_RANGES;
+  std::vector<std::string> rangedContent = StringUtils::Split(TEST_FILES_DATA_RANGES, ";");
+  const std::string range = StringUtils::Format("bytes=0-%u,%u-%u,-%u", static_cast<unsigned int>(rangedContent.front().size() - 1),
+    static_cast<unsigned int>(rangedContent.front().size() + 1), static_cast<unsigned int>(rangedContent.front().size() + 1) + static_cast<unsigned int>(rangedContent.at(1).size() - 1),
+    static_cast<unsigned int>(rangedContent.back().size()));
+
+  CHttpRanges ranges;
+  ASSERT_TRUE(ranges.Parse(range, rangedFileContent.size()));
+
+  std::string result;
+  CCurlFile curl;
+  curl.SetRequestHeader(MHD_HTTP_HEADER_RANGE, range);
+  ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
+  CheckRangesTestFileResponse(curl, result, ranges);
+}
+
+// Not run by default, compares the thread per connection and the pooled mode
+// under load. Run it with --gtest_also_run_disabled_tests.
+TEST_F(TestWebServer, DISABLED_BenchmarkWithWorkers)
+{
+  const int clients = 64;
+  const int requests = 50;
+
+  const std::string range = "bytes=0-5,7-12";
+  const std::string url = GetUrlOfTestFile(TEST_FILES_RANGES);
+
+  for (unsigned int workers : { 0U, 4U })
+  {
+    ASSERT_TRUE(RestartWithWorkers(workers));
+
+    std::atomic_int failed(0);
+    std::vector<std::vector<double>> latencies(clients);
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int c = 0; c < clients; c++)
+    {
+      threads.emplace_back([&, c]() {
+        for (int i = 0; i < requests; i++)
+        {
+          std::string result;
+          CCurlFile curl;
+          curl.SetRequestHeader(MHD_HTTP_HEADER_RANGE, range);
+          auto requested = std::chrono::steady_clock::now();
+          if (!curl.Get(url, result) || result.find("range2") == std::string::npos)
+            failed++;
+          std::chrono::duration<double, std::milli> latency = std::chrono::steady_clock::now() - requested;
+          latencies[c].push_back(latency.count());
+        }
+      });
+    }
+    for (auto& thread : threads)
+      thread.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    std::vector<double> all;
+    for (const auto& clientLatencies : latencies)
+      all.insert(all.end(), clientLatencies.begin(), clientLatencies.end());
+    std::sort(all.begin(), all.end());
+
+    EXPECT_EQ(0, failed);
+    std::cout << "[ BENCH    ] " << workers << " workers, " << clients << " clients: "
+              << static_cast<int>(clients * requests / elapsed.count()) << " requests/s, "
+              << "median " << all[all.size() / 2] << " ms, "
+              << "99th percentile " << all[all.size() * 99 / 100] << " ms" << std::endl;
+  }
+}
+
+TEST_F(TestWebServer, CanGetRangedFileWithoutSendFile)
+{
+  // a single range is read through the content reader callback as for files of VFS-only protocols
+  ASSERT_TRUE(RestartWithSendFile(false));
+
+  const std::string rangedFileContent = TEST_FILES_DATA_RANGES;
+  std::vector<std::string> rangedContent = StringUtils::Split(TEST_FILES_DATA_RANGES, ";");
+  const std::string range = StringUtils::Format("bytes=%u-%u", static_cast<unsigned int>(rangedContent.front().size() + 1),
+    static_cast<unsigned int>(rangedContent.front().size() + 1) + static_cast<unsigned int>(rangedContent.at(1).size() - 1));
+
+  CHttpRanges ranges;
+  ASSERT_TRUE(ranges.Parse(range, rangedFileContent.size()));
+
+  std::string result;
+  CCurlFile curl;
+  curl.SetRequestHeader(MHD_HTTP_HEADER_RANGE, range);
+  ASSERT_TRUE(curl.Get(GetUrlOfTestFile(TEST_FILES_RANGES), result));
+  CheckRangesTestFileResponse(curl, result, ranges);
+}
+
+// Not run by default, compares the download throughput of a large local file sent
+// from its file descriptor and through the content reader callback.
+// Run it with --gtest_also_run_disabled_tests.
+TEST_F(TestWebServer, DISABLED_BenchmarkSendFile)
+{
+  const int clients = 4;
+  const int requests = 10;
+  const size_t fileSize = 32 * 1024 * 1024;
+
+  // the large file is shared from its temporary directory
+  CFile* file = XBMC_CREATETEMPFILE(".bin");
+  ASSERT_NE(nullptr, file);
+  std::string data(1024 * 1024, 'x');
+  for (size_t written = 0; written < fileSize; written += data.size())
+    ASSERT_EQ(static_cast<ssize_t>(data.size()), file->Write(data.c_str(), data.size()));
+  file->Flush();
+
+  CMediaSource source;
+  source.strName = "WebServer Benchmark";
+  source.strPath = CXBMCTestUtils::Instance().TempFileDirectory(file);
+  source.vecPaths.push_back(source.strPath);
+  source.m_allowSharing = true;
+  source.m_iDriveType = CMediaSource::SOURCE_TYPE_LOCAL;
+  source.m_iLockMode = LOCK_MODE_EVERYONE;
+  source.m_ignore = true;
+  CMediaSourceSettings::GetInstance().AddShare("videos", source);
+
+  const std::string url = GetUrl(URIUtils::AddFileToFolder("vfs", CURL::Encode(XBMC_TEMPFILEPATH(file))));
+
+  for (bool sendFile : { true, false })
+  {
+    ASSERT_TRUE(RestartWithSendFile(sendFile));
+
+    std::atomic_int failed(0);
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> threads;
+    for (int c = 0; c < clients; c++)
+    {
+      threads.emplace_back([&]() {
+        for (int i = 0; i < requests; i++)
+        {
+          std::string result;
+          CCurlFile curl;
+          if (!curl.Get(url, result) || result.size() != fileSize)
+            failed++;
+        }
+      });
+    }
+    for (auto& thread : threads)
+      thread.join();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(0, failed);
+    std::cout << "[ BENCH    ] " << (sendFile ? "sendfile" : "callback") << ", " << clients << " clients: "
+              << static_cast<int>(clients * requests * (fileSize / (1024 * 1024)) / elapsed.count()) << " MB/s" << std::endl;
+  }
+
+  XBMC_DELETETEMPFILE(file);
+}
+
 TEST_F(TestWebServer, CanGetCachedRangedFileWithOlderIfRange)
 {
   const std::string rangedFileContent = TEST_FILES_DATA_RANGES;
@@ -26,6 +26,7 @@
 #include "music/tags/MusicInfoTag.h"
 #include "settings/Settings.h"
 #include "settings/SettingsComponent.h"
+#include "threads/SingleLock.h"
 #include "utils/Digest.h"
 #include "utils/FileExtensionProvider.h"
 #include "utils/log.h"
@@ -52,6 +53,10 @@ namespace UPNP
 
 NPT_UInt32 CUPnPServer::m_MaxReturnedItems = 0;
 
+// how long a directory listing is kept for clients paging through it
+#define UPNP_SNAPSHOT_TIMEOUT 60000
+#define UPNP_MAX_SNAPSHOTS    16
+
 const char* audio_containers[] = { "musicdb://genres/", "musicdb://artists/", "musicdb://albums/",
                                    "musicdb://songs/", "musicdb://recentlyaddedalbums/", "musicdb://years/",
                                    "musicdb://singles/" };
@@ -144,6 +149,7 @@ CUPnPServer::UpdateContainer(const std::string& id)
     if (itr != m_UpdateIDs.end())
         count = ++itr->second.second;
     m_UpdateIDs[id] = std::make_pair(true, count);
+    ClearBrowseSnapshot(id);
     PropagateUpdates();
 }
 
@@ -426,6 +432,8 @@ CUPnPServer::Announce(AnnouncementFlag flag, const char *sender, const char *mes
             m_scanning = true;
         }
         else if (!strcmp(message, "OnScanFinished") || !strcmp(message, "OnCleanFinished")) {
+            // any listing kept for paging may be outdated now
+            ClearBrowseSnapshots();
             OnScanCompleted(flag);
         }
     }
@@ -440,6 +448,10 @@ CUPnPServer::Announce(AnnouncementFlag flag, const char *sender, const char *mes
             item_type = data["type"].asString();
         }
 
+        // listings kept for paging that show the item are outdated now, the
+        // containers updated below drop theirs too
+        ClearBrowseSnapshots(item_type, item_id);
+
         // we always update 'recently added' nodes along with the specific container,
         // as we don't differentiate 'updates' from 'adds' in RPC interface
         if (flag == VideoLibrary) {
@@ -632,7 +644,6 @@ CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference&          action,
                                     const char*                   sort_criteria,
                                     const PLT_HttpRequestContext& context)
 {
-    CFileItemList items;
     NPT_String    parent_id = TranslateWMPObjectId(object_id);
 
     CLog::Log(LOGINFO, "UPnP: Received Browse DirectChildren request for object '%s', with sort criteria %s", object_id, sort_criteria);
@@ -642,6 +653,43 @@ CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference&          action,
         return NPT_FAILURE;
     }
 
+    // clients page through large directories, only the first page lists it.
+    // Only library listings are kept, they are dropped once an item in them
+    // changes while nothing tells when a filesystem directory does
+    bool keep = URIUtils::IsLibraryContent((const char*)parent_id);
+    std::shared_ptr<BrowseSnapshot> snapshot;
+    if (keep)
+        snapshot = GetBrowseSnapshot((const char*)parent_id);
+    if (!snapshot) {
+        snapshot = std::make_shared<BrowseSnapshot>();
+        GetDirectChildren(parent_id, snapshot->items);
+        if (keep)
+            AddBrowseSnapshot((const char*)parent_id, snapshot);
+    }
+
+    // Don't pass parent_id if action is Search not BrowseDirectChildren, as
+    // we want the engine to determine the best parent id, not necessarily the one
+    // passed
+    NPT_String action_name = action->GetActionDesc().GetName();
+    CSingleLock lock(snapshot->critSection);
+    return BuildResponse(
+        action,
+        snapshot->items,
+        filter,
+        starting_index,
+        requested_count,
+        sort_criteria,
+        context,
+        (action_name.Compare("Search", true)==0)?NULL:parent_id.GetChars(),
+        snapshot.get());
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPServer::GetDirectChildren
++---------------------------------------------------------------------*/
+void
+CUPnPServer::GetDirectChildren(const NPT_String& parent_id, CFileItemList& items)
+{
     items.SetPath(std::string(parent_id));
 
     // guard against loading while saving to the same cache file
@@ -704,20 +752,109 @@ CUPnPServer::OnBrowseDirectChildren(PLT_ActionReference&          action,
           items.Add(mvideos);
       }
     }
+}
 
-    // Don't pass parent_id if action is Search not BrowseDirectChildren, as
-    // we want the engine to determine the best parent id, not necessarily the one
-    // passed
-    NPT_String action_name = action->GetActionDesc().GetName();
-    return BuildResponse(
-        action,
-        items,
-        filter,
-        starting_index,
-        requested_count,
-        sort_criteria,
-        context,
-        (action_name.Compare("Search", true)==0)?NULL:parent_id.GetChars());
+/*----------------------------------------------------------------------
+|   CUPnPServer::GetBrowseSnapshot
++---------------------------------------------------------------------*/
+std::shared_ptr<CUPnPServer::BrowseSnapshot>
+CUPnPServer::GetBrowseSnapshot(const std::string& id)
+{
+    NPT_AutoLock lock(m_SnapshotMutex);
+    std::map<std::string, std::shared_ptr<BrowseSnapshot> >::iterator itr = m_Snapshots.find(id);
+    if (itr == m_Snapshots.end())
+        return std::shared_ptr<BrowseSnapshot>();
+
+    if (XbmcThreads::SystemClockMillis() - itr->second->time > UPNP_SNAPSHOT_TIMEOUT) {
+        m_Snapshots.erase(itr);
+        return std::shared_ptr<BrowseSnapshot>();
+    }
+    return itr->second;
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPServer::AddBrowseSnapshot
++---------------------------------------------------------------------*/
+void
+CUPnPServer::AddBrowseSnapshot(const std::string& id, const std::shared_ptr<BrowseSnapshot>& snapshot)
+{
+    NPT_AutoLock lock(m_SnapshotMutex);
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    snapshot->time = now;
+
+    // drop expired snapshots, and the oldest one if there are still too many
+    std::map<std::string, std::shared_ptr<BrowseSnapshot> >::iterator oldest = m_Snapshots.end();
+    for (std::map<std::string, std::shared_ptr<BrowseSnapshot> >::iterator itr = m_Snapshots.begin(); itr != m_Snapshots.end();) {
+        if (now - itr->second->time > UPNP_SNAPSHOT_TIMEOUT) {
+            itr = m_Snapshots.erase(itr);
+            continue;
+        }
+        if (oldest == m_Snapshots.end() || now - itr->second->time > now - oldest->second->time)
+            oldest = itr;
+        ++itr;
+    }
+    if (m_Snapshots.size() >= UPNP_MAX_SNAPSHOTS && oldest != m_Snapshots.end())
+        m_Snapshots.erase(oldest);
+
+    m_Snapshots[id] = snapshot;
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPServer::ClearBrowseSnapshots
++---------------------------------------------------------------------*/
+void
+CUPnPServer::ClearBrowseSnapshots()
+{
+    NPT_AutoLock lock(m_SnapshotMutex);
+    m_Snapshots.clear();
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPServer::ClearBrowseSnapshot
++---------------------------------------------------------------------*/
+void
+CUPnPServer::ClearBrowseSnapshot(const std::string& id)
+{
+    NPT_AutoLock lock(m_SnapshotMutex);
+    m_Snapshots.erase(id);
+}
+
+/*----------------------------------------------------------------------
+|   CUPnPServer::ClearBrowseSnapshots
++---------------------------------------------------------------------*/
+void
+CUPnPServer::ClearBrowseSnapshots(const std::string& type, int id)
+{
+    std::map<std::string, std::shared_ptr<BrowseSnapshot> > snapshots;
+    {
+        NPT_AutoLock lock(m_SnapshotMutex);
+        snapshots = m_Snapshots;
+    }
+
+    // a snapshot is locked while a page is built from it, which can take a
+    // while with thumbnails. Rather than holding up the announcements behind
+    // this one, a busy snapshot is dropped and listed again for the next page
+    for (std::map<std::string, std::shared_ptr<BrowseSnapshot> >::iterator itr = snapshots.begin(); itr != snapshots.end(); ++itr) {
+        bool found = true;
+        if (itr->second->critSection.try_lock()) {
+            found = false;
+            for (int i = 0; i < itr->second->items.Size() && !found; i++) {
+                const CFileItemPtr& item = itr->second->items[i];
+                if (item->HasVideoInfoTag())
+                    found = item->GetVideoInfoTag()->m_iDbId == id && item->GetVideoInfoTag()->m_type == type;
+                else if (item->HasMusicInfoTag())
+                    found = item->GetMusicInfoTag()->GetDatabaseId() == id && item->GetMusicInfoTag()->GetType() == type;
+            }
+            itr->second->critSection.unlock();
+        }
+        if (!found)
+            continue;
+
+        NPT_AutoLock lock(m_SnapshotMutex);
+        std::map<std::string, std::shared_ptr<BrowseSnapshot> >::iterator current = m_Snapshots.find(itr->first);
+        if (current != m_Snapshots.end() && current->second == itr->second)
+            m_Snapshots.erase(current);
+    }
 }
 
 /*----------------------------------------------------------------------
@@ -731,7 +868,8 @@ CUPnPServer::BuildResponse(PLT_ActionReference&          action,
                            NPT_UInt32                    requested_count,
                            const char*                   sort_criteria,
                            const PLT_HttpRequestContext& context,
-                           const char*                   parent_id /* = NULL */)
+                           const char*                   parent_id /* = NULL */,
+                           BrowseSnapshot*               snapshot /* = NULL */)
 {
     NPT_COMPILER_UNUSED(sort_criteria);
 
@@ -772,20 +910,50 @@ CUPnPServer::BuildResponse(PLT_ActionReference&          action,
     NPT_UInt32 max_count  = (requested_count == 0)?m_MaxReturnedItems:std::min((unsigned long)requested_count, (unsigned long)m_MaxReturnedItems);
     NPT_UInt32 stop_index = std::min((unsigned long)(starting_index + max_count), (unsigned long)items.Size()); // don't return more than we can
 
+    // the didl of an item only depends on the parent id, the filter and the
+    // client, reuse what was built for earlier pages of a snapshot. A search
+    // passes no parent id, its didl carries the parent the engine determines.
+    std::vector<BrowseSnapshot::Fragment>* fragments = NULL;
+    if (snapshot) {
+        std::string key = StringUtils::Format("%s|%s|%s:%d|%d",
+                                              parent_id ? parent_id : "",
+                                              filter ? filter : "",
+                                              (const char*)context.GetLocalAddress().GetIpAddress().ToString(),
+                                              context.GetLocalAddress().GetPort(),
+                                              GetClientQuirks(&context));
+        fragments = &snapshot->fragments[key];
+        fragments->resize(items.Size());
+    }
+
     NPT_Cardinal count = 0;
     NPT_Cardinal total = items.Size();
     NPT_String didl = didl_header;
     PLT_MediaObjectReference object;
     for (unsigned long i=starting_index; i<stop_index; ++i) {
-        object = Build(items[i], true, context, thumb_loader, parent_id);
-        if (object.IsNull()) {
-            // don't tell the client this item ever existed
-            --total;
-            continue;
-        }
-
         NPT_String tmp;
-        NPT_CHECK(PLT_Didl::ToDidl(*object.AsPointer(), filter, tmp));
+        if (fragments && (*fragments)[i].built) {
+            if (!(*fragments)[i].valid) {
+                --total;
+                continue;
+            }
+            tmp = (*fragments)[i].didl;
+        } else {
+            object = Build(items[i], true, context, thumb_loader, parent_id);
+            if (object.IsNull()) {
+                if (fragments)
+                    (*fragments)[i].built = true;
+                // don't tell the client this item ever existed
+                --total;
+                continue;
+            }
+
+            NPT_CHECK(PLT_Didl::ToDidl(*object.AsPointer(), filter, tmp));
+            if (fragments) {
+                (*fragments)[i].built = true;
+                (*fragments)[i].valid = true;
+                (*fragments)[i].didl = tmp;
+            }
+        }
 
         // Neptunes string growing is dead slow for small additions
         if (didl.GetCapacity() < tmp.GetLength() + didl.GetLength()) {
@@ -8,11 +8,15 @@
 
 #pragma once
 
+#include <map>
+#include <memory>
 #include <utility>
+#include <vector>
 #include <Platinum/Source/Devices/MediaConnect/PltMediaConnect.h>
 
 #include "FileItem.h"
 #include "interfaces/IAnnouncer.h"
+#include "threads/CriticalSection.h"
 
 class CVariant;
 class CThumbLoader;
@@ -95,6 +99,28 @@ public:
 
 
 private:
+    /* Directory listing kept between the pages a client browses, along with
+       the didl of each item built so far, per parent id, filter and client. */
+    struct BrowseSnapshot {
+        struct Fragment {
+            bool       built = false;
+            bool       valid = false;
+            NPT_String didl;
+        };
+
+        CFileItemList    items;
+        unsigned int     time = 0;
+        CCriticalSection critSection;
+        std::map<std::string, std::vector<Fragment> > fragments;
+    };
+
+    void GetDirectChildren(const NPT_String& parent_id, CFileItemList& items);
+    std::shared_ptr<BrowseSnapshot> GetBrowseSnapshot(const std::string& id);
+    void AddBrowseSnapshot(const std::string& id, const std::shared_ptr<BrowseSnapshot>& snapshot);
+    void ClearBrowseSnapshots();
+    void ClearBrowseSnapshot(const std::string& id);
+    void ClearBrowseSnapshots(const std::string& type, int id);
+
     void OnScanCompleted(int type);
     void UpdateContainer(const std::string& id);
     void PropagateUpdates();
@@ -111,7 +137,8 @@ private:
                              NPT_UInt32                    requested_count,
                              const char*                   sort_criteria,
                              const PLT_HttpRequestContext& context,
-                             const char*                   parent_id /* = NULL */);
+                             const char*                   parent_id /* = NULL */,
+                             BrowseSnapshot*               snapshot = NULL);
 
     // class methods
     static bool SortItems(CFileItemList& items, const char* sort_criteria);
@@ -125,6 +152,9 @@ private:
 
     NPT_Mutex m_CacheMutex;
 
+    NPT_Mutex m_SnapshotMutex;
+    std::map<std::string, std::shared_ptr<BrowseSnapshot> > m_Snapshots;
+
     NPT_Mutex m_FileMutex;
     NPT_Map<NPT_String, NPT_String> m_FileMap;
 
@@ -166,7 +166,12 @@ bool CPVRRecording::operator !=(const CPVRRecording& right) const
 
 void CPVRRecording::Serialize(CVariant& value) const
 {
-  CVideoInfoTag::Serialize(value);
+  SerializeFields(value, std::set<std::string>());
+}
+
+void CPVRRecording::SerializeFields(CVariant& value, const std::set<std::string>& fields) const
+{
+  CVideoInfoTag::SerializeFields(value, fields);
 
   value["channel"] = m_strChannelName;
   value["lifetime"] = m_iLifetime;
@@ -82,6 +82,7 @@ namespace PVR
     bool operator !=(const CPVRRecording& right) const;
 
     void Serialize(CVariant& value) const override;
+    void SerializeFields(CVariant& value, const std::set<std::string>& fields) const override;
 
     /*!
      * @brief Reset this tag to it's initial state.
@@ -314,6 +314,7 @@ void CAdvancedSettings::Initialize()
   m_bVideoLibraryImportWatchedState = false;
   m_bVideoLibraryImportResumePoint = false;
   m_bVideoScannerIgnoreErrors = false;
+  m_videoScannerHostConcurrency = 2;
   m_iVideoLibraryDateAdded = 1; // prefer mtime over ctime and current time
 
   m_videoEpisodeExtraArt = {};
@@ -409,12 +410,18 @@ void CAdvancedSettings::Initialize()
   // the following setting determines the readRate of a player data
   // as multiply of the default data read rate
   m_cacheReadFactor = 4.0f;
+  // number of connections to fetch http streams ahead with, 0 or 1 read with a single one
+  m_cacheRangeConnections = 0;
 
   m_addonPackageFolderSize = 200;
 
   m_jsonOutputCompact = true;
   m_jsonTcpPort = 9090;
 
+  // number of threads handling long running web server requests, 0 serves each connection with its own thread
+  m_webserverWorkers = 0;
+  m_webserverSendFile = true;
+
   m_enableMultimediaKeys = false;
 
   m_canWindowed = true;
@@ -833,6 +840,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
   if (pElement)
   {
     XMLUtils::GetBoolean(pElement, "ignoreerrors", m_bVideoScannerIgnoreErrors);
+    XMLUtils::GetUInt(pElement, "hostconcurrency", m_videoScannerHostConcurrency, 0, 8);
   }
 
   // Backward-compatibility of ExternalPlayer config
@@ -864,6 +872,7 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetUInt(pElement, "memorysize", m_cacheMemSize);
     XMLUtils::GetUInt(pElement, "buffermode", m_cacheBufferMode, 0, 4);
     XMLUtils::GetFloat(pElement, "readfactor", m_cacheReadFactor);
+    XMLUtils::GetUInt(pElement, "rangeconnections", m_cacheRangeConnections, 0, 16);
   }
 
   pElement = pRootElement->FirstChildElement("jsonrpc");
@@ -873,6 +882,13 @@ void CAdvancedSettings::ParseSettingsFile(const std::string &file)
     XMLUtils::GetUInt(pElement, "tcpport", m_jsonTcpPort);
   }
 
+  pElement = pRootElement->FirstChildElement("webserver");
+  if (pElement)
+  {
+    XMLUtils::GetUInt(pElement, "workers", m_webserverWorkers, 0, 64);
+    XMLUtils::GetBoolean(pElement, "sendfile", m_webserverSendFile);
+  }
+
   pElement = pRootElement->FirstChildElement("samba");
   if (pElement)
   {
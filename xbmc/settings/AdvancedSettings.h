@@ -274,6 +274,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     std::vector<std::string> m_videoMusicVideoExtraArt;
 
     bool m_bVideoScannerIgnoreErrors;
+    unsigned int m_videoScannerHostConcurrency; ///< directories listed at the same time per server, 0 disables prefetching
     int m_iVideoLibraryDateAdded;
 
     std::set<std::string> m_vecTokens;
@@ -348,10 +349,14 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     unsigned int m_cacheMemSize;
     unsigned int m_cacheBufferMode;
     float m_cacheReadFactor;
+    unsigned int m_cacheRangeConnections;
 
     bool m_jsonOutputCompact;
     unsigned int m_jsonTcpPort;
 
+    unsigned int m_webserverWorkers;
+    bool m_webserverSendFile;
+
     bool m_enableMultimediaKeys;
     std::vector<std::string> m_settingsFiles;
     void ParseSettingsFile(const std::string &file);
@@ -76,6 +76,7 @@ public:
   static const std::string SETTING_VIDEOLIBRARY_GROUPSINGLEITEMSETS;
   static const std::string SETTING_VIDEOLIBRARY_UPDATEONSTARTUP;
   static const std::string SETTING_VIDEOLIBRARY_BACKGROUNDUPDATE;
+  static const std::string SETTING_VIDEOLIBRARY_WATCHSOURCES;
   static const std::string SETTING_VIDEOLIBRARY_CLEANUP;
   static const std::string SETTING_VIDEOLIBRARY_EXPORT;
   static const std::string SETTING_VIDEOLIBRARY_IMPORT;
@@ -206,6 +207,7 @@ public:
   static const std::string SETTING_MUSICLIBRARY_SHOWALLITEMS;
   static const std::string SETTING_MUSICLIBRARY_UPDATEONSTARTUP;
   static const std::string SETTING_MUSICLIBRARY_BACKGROUNDUPDATE;
+  static const std::string SETTING_MUSICLIBRARY_WATCHSOURCES;
   static const std::string SETTING_MUSICLIBRARY_CLEANUP;
   static const std::string SETTING_MUSICLIBRARY_EXPORT;
   static const std::string SETTING_MUSICLIBRARY_EXPORT_FILETYPE;
@@ -308,6 +310,7 @@ public:
   static const std::string SETTING_AUDIOOUTPUT_MAINTAINORIGINALVOLUME;
   static const std::string SETTING_AUDIOOUTPUT_PROCESSQUALITY;
   static const std::string SETTING_AUDIOOUTPUT_ATEMPOTHRESHOLD;
+  static const std::string SETTING_AUDIOOUTPUT_LOWLATENCY;
   static const std::string SETTING_AUDIOOUTPUT_STREAMSILENCE;
   static const std::string SETTING_AUDIOOUTPUT_STREAMNOISE;
   static const std::string SETTING_AUDIOOUTPUT_GUISOUNDMODE;
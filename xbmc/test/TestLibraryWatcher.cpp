@@ -0,0 +1,120 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "LibraryWatcher.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+TEST(TestLibraryWatcher, GetLibraries)
+{
+  std::map<std::string, int> roots = {
+    { "/media/movies/", CLibraryWatcher::LIBRARY_VIDEO },
+    { "/media/music/", CLibraryWatcher::LIBRARY_MUSIC },
+    { "/media/music/videos/", CLibraryWatcher::LIBRARY_VIDEO },
+    { "smb://server/share/", CLibraryWatcher::LIBRARY_VIDEO | CLibraryWatcher::LIBRARY_MUSIC },
+  };
+
+  EXPECT_EQ(CLibraryWatcher::LIBRARY_VIDEO, CLibraryWatcher::GetLibraries(roots, "/media/movies/"));
+  EXPECT_EQ(CLibraryWatcher::LIBRARY_VIDEO, CLibraryWatcher::GetLibraries(roots, "/media/movies/Movie (2018)/"));
+  EXPECT_EQ(CLibraryWatcher::LIBRARY_MUSIC, CLibraryWatcher::GetLibraries(roots, "/media/music/Artist/Album/"));
+  // nested sources add up
+  EXPECT_EQ(CLibraryWatcher::LIBRARY_VIDEO | CLibraryWatcher::LIBRARY_MUSIC,
+            CLibraryWatcher::GetLibraries(roots, "/media/music/videos/Artist/"));
+  EXPECT_EQ(CLibraryWatcher::LIBRARY_VIDEO | CLibraryWatcher::LIBRARY_MUSIC,
+            CLibraryWatcher::GetLibraries(roots, "smb://server/share/dir/"));
+  // not within any source
+  EXPECT_EQ(CLibraryWatcher::LIBRARY_NONE, CLibraryWatcher::GetLibraries(roots, "/media/"));
+  EXPECT_EQ(CLibraryWatcher::LIBRARY_NONE, CLibraryWatcher::GetLibraries(roots, "/media/movies2/"));
+  EXPECT_EQ(CLibraryWatcher::LIBRARY_NONE, CLibraryWatcher::GetLibraries(roots, "smb://server/other/"));
+}
+
+TEST(TestLibraryWatcher, GetRootChangesAddsAndRemovesSources)
+{
+  std::map<std::string, int> oldRoots = {
+    { "/media/movies/", CLibraryWatcher::LIBRARY_VIDEO },
+    { "/media/tv/", CLibraryWatcher::LIBRARY_VIDEO },
+  };
+  std::map<std::string, int> roots = {
+    { "/media/movies/", CLibraryWatcher::LIBRARY_VIDEO },
+    { "/media/music/", CLibraryWatcher::LIBRARY_MUSIC },
+  };
+
+  std::vector<std::string> unwatch, watch;
+  CLibraryWatcher::GetRootChanges(oldRoots, roots, unwatch, watch);
+  EXPECT_EQ(std::vector<std::string>({ "/media/tv/" }), unwatch);
+  EXPECT_EQ(std::vector<std::string>({ "/media/music/" }), watch);
+}
+
+TEST(TestLibraryWatcher, GetRootChangesKeepsParentOfRemovedNestedSource)
+{
+  std::map<std::string, int> oldRoots = {
+    { "/media/", CLibraryWatcher::LIBRARY_VIDEO },
+    { "/media/music/", CLibraryWatcher::LIBRARY_MUSIC },
+  };
+  std::map<std::string, int> roots = {
+    { "/media/", CLibraryWatcher::LIBRARY_VIDEO },
+  };
+
+  // the directories of the nested source are still watched for its parent
+  std::vector<std::string> unwatch, watch;
+  CLibraryWatcher::GetRootChanges(oldRoots, roots, unwatch, watch);
+  EXPECT_TRUE(unwatch.empty());
+  EXPECT_TRUE(watch.empty());
+}
+
+TEST(TestLibraryWatcher, GetRootChangesRewatchesNestedSourceOfRemovedParent)
+{
+  std::map<std::string, int> oldRoots = {
+    { "/media/", CLibraryWatcher::LIBRARY_VIDEO },
+    { "/media/music/", CLibraryWatcher::LIBRARY_MUSIC },
+  };
+  std::map<std::string, int> roots = {
+    { "/media/music/", CLibraryWatcher::LIBRARY_MUSIC },
+  };
+
+  // unwatching the parent drops the watches of the nested source as well
+  std::vector<std::string> unwatch, watch;
+  CLibraryWatcher::GetRootChanges(oldRoots, roots, unwatch, watch);
+  EXPECT_EQ(std::vector<std::string>({ "/media/" }), unwatch);
+  EXPECT_EQ(std::vector<std::string>({ "/media/music/" }), watch);
+}
+
+TEST(TestLibraryWatcher, GetRootChangesSkipsSourceAddedWithinWatchedOne)
+{
+  std::map<std::string, int> oldRoots = {
+    { "/media/", CLibraryWatcher::LIBRARY_VIDEO },
+  };
+  std::map<std::string, int> roots = {
+    { "/media/", CLibraryWatcher::LIBRARY_VIDEO },
+    { "/media/music/", CLibraryWatcher::LIBRARY_MUSIC },
+  };
+
+  std::vector<std::string> unwatch, watch;
+  CLibraryWatcher::GetRootChanges(oldRoots, roots, unwatch, watch);
+  EXPECT_TRUE(unwatch.empty());
+  EXPECT_TRUE(watch.empty());
+}
+
+TEST(TestLibraryWatcher, GetRootChangesWatchesAllSourcesInitially)
+{
+  std::map<std::string, int> roots = {
+    { "/media/", CLibraryWatcher::LIBRARY_VIDEO },
+    { "/media/music/", CLibraryWatcher::LIBRARY_MUSIC },
+    { "nfs://server/export/", CLibraryWatcher::LIBRARY_VIDEO },
+  };
+
+  // a nested source is walked along with its parent
+  std::vector<std::string> unwatch, watch;
+  CLibraryWatcher::GetRootChanges({}, roots, unwatch, watch);
+  EXPECT_TRUE(unwatch.empty());
+  EXPECT_EQ(std::vector<std::string>({ "/media/", "nfs://server/export/" }), watch);
+}
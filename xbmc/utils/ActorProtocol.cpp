@@ -10,9 +10,17 @@
 #include "threads/Event.h"
 
 #include <cstring>
+#include <thread>
 
 using namespace Actor;
 
+namespace
+{
+// number of polls of a sync reply before the sender parks on the event,
+// most replies of the actor threads arrive within a few scheduler slices
+constexpr int SYNC_SPIN_COUNT = 100;
+}
+
 void Message::Release()
 {
   bool skip;
@@ -30,8 +38,8 @@ void Message::Release()
 
   payloadObj.release();
 
-  // delete event in case of sync message
-  delete event;
+  // the event of a sync message stays with the message for reuse
+  event = nullptr;
 
   origin.ReturnMessage(this);
 }
@@ -66,41 +74,97 @@ bool Message::Reply(int sig, void *data /* = NULL*/, size_t size /* = 0 */)
 
   origin.Unlock();
 
+  isSyncReplied.store(true, std::memory_order_release);
   if (event)
     event->Set();
 
   return true;
 }
 
+MessageQueue::MessageQueue(Protocol &origin) noexcept
+  : m_head(&m_stub), m_tail(&m_stub), m_stub(origin)
+{
+}
+
+void MessageQueue::Push(Message *msg)
+{
+  msg->next.store(nullptr, std::memory_order_relaxed);
+  Message *prev = m_head.exchange(msg, std::memory_order_acq_rel);
+  prev->next.store(msg, std::memory_order_release);
+}
+
+Message *MessageQueue::Pop()
+{
+  Message *tail = m_tail;
+  Message *next = tail->next.load(std::memory_order_acquire);
+
+  if (tail == &m_stub)
+  {
+    if (!next)
+      return nullptr;
+    m_tail = next;
+    tail = next;
+    next = next->next.load(std::memory_order_acquire);
+  }
+
+  if (next)
+  {
+    m_tail = next;
+    return tail;
+  }
+
+  // a producer has swapped the head but not yet linked it, its event follows
+  if (tail != m_head.load(std::memory_order_acquire))
+    return nullptr;
+
+  Push(&m_stub);
+
+  next = tail->next.load(std::memory_order_acquire);
+  if (next)
+  {
+    m_tail = next;
+    return tail;
+  }
+
+  return nullptr;
+}
+
 Protocol::~Protocol()
 {
   Message *msg;
   Purge();
-  while (!freeMessageQueue.empty())
+  msg = freeMessages.exchange(nullptr);
+  while (msg)
   {
-    msg = freeMessageQueue.front();
-    freeMessageQueue.pop();
+    Message *next = msg->next.load(std::memory_order_relaxed);
     delete msg;
+    msg = next;
   }
 }
 
 Message *Protocol::GetMessage()
 {
-  Message *msg;
-
-  CSingleLock lock(criticalSection);
+  Message *msg = nullptr;
 
-  if (!freeMessageQueue.empty())
+  // pushes to the free list are lock-free, popping is restricted to one
+  // thread at a time which rules out ABA on the head. A thread finding the
+  // pop taken allocates instead of waiting.
+  if (!freeMessagesPop.test_and_set(std::memory_order_acquire))
   {
-    msg = freeMessageQueue.front();
-    freeMessageQueue.pop();
+    msg = freeMessages.load(std::memory_order_acquire);
+    while (msg && !freeMessages.compare_exchange_weak(msg, msg->next.load(std::memory_order_relaxed),
+                                                      std::memory_order_acquire))
+      ;
+    freeMessagesPop.clear(std::memory_order_release);
   }
-  else
+
+  if (!msg)
     msg = new Message(*this);
 
   msg->isSync = false;
   msg->isSyncFini = false;
   msg->isSyncTimeout = false;
+  msg->isSyncReplied.store(false, std::memory_order_relaxed);
   msg->event = NULL;
   msg->data = NULL;
   msg->payloadSize = 0;
@@ -111,9 +175,12 @@ Message *Protocol::GetMessage()
 
 void Protocol::ReturnMessage(Message *msg)
 {
-  CSingleLock lock(criticalSection);
-
-  freeMessageQueue.push(msg);
+  Message *head = freeMessages.load(std::memory_order_relaxed);
+  do
+  {
+    msg->next.store(head, std::memory_order_relaxed);
+  } while (!freeMessages.compare_exchange_weak(head, msg, std::memory_order_release,
+                                               std::memory_order_relaxed));
 }
 
 bool Protocol::SendOutMessage(int signal, void *data /* = NULL */, size_t size /* = 0 */, Message *outMsg /* = NULL */)
@@ -136,9 +203,7 @@ bool Protocol::SendOutMessage(int signal, void *data /* = NULL */, size_t size /
     memcpy(msg->data, data, size);
   }
 
-  { CSingleLock lock(criticalSection);
-    outMessages.push(msg);
-  }
+  outMessages.Push(msg);
   if (containerOutEvent)
     containerOutEvent->Set();
 
@@ -158,9 +223,7 @@ bool Protocol::SendOutMessage(int signal, CPayloadWrapBase *payload, Message *ou
 
   msg->payloadObj.reset(payload);
 
-  { CSingleLock lock(criticalSection);
-    outMessages.push(msg);
-  }
+  outMessages.Push(msg);
   if (containerOutEvent)
     containerOutEvent->Set();
 
@@ -187,9 +250,7 @@ bool Protocol::SendInMessage(int signal, void *data /* = NULL */, size_t size /*
     memcpy(msg->data, data, size);
   }
 
-  { CSingleLock lock(criticalSection);
-    inMessages.push(msg);
-  }
+  inMessages.Push(msg);
   if (containerInEvent)
     containerInEvent->Set();
 
@@ -209,25 +270,39 @@ bool Protocol::SendInMessage(int signal, CPayloadWrapBase *payload, Message *out
 
   msg->payloadObj.reset(payload);
 
-  { CSingleLock lock(criticalSection);
-    inMessages.push(msg);
-  }
+  inMessages.Push(msg);
   if (containerInEvent)
     containerInEvent->Set();
 
   return true;
 }
 
+bool Protocol::WaitSyncReply(Message *msg, int timeout)
+{
+  // spin shortly before parking, a reply from an idle actor thread
+  // usually arrives faster than a sleep on the event returns
+  for (int i = 0; i < SYNC_SPIN_COUNT; i++)
+  {
+    if (msg->isSyncReplied.load(std::memory_order_acquire))
+      return true;
+    std::this_thread::yield();
+  }
+
+  return msg->event->WaitMSec(timeout);
+}
+
 bool Protocol::SendOutMessageSync(int signal, Message **retMsg, int timeout, void *data /* = NULL */, size_t size /* = 0 */)
 {
   Message *msg = GetMessage();
   msg->isOut = true;
   msg->isSync = true;
-  msg->event = new CEvent;
+  if (!msg->syncEvent)
+    msg->syncEvent.reset(new CEvent);
+  msg->event = msg->syncEvent.get();
   msg->event->Reset();
   SendOutMessage(signal, data, size, msg);
 
-  if (!msg->event->WaitMSec(timeout))
+  if (!WaitSyncReply(msg, timeout))
   {
     const CSingleLock lock(criticalSection);
     if (msg->replyMessage)
@@ -254,11 +329,13 @@ bool Protocol::SendOutMessageSync(int signal, Message **retMsg, int timeout, CPa
   Message *msg = GetMessage();
   msg->isOut = true;
   msg->isSync = true;
-  msg->event = new CEvent;
+  if (!msg->syncEvent)
+    msg->syncEvent.reset(new CEvent);
+  msg->event = msg->syncEvent.get();
   msg->event->Reset();
   SendOutMessage(signal, payload, msg);
 
-  if (!msg->event->WaitMSec(timeout))
+  if (!WaitSyncReply(msg, timeout))
   {
     const CSingleLock lock(criticalSection);
     if (msg->replyMessage)
@@ -280,30 +357,36 @@ bool Protocol::SendOutMessageSync(int signal, Message **retMsg, int timeout, CPa
     return false;
 }
 
-bool Protocol::ReceiveOutMessage(Message **msg)
+bool Protocol::Receive(MessageQueue &queue, std::deque<Message*> &pending, CCriticalSection &section, bool defered, Message **msg)
 {
-  CSingleLock lock(criticalSection);
-
-  if (outMessages.empty() || outDefered)
+  if (defered)
     return false;
 
-  *msg = outMessages.front();
-  outMessages.pop();
+  CSingleLock lock(section);
+
+  if (!pending.empty())
+  {
+    *msg = pending.front();
+    pending.pop_front();
+    return true;
+  }
+
+  Message *next = queue.Pop();
+  if (!next)
+    return false;
 
+  *msg = next;
   return true;
 }
 
-bool Protocol::ReceiveInMessage(Message **msg)
+bool Protocol::ReceiveOutMessage(Message **msg)
 {
-  CSingleLock lock(criticalSection);
-
-  if (inMessages.empty() || inDefered)
-    return false;
-
-  *msg = inMessages.front();
-  inMessages.pop();
+  return Receive(outMessages, outPending, outReceiveSection, outDefered, msg);
+}
 
-  return true;
+bool Protocol::ReceiveInMessage(Message **msg)
+{
+  return Receive(inMessages, inPending, inReceiveSection, inDefered, msg);
 }
 
 
@@ -318,46 +401,32 @@ void Protocol::Purge()
     msg->Release();
 }
 
-void Protocol::PurgeIn(int signal)
+void Protocol::PurgeQueue(MessageQueue &queue, std::deque<Message*> &pending, CCriticalSection &section, int signal)
 {
-  Message *msg;
-  std::queue<Message*> msgs;
+  CSingleLock lock(section);
 
-  CSingleLock lock(criticalSection);
+  Message *msg;
+  while ((msg = queue.Pop()))
+    pending.push_back(msg);
 
-  while (!inMessages.empty())
-  {
-    msg = inMessages.front();
-    inMessages.pop();
-    if (msg->signal != signal)
-      msgs.push(msg);
-  }
-  while (!msgs.empty())
+  for (auto it = pending.begin(); it != pending.end();)
   {
-    msg = msgs.front();
-    msgs.pop();
-    inMessages.push(msg);
+    if ((*it)->signal == signal)
+    {
+      (*it)->Release();
+      it = pending.erase(it);
+    }
+    else
+      ++it;
   }
 }
 
-void Protocol::PurgeOut(int signal)
+void Protocol::PurgeIn(int signal)
 {
-  Message *msg;
-  std::queue<Message*> msgs;
-
-  CSingleLock lock(criticalSection);
+  PurgeQueue(inMessages, inPending, inReceiveSection, signal);
+}
 
-  while (!outMessages.empty())
-  {
-    msg = outMessages.front();
-    outMessages.pop();
-    if (msg->signal != signal)
-      msgs.push(msg);
-  }
-  while (!msgs.empty())
-  {
-    msg = msgs.front();
-    msgs.pop();
-    outMessages.push(msg);
-  }
+void Protocol::PurgeOut(int signal)
+{
+  PurgeQueue(outMessages, outPending, outReceiveSection, signal);
 }
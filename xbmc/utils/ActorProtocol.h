@@ -9,14 +9,14 @@
 #pragma once
 
 #include "threads/CriticalSection.h"
+#include "threads/Event.h"
 
+#include <atomic>
 #include <cstddef>
-#include <queue>
+#include <deque>
 #include <memory>
 #include <string>
 
-class CEvent;
-
 namespace Actor
 {
 
@@ -39,10 +39,12 @@ protected:
 };
 
 class Protocol;
+class MessageQueue;
 
 class Message
 {
   friend class Protocol;
+  friend class MessageQueue;
 
   static constexpr size_t MSG_INTERNAL_BUFFER_SIZE = 32;
 
@@ -66,13 +68,35 @@ public:
 private:
   explicit Message(Protocol &_origin) noexcept
     :origin(_origin) {}
+
+  std::atomic<Message*> next = {nullptr}; ///< link in the mailbox or the free list
+  std::atomic_bool isSyncReplied = {false};
+  std::unique_ptr<CEvent> syncEvent; ///< kept with the message for reuse by sync messages
+};
+
+/**
+ * Intrusive multi producer, single consumer queue of messages (Vyukov).
+ * Push never blocks, Pop must be serialized by the caller.
+ */
+class MessageQueue
+{
+public:
+  explicit MessageQueue(Protocol &origin) noexcept;
+  void Push(Message *msg);
+  Message *Pop();
+
+private:
+  std::atomic<Message*> m_head;
+  Message *m_tail;
+  Message m_stub;
 };
 
 class Protocol
 {
 public:
   Protocol(std::string name, CEvent* inEvent, CEvent *outEvent)
-    :portName(name), containerInEvent(inEvent), containerOutEvent(outEvent) {}
+    :portName(name), containerInEvent(inEvent), containerOutEvent(outEvent),
+     outMessages(*this), inMessages(*this) {}
   Protocol(std::string name)
     : Protocol(name, nullptr, nullptr) {}
   ~Protocol();
@@ -96,12 +120,22 @@ public:
   std::string portName;
 
 protected:
+  bool Receive(MessageQueue &queue, std::deque<Message*> &pending, CCriticalSection &section, bool defered, Message **msg);
+  void PurgeQueue(MessageQueue &queue, std::deque<Message*> &pending, CCriticalSection &section, int signal);
+  bool WaitSyncReply(Message *msg, int timeout);
+
   CEvent *containerInEvent, *containerOutEvent;
-  CCriticalSection criticalSection;
-  std::queue<Message*> outMessages;
-  std::queue<Message*> inMessages;
-  std::queue<Message*> freeMessageQueue;
-  bool inDefered = false, outDefered = false;
+  CCriticalSection criticalSection; ///< guards the reply handshake of sync messages
+  MessageQueue outMessages;
+  MessageQueue inMessages;
+  // messages taken out of the mailbox by PurgeIn/PurgeOut, they are received before the mailbox
+  std::deque<Message*> outPending;
+  std::deque<Message*> inPending;
+  CCriticalSection outReceiveSection;
+  CCriticalSection inReceiveSection;
+  std::atomic<Message*> freeMessages = {nullptr};
+  std::atomic_flag freeMessagesPop = ATOMIC_FLAG_INIT;
+  std::atomic_bool inDefered = {false}, outDefered = {false};
 };
 
 }
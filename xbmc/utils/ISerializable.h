@@ -8,6 +8,9 @@
 
 #pragma once
 
+#include <set>
+#include <string>
+
 class CVariant;
 
 class ISerializable
@@ -16,6 +19,18 @@ protected:
   /* make sure nobody deletes a pointer to this class */
   ~ISerializable() = default;
 
+  static bool IsWanted(const std::set<std::string>& fields, const char* field)
+  {
+    return fields.empty() || fields.find(field) != fields.end();
+  }
+
  public:
   virtual void Serialize(CVariant& value) const = 0;
+
+  /*!
+   \brief Serialize the given fields only, e.g. the properties requested over JSON-RPC.
+   Unknown fields are ignored. Implementations without projection serialize everything.
+   \param fields names of the fields to serialize, all fields if empty
+   */
+  virtual void SerializeFields(CVariant& value, const std::set<std::string>& fields) const { Serialize(value); }
 };
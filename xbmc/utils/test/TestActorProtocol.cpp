@@ -0,0 +1,255 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "threads/Event.h"
+#include "utils/ActorProtocol.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace Actor;
+
+namespace
+{
+enum Signals
+{
+  SIG_DATA = 1,
+  SIG_OTHER,
+  SIG_STOP,
+  SIG_ACK,
+};
+
+// replies to sync messages and echoes async ones until stopped
+void RunEcho(Protocol& port, CEvent& outEvent)
+{
+  Message* msg;
+  while (true)
+  {
+    if (port.ReceiveOutMessage(&msg))
+    {
+      int signal = msg->signal;
+      if (msg->isSync)
+        msg->Reply(SIG_ACK, msg->data, msg->data ? sizeof(int) : 0);
+      msg->Release();
+      if (signal == SIG_STOP)
+        break;
+    }
+    else
+      outEvent.WaitMSec(100);
+  }
+}
+}
+
+TEST(TestActorProtocol, OrderAndPayload)
+{
+  Protocol port("test");
+
+  for (int i = 0; i < 100; i++)
+    port.SendOutMessage(SIG_DATA, &i, sizeof(i));
+
+  Message* msg;
+  for (int i = 0; i < 100; i++)
+  {
+    ASSERT_TRUE(port.ReceiveOutMessage(&msg));
+    EXPECT_EQ(SIG_DATA, msg->signal);
+    EXPECT_EQ(i, *reinterpret_cast<int*>(msg->data));
+    msg->Release();
+  }
+  EXPECT_FALSE(port.ReceiveOutMessage(&msg));
+  EXPECT_FALSE(port.ReceiveInMessage(&msg));
+}
+
+TEST(TestActorProtocol, DeferAndPurge)
+{
+  Protocol port("test");
+  Message* msg;
+
+  port.SendOutMessage(SIG_DATA);
+  port.SendOutMessage(SIG_OTHER);
+  port.SendOutMessage(SIG_DATA);
+  port.SendOutMessage(SIG_STOP);
+
+  port.DeferOut(true);
+  EXPECT_FALSE(port.ReceiveOutMessage(&msg));
+  port.DeferOut(false);
+
+  port.PurgeOut(SIG_DATA);
+  port.SendOutMessage(SIG_DATA);
+
+  ASSERT_TRUE(port.ReceiveOutMessage(&msg));
+  EXPECT_EQ(SIG_OTHER, msg->signal);
+  msg->Release();
+  ASSERT_TRUE(port.ReceiveOutMessage(&msg));
+  EXPECT_EQ(SIG_STOP, msg->signal);
+  msg->Release();
+  ASSERT_TRUE(port.ReceiveOutMessage(&msg));
+  EXPECT_EQ(SIG_DATA, msg->signal);
+  msg->Release();
+  EXPECT_FALSE(port.ReceiveOutMessage(&msg));
+}
+
+TEST(TestActorProtocol, MultipleProducers)
+{
+  const int producers = 4;
+  const int messages = 10000;
+
+  CEvent outEvent;
+  Protocol port("test", nullptr, &outEvent);
+  std::vector<int> last(producers, -1);
+  int received = 0;
+  bool ordered = true;
+
+  std::thread consumer([&]() {
+    Message* msg;
+    while (received < producers * messages)
+    {
+      if (port.ReceiveOutMessage(&msg))
+      {
+        int* data = reinterpret_cast<int*>(msg->data);
+        if (data[1] <= last[data[0]])
+          ordered = false;
+        last[data[0]] = data[1];
+        received++;
+        msg->Release();
+      }
+      else
+        outEvent.WaitMSec(100);
+    }
+  });
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; p++)
+  {
+    threads.emplace_back([&port, p, messages]() {
+      for (int i = 0; i < messages; i++)
+      {
+        int data[2] = {p, i};
+        port.SendOutMessage(SIG_DATA, data, sizeof(data));
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  consumer.join();
+
+  EXPECT_EQ(producers * messages, received);
+  EXPECT_TRUE(ordered);
+}
+
+TEST(TestActorProtocol, SyncReply)
+{
+  CEvent outEvent;
+  Protocol port("test", nullptr, &outEvent);
+  std::thread echo(RunEcho, std::ref(port), std::ref(outEvent));
+
+  for (int i = 0; i < 100; i++)
+  {
+    // no ASSERT while the echo thread is joinable, it would terminate the test binary
+    Message* reply;
+    bool replied = port.SendOutMessageSync(SIG_DATA, &reply, 1000, &i, sizeof(i));
+    EXPECT_TRUE(replied);
+    if (!replied)
+      break;
+    EXPECT_EQ(SIG_ACK, reply->signal);
+    EXPECT_EQ(i, *reinterpret_cast<int*>(reply->data));
+    reply->Release();
+  }
+
+  port.SendOutMessage(SIG_STOP);
+  echo.join();
+}
+
+TEST(TestActorProtocol, Benchmark)
+{
+  const int producers = 4;
+  const int messages = 100000;
+  const int roundTrips = 5000;
+
+  CEvent outEvent;
+  Protocol port("bench", nullptr, &outEvent);
+  std::atomic_int received(0);
+
+  std::thread consumer([&]() {
+    Message* msg;
+    while (received < producers * messages)
+    {
+      if (port.ReceiveOutMessage(&msg))
+      {
+        received++;
+        msg->Release();
+      }
+      else
+        outEvent.WaitMSec(100);
+    }
+  });
+
+  auto start = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; p++)
+  {
+    threads.emplace_back([&port, messages]() {
+      for (int i = 0; i < messages; i++)
+        port.SendOutMessage(SIG_DATA, &i, sizeof(i));
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  consumer.join();
+  std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+  EXPECT_EQ(producers * messages, received);
+  std::cout << "[ BENCH    ] " << producers << " producers: "
+            << static_cast<int>(producers * messages / elapsed.count()) << " messages/s" << std::endl;
+
+  // round trips while other threads keep the mailbox busy
+  std::thread echo(RunEcho, std::ref(port), std::ref(outEvent));
+  std::atomic_bool stop(false);
+  std::vector<std::thread> noise;
+  for (int p = 0; p < producers - 1; p++)
+  {
+    noise.emplace_back([&port, &stop]() {
+      while (!stop)
+      {
+        port.SendOutMessage(SIG_OTHER);
+        std::this_thread::yield();
+      }
+    });
+  }
+
+  std::vector<double> latencies;
+  latencies.reserve(roundTrips);
+  for (int i = 0; i < roundTrips; i++)
+  {
+    Message* reply;
+    auto sent = std::chrono::steady_clock::now();
+    bool replied = port.SendOutMessageSync(SIG_DATA, &reply, 1000);
+    EXPECT_TRUE(replied);
+    if (!replied)
+      break;
+    std::chrono::duration<double, std::micro> rtt = std::chrono::steady_clock::now() - sent;
+    latencies.push_back(rtt.count());
+    reply->Release();
+  }
+
+  stop = true;
+  for (auto& thread : noise)
+    thread.join();
+  port.SendOutMessage(SIG_STOP);
+  echo.join();
+
+  ASSERT_EQ(roundTrips, static_cast<int>(latencies.size()));
+  std::sort(latencies.begin(), latencies.end());
+  std::cout << "[ BENCH    ] round trip p50: " << latencies[roundTrips / 2]
+            << " us p99: " << latencies[roundTrips * 99 / 100] << " us" << std::endl;
+}
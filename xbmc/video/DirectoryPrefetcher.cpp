@@ -0,0 +1,141 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#include "DirectoryPrefetcher.h"
+
+#include "URL.h"
+#include "threads/SingleLock.h"
+
+#include <algorithm>
+
+namespace VIDEO
+{
+  CDirectoryPrefetcher::CDirectoryPrefetcher(const FetchFunction& fetch, unsigned int threads, unsigned int hostConcurrency)
+    : m_fetch(fetch), m_hostConcurrency(std::max(hostConcurrency, 1u))
+  {
+    for (unsigned int i = 0; i < threads; i++)
+    {
+      m_threads.emplace_back(new CThread(this, "VideoDirPrefetch"));
+      m_threads.back()->Create();
+    }
+  }
+
+  CDirectoryPrefetcher::~CDirectoryPrefetcher()
+  {
+    Stop();
+  }
+
+  void CDirectoryPrefetcher::Stop()
+  {
+    {
+      CSingleLock lock(m_section);
+      m_stop = true;
+      m_queued.notifyAll();
+      m_done.notifyAll();
+    }
+
+    for (auto& thread : m_threads)
+      thread->StopThread(true);
+    m_threads.clear();
+  }
+
+  void CDirectoryPrefetcher::Queue(const SDirectoryListing& listing)
+  {
+    CSingleLock lock(m_section);
+    if (m_stop || m_tasks.find(listing.path) != m_tasks.end())
+      return;
+
+    STask& task = m_tasks[listing.path];
+    task.listing = listing;
+    task.host = CURL(listing.path).GetHostName();
+    m_order.push_back(listing.path);
+    m_queued.notifyAll();
+  }
+
+  size_t CDirectoryPrefetcher::Size() const
+  {
+    CSingleLock lock(m_section);
+    return m_tasks.size();
+  }
+
+  bool CDirectoryPrefetcher::Take(const std::string& path, SDirectoryListing& listing)
+  {
+    CSingleLock lock(m_section);
+    auto it = m_tasks.find(path);
+    while (it != m_tasks.end() && it->second.state == TASK_RUNNING && !m_stop)
+    {
+      m_done.wait(lock);
+      it = m_tasks.find(path);
+    }
+
+    // still owned by a fetching thread if stopped meanwhile
+    if (it == m_tasks.end() || it->second.state == TASK_RUNNING)
+      return false;
+
+    bool fetched = it->second.state == TASK_DONE;
+    if (fetched)
+    {
+      listing.fastHash = it->second.listing.fastHash;
+      listing.hash = it->second.listing.hash;
+      listing.items.Assign(it->second.listing.items);
+    }
+
+    if (it->second.state == TASK_QUEUED)
+      m_order.erase(std::remove(m_order.begin(), m_order.end(), path), m_order.end());
+    m_tasks.erase(it);
+    return fetched;
+  }
+
+  std::vector<std::string> CDirectoryPrefetcher::GetFetched() const
+  {
+    std::vector<std::string> paths;
+    CSingleLock lock(m_section);
+    for (const auto& task : m_tasks)
+    {
+      if (task.second.state == TASK_DONE)
+        paths.push_back(task.first);
+    }
+    return paths;
+  }
+
+  void CDirectoryPrefetcher::Run()
+  {
+    CSingleLock lock(m_section);
+    while (!m_stop)
+    {
+      // oldest queued directory on a host with a free slot
+      auto next = std::find_if(m_order.begin(), m_order.end(), [this](const std::string& path) {
+        return m_hostRequests[m_tasks[path].host] < m_hostConcurrency;
+      });
+      if (next == m_order.end())
+      {
+        m_queued.wait(lock);
+        continue;
+      }
+
+      std::string path = *next;
+      m_order.erase(next);
+      STask& task = m_tasks[path];
+      task.state = TASK_RUNNING;
+      std::string host = task.host;
+      m_hostRequests[host]++;
+
+      // the listing is only touched by this thread while running
+      SDirectoryListing* listing = &task.listing;
+      {
+        CSingleExit exit(m_section);
+        m_fetch(*listing);
+      }
+
+      m_hostRequests[host]--;
+      task.state = TASK_DONE;
+      m_done.notifyAll();
+      m_queued.notifyAll();
+    }
+  }
+}
@@ -0,0 +1,112 @@
+/*
+ *  Copyright (C) 2005-2018 Team Kodi
+ *  This file is part of Kodi - https://kodi.tv
+ *
+ *  SPDX-License-Identifier: GPL-2.0-or-later
+ *  See LICENSES/README.md for more information.
+ */
+
+#pragma once
+
+#include "FileItem.h"
+#include "addons/Scraper.h"
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/IRunnable.h"
+#include "threads/Thread.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace VIDEO
+{
+  /*!
+   \brief Listing and hash of a directory, fetched ahead of the scanner.
+   */
+  struct SDirectoryListing
+  {
+    std::string path;
+    CONTENT_TYPE content = CONTENT_NONE;
+    std::string dbHash; ///< hash stored in the database
+    std::vector<std::string> excludes;
+
+    std::string fastHash;
+    std::string hash;
+    CFileItemList items;
+  };
+
+  /*!
+   \brief Lists and hashes the directories the video scanner is about to visit.
+
+   Directories are fetched by a small pool of threads with a limit on the
+   number of concurrent requests per host, so a slow server neither holds up
+   the others nor gets overloaded. The fetch function must not touch the
+   database, all database access stays with the scanner thread.
+   */
+  class CDirectoryPrefetcher : public IRunnable
+  {
+  public:
+    typedef std::function<void(SDirectoryListing&)> FetchFunction;
+
+    CDirectoryPrefetcher(const FetchFunction& fetch, unsigned int threads, unsigned int hostConcurrency);
+    ~CDirectoryPrefetcher() override;
+
+    /*! \brief Queue a directory to be fetched.
+     \param listing the directory and the inputs of the fetch function
+     */
+    void Queue(const SDirectoryListing& listing);
+
+    /*! \brief Number of directories queued, being fetched or fetched but not taken yet.
+     */
+    size_t Size() const;
+
+    /*! \brief Get the fetched listing of a directory.
+     Waits if the directory is being fetched. A directory that was queued but
+     not started yet is dropped from the queue, the caller has to fetch it.
+     \param path the directory
+     \param listing filled with the fetched listing
+     \return true if the listing was fetched, false otherwise
+     */
+    bool Take(const std::string& path, SDirectoryListing& listing);
+
+    /*! \brief Get the directories that are fetched and waiting to be taken.
+     */
+    std::vector<std::string> GetFetched() const;
+
+    void Stop();
+
+    // implementation of IRunnable
+    void Run() override;
+
+  private:
+    enum TaskState
+    {
+      TASK_QUEUED,
+      TASK_RUNNING,
+      TASK_DONE
+    };
+
+    struct STask
+    {
+      SDirectoryListing listing;
+      std::string host;
+      TaskState state = TASK_QUEUED;
+    };
+
+    FetchFunction m_fetch;
+    unsigned int m_hostConcurrency;
+    bool m_stop = false;
+
+    std::vector<std::unique_ptr<CThread>> m_threads;
+    std::map<std::string, STask> m_tasks;
+    std::vector<std::string> m_order; ///< queued paths, oldest first
+    std::map<std::string, unsigned int> m_hostRequests;
+
+    mutable CCriticalSection m_section;
+    XbmcThreads::ConditionVariable m_queued;
+    XbmcThreads::ConditionVariable m_done;
+  };
+}
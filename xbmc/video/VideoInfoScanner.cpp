@@ -54,6 +54,11 @@ using namespace XFILE;
 using namespace ADDON;
 using namespace KODI::MESSAGING;
 
+// threads listing directories ahead of the scanner
+#define PREFETCH_THREADS 4
+// directories listed ahead at most
+#define PREFETCH_WINDOW 16
+
 using KODI::MESSAGING::HELPERS::DialogResponse;
 using KODI::UTILITY::CDigest;
 
@@ -112,16 +117,24 @@ namespace VIDEO
       // result in unexpected behaviour.
       m_bCanInterrupt = false;
 
+      unsigned int hostConcurrency = CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_videoScannerHostConcurrency;
+      if (hostConcurrency > 0)
+        m_prefetcher.reset(new CDirectoryPrefetcher(std::bind(&CVideoInfoScanner::FetchDirectory, this, std::placeholders::_1),
+                                                    PREFETCH_THREADS, hostConcurrency));
+      m_prefetchLast.clear();
+
       bool bCancelled = false;
       while (!bCancelled && !m_pathsToScan.empty())
       {
+        QueuePrefetch();
+
         /*
          * A copy of the directory path is used because the path supplied is
          * immediately removed from the m_pathsToScan set in DoScan(). If the
          * reference points to the entry in the set a null reference error
          * occurs.
          */
-        std::string directory = *m_pathsToScan.begin();
+        std::string directory = GetNextPath();
         if (m_bStop)
         {
           bCancelled = true;
@@ -134,11 +147,17 @@ namespace VIDEO
            * will still pick up and remove it though.
            */
           CLog::Log(LOGWARNING, "%s directory '%s' does not exist - skipping scan%s.", __FUNCTION__, CURL::GetRedacted(directory).c_str(), m_bClean ? " and clean" : "");
-          m_pathsToScan.erase(m_pathsToScan.begin());
+          if (m_prefetcher)
+          { // release its prefetch slot
+            SDirectoryListing listing;
+            m_prefetcher->Take(directory, listing);
+          }
+          m_pathsToScan.erase(directory);
         }
         else if (!DoScan(directory))
           bCancelled = true;
       }
+      m_prefetcher.reset();
 
       if (!bCancelled)
       {
@@ -162,6 +181,7 @@ namespace VIDEO
     {
       CLog::Log(LOGERROR, "VideoInfoScanner: Exception while scanning.");
     }
+    m_prefetcher.reset();
 
     m_bRunning = false;
     CServiceBroker::GetAnnouncementManager()->Announce(ANNOUNCEMENT::VideoLibrary, "xbmc", "OnScanFinished");
@@ -171,10 +191,11 @@ namespace VIDEO
     m_handle = NULL;
   }
 
-  void CVideoInfoScanner::Start(const std::string& strDirectory, bool scanAll)
+  void CVideoInfoScanner::Start(const std::string& strDirectory, bool scanAll, bool changedOnly)
   {
     m_strStartDir = strDirectory;
     m_scanAll = scanAll;
+    m_changedOnly = changedOnly;
     m_pathsToScan.clear();
     m_pathsToClean.clear();
 
@@ -194,7 +215,14 @@ namespace VIDEO
 
       for (std::vector<std::string>::const_iterator it = rootDirs.begin(); it < rootDirs.end(); ++it)
       {
+        if (changedOnly)
+        {
+          m_pathsToScan.insert(GetChangedScanPath(*it));
+          continue;
+        }
+
         m_pathsToScan.insert(*it);
+
         std::vector<std::pair<int, std::string>> subpaths;
         m_database.GetSubPaths(*it, subpaths);
         for (std::vector<std::pair<int, std::string>>::iterator it = subpaths.begin(); it < subpaths.end(); ++it)
@@ -208,6 +236,29 @@ namespace VIDEO
     Process();
   }
 
+  std::string CVideoInfoScanner::GetChangedScanPath(const std::string& strDirectory)
+  {
+    SScanSettings settings;
+    bool foundDirectly = false;
+    ScraperPtr info = m_database.GetScraperForPath(strDirectory, settings, foundDirectly);
+    if (!info || info->Content() != CONTENT_TVSHOWS || foundDirectly || settings.parent_name_root)
+      return strDirectory;
+
+    // episodes are scanned per show, walk up to the folder below the one
+    // the content was set on
+    std::string show = strDirectory;
+    std::string parent = URIUtils::GetParentPath(show);
+    while (!parent.empty())
+    {
+      m_database.GetScraperForPath(parent, settings, foundDirectly);
+      if (foundDirectly)
+        break;
+      show = parent;
+      parent = URIUtils::GetParentPath(show);
+    }
+    return show;
+  }
+
   void CVideoInfoScanner::Stop()
   {
     if (m_bCanInterrupt)
@@ -216,6 +267,99 @@ namespace VIDEO
     m_bStop = true;
   }
 
+  void CVideoInfoScanner::FetchDirectory(SDirectoryListing& listing) const
+  {
+    const std::string& extensions = CServiceBroker::GetFileExtensionProvider().GetVideoExtensions();
+
+    if (listing.content == CONTENT_TVSHOWS)
+    {
+      CDirectory::GetDirectory(listing.path, listing.items, extensions, DIR_FLAG_DEFAULTS);
+      listing.items.SetPath(listing.path);
+      GetPathHash(listing.items, listing.hash);
+      return;
+    }
+
+    if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bVideoLibraryUseFastHash && !URIUtils::IsPlugin(listing.path))
+      listing.fastHash = GetFastHash(listing.path, listing.excludes);
+
+    if (!listing.fastHash.empty() && StringUtils::EqualsNoCase(listing.fastHash, listing.dbHash))
+    { // fast hashes match - no need to process anything
+      listing.hash = listing.fastHash;
+      return;
+    }
+
+    // need to fetch the folder
+    CDirectory::GetDirectory(listing.path, listing.items, extensions, DIR_FLAG_DEFAULTS);
+    listing.items.Stack();
+
+    // check whether to re-use previously computed fast hash
+    if (!CanFastHash(listing.items, listing.excludes) || listing.fastHash.empty())
+      GetPathHash(listing.items, listing.hash);
+    else
+      listing.hash = listing.fastHash;
+  }
+
+  void CVideoInfoScanner::QueuePrefetch()
+  {
+    if (!m_prefetcher)
+      return;
+
+    auto it = m_prefetchLast.empty() ? m_pathsToScan.begin() : m_pathsToScan.upper_bound(m_prefetchLast);
+    for (; it != m_pathsToScan.end() && m_prefetcher->Size() < PREFETCH_WINDOW; ++it)
+    {
+      m_prefetchLast = *it;
+
+      // same checks as DoScan, only directories it would list are fetched
+      SScanSettings settings;
+      bool foundDirectly = false;
+      ScraperPtr info = m_database.GetScraperForPath(*it, settings, foundDirectly);
+      CONTENT_TYPE content = info ? info->Content() : CONTENT_NONE;
+      if (content == CONTENT_NONE || (!m_scanAll && settings.noupdate) || URIUtils::IsPlugin(*it))
+        continue;
+      if (content == CONTENT_TVSHOWS && (!foundDirectly || settings.parent_name_root))
+        continue;
+
+      const std::vector<std::string> &regexps = content == CONTENT_TVSHOWS ? CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_tvshowExcludeFromScanRegExps
+                                                           : CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_moviesExcludeFromScanRegExps;
+      if (CUtil::ExcludeFileOrFolder(*it, regexps))
+        continue;
+
+      SDirectoryListing listing;
+      listing.path = *it;
+      listing.content = content;
+      listing.excludes = regexps;
+      m_database.GetPathHash(*it, listing.dbHash);
+      m_prefetcher->Queue(listing);
+    }
+  }
+
+  std::string CVideoInfoScanner::GetNextPath() const
+  {
+    // a fetched directory goes first so a slow server doesn't hold up the
+    // others, unless its parent is still to be scanned as that visits it too
+    if (m_prefetcher)
+    {
+      for (const auto& path : m_prefetcher->GetFetched())
+      {
+        if (m_pathsToScan.find(path) == m_pathsToScan.end())
+          continue;
+
+        bool parentPending = false;
+        std::string child = path;
+        std::string parent = URIUtils::GetParentPath(child);
+        while (!parent.empty() && parent != child && !parentPending)
+        {
+          parentPending = m_pathsToScan.find(parent) != m_pathsToScan.end();
+          child = parent;
+          parent = URIUtils::GetParentPath(child);
+        }
+        if (!parentPending)
+          return path;
+      }
+    }
+    return *m_pathsToScan.begin();
+  }
+
   static void OnDirectoryScanned(const std::string& strDirectory)
   {
     CGUIMessage msg(GUI_MSG_DIRECTORY_SCANNED, 0, 0, 0);
@@ -239,6 +383,10 @@ namespace VIDEO
     if (it != m_pathsToScan.end())
       m_pathsToScan.erase(it);
 
+    SDirectoryListing listing;
+    listing.path = strDirectory;
+    bool prefetched = m_prefetcher && m_prefetcher->Take(strDirectory, listing);
+
     // load subfolder
     CFileItemList items;
     bool foundDirectly = false;
@@ -277,26 +425,16 @@ namespace VIDEO
         m_handle->SetTitle(StringUtils::Format(g_localizeStrings.Get(str).c_str(), info->Name().c_str()));
       }
 
-      std::string fastHash;
-      if (CServiceBroker::GetSettingsComponent()->GetAdvancedSettings()->m_bVideoLibraryUseFastHash && !URIUtils::IsPlugin(strDirectory))
-        fastHash = GetFastHash(strDirectory, regexps);
-
-      if (m_database.GetPathHash(strDirectory, dbHash) && !fastHash.empty() && StringUtils::EqualsNoCase(fastHash, dbHash))
-      { // fast hashes match - no need to process anything
-        hash = fastHash;
-      }
-      else
-      { // need to fetch the folder
-        CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(),
-                                 DIR_FLAG_DEFAULTS);
-        items.Stack();
+      listing.content = content;
+      listing.excludes = regexps;
+      m_database.GetPathHash(strDirectory, listing.dbHash);
+      if (!prefetched)
+        FetchDirectory(listing);
 
-        // check whether to re-use previously computed fast hash
-        if (!CanFastHash(items, regexps) || fastHash.empty())
-          GetPathHash(items, hash);
-        else
-          hash = fastHash;
-      }
+      std::string fastHash = listing.fastHash;
+      dbHash = listing.dbHash;
+      hash = listing.hash;
+      items.Assign(listing.items);
 
       if (StringUtils::EqualsNoCase(hash, dbHash))
       { // hash matches - skipping
@@ -326,10 +464,13 @@ namespace VIDEO
 
       if (foundDirectly && !settings.parent_name_root)
       {
-        CDirectory::GetDirectory(strDirectory, items, CServiceBroker::GetFileExtensionProvider().GetVideoExtensions(),
-                                 DIR_FLAG_DEFAULTS);
-        items.SetPath(strDirectory);
-        GetPathHash(items, hash);
+        listing.content = content;
+        listing.excludes = regexps;
+        if (!prefetched)
+          FetchDirectory(listing);
+
+        items.Assign(listing.items);
+        hash = listing.hash;
         bSkip = true;
         if (!m_database.GetPathHash(strDirectory, dbHash) || !StringUtils::EqualsNoCase(dbHash, hash))
           bSkip = false;
@@ -384,6 +525,10 @@ namespace VIDEO
       // do not recurse for tv shows - we have already looked recursively for episodes
       if (pItem->m_bIsFolder && !pItem->IsParentFolder() && !pItem->IsPlayList() && settings.recurse > 0 && content != CONTENT_TVSHOWS)
       {
+        // known subfolders have their own change notification
+        if (m_changedOnly && m_database.GetPathId(pItem->GetPath()) >= 0)
+          continue;
+
         if (!DoScan(pItem->GetPath()))
         {
           m_bStop = true;
@@ -8,10 +8,12 @@
 
 #pragma once
 
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
+#include "DirectoryPrefetcher.h"
 #include "InfoScanner.h"
 #include "VideoDatabase.h"
 #include "addons/Scraper.h"
@@ -43,8 +45,9 @@ namespace VIDEO
     /*! \brief Scan a folder using the background scanner
      \param strDirectory path to scan
      \param scanAll whether to scan everything not already scanned (regardless of whether the user normally doesn't want a folder scanned.) Defaults to false.
+     \param changedOnly only scan the given folder(s) and their subfolders that are not in the database yet, used when the changed folders are known. Defaults to false.
      */
-    void Start(const std::string& strDirectory, bool scanAll = false);
+    void Start(const std::string& strDirectory, bool scanAll = false, bool changedOnly = false);
     void Stop();
 
     /*! \brief Add an item to the database.
@@ -105,6 +108,26 @@ namespace VIDEO
     virtual void Process();
     bool DoScan(const std::string& strDirectory) override;
 
+    /*! \brief Get the folder to scan for a changed folder, the show folder for changes within a tv show.
+     \param strDirectory the changed folder
+     \return the folder to scan
+     */
+    std::string GetChangedScanPath(const std::string& strDirectory);
+
+    /*! \brief List and hash a directory, the part of DoScan that doesn't need the database.
+     Called by the prefetch threads or by DoScan if the directory wasn't prefetched.
+     \param listing the directory to fetch, content, excludes and database hash set
+     */
+    void FetchDirectory(SDirectoryListing& listing) const;
+
+    /*! \brief Queue the next directories to be scanned for prefetching.
+     */
+    void QueuePrefetch();
+
+    /*! \brief Get the directory to scan next, preferring ones that are prefetched already.
+     */
+    std::string GetNextPath() const;
+
     INFO_RET RetrieveInfoForTvShow(CFileItem *pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, bool fetchEpisodes, CGUIDialogProgress* pDlgProgress);
     INFO_RET RetrieveInfoForMovie(CFileItem *pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, CGUIDialogProgress* pDlgProgress);
     INFO_RET RetrieveInfoForMusicVideo(CFileItem *pItem, bool bDirNames, ADDON::ScraperPtr &scraper, bool useLocal, CScraperUrl* pURL, CGUIDialogProgress* pDlgProgress);
@@ -227,6 +250,9 @@ namespace VIDEO
 
     bool m_bStop;
     bool m_scanAll;
+    bool m_changedOnly = false;
+    std::unique_ptr<CDirectoryPrefetcher> m_prefetcher;
+    std::string m_prefetchLast; ///< last directory considered for prefetching
     std::string m_strStartDir;
     CVideoDatabase m_database;
     std::set<std::string> m_pathsToCount;
@@ -548,85 +548,103 @@ void CVideoInfoTag::Archive(CArchive& ar)
 
 void CVideoInfoTag::Serialize(CVariant& value) const
 {
-  value["director"] = m_director;
-  value["writer"] = m_writingCredits;
-  value["genre"] = m_genre;
-  value["country"] = m_country;
-  value["tagline"] = m_strTagLine;
-  value["plotoutline"] = m_strPlotOutline;
-  value["plot"] = m_strPlot;
-  value["title"] = m_strTitle;
-  value["votes"] = StringUtils::Format("%i", GetRating().votes);
-  value["studio"] = m_studio;
-  value["trailer"] = m_strTrailer;
-  value["cast"] = CVariant(CVariant::VariantTypeArray);
-  for (unsigned int i = 0; i < m_cast.size(); ++i)
+  CVideoInfoTag::SerializeFields(value, std::set<std::string>());
+}
+
+void CVideoInfoTag::SerializeFields(CVariant& value, const std::set<std::string>& fields) const
+{
+  if (IsWanted(fields, "director")) value["director"] = m_director;
+  if (IsWanted(fields, "writer")) value["writer"] = m_writingCredits;
+  if (IsWanted(fields, "genre")) value["genre"] = m_genre;
+  if (IsWanted(fields, "country")) value["country"] = m_country;
+  if (IsWanted(fields, "tagline")) value["tagline"] = m_strTagLine;
+  if (IsWanted(fields, "plotoutline")) value["plotoutline"] = m_strPlotOutline;
+  if (IsWanted(fields, "plot")) value["plot"] = m_strPlot;
+  if (IsWanted(fields, "title")) value["title"] = m_strTitle;
+  if (IsWanted(fields, "votes")) value["votes"] = StringUtils::Format("%i", GetRating().votes);
+  if (IsWanted(fields, "studio")) value["studio"] = m_studio;
+  if (IsWanted(fields, "trailer")) value["trailer"] = m_strTrailer;
+  if (IsWanted(fields, "cast"))
   {
-    CVariant actor;
-    actor["name"] = m_cast[i].strName;
-    actor["role"] = m_cast[i].strRole;
-    actor["order"] = m_cast[i].order;
-    if (!m_cast[i].thumb.empty())
-      actor["thumbnail"] = CTextureUtils::GetWrappedImageURL(m_cast[i].thumb);
-    value["cast"].push_back(actor);
+    value["cast"] = CVariant(CVariant::VariantTypeArray);
+    for (unsigned int i = 0; i < m_cast.size(); ++i)
+    {
+      CVariant actor;
+      actor["name"] = m_cast[i].strName;
+      actor["role"] = m_cast[i].strRole;
+      actor["order"] = m_cast[i].order;
+      if (!m_cast[i].thumb.empty())
+        actor["thumbnail"] = CTextureUtils::GetWrappedImageURL(m_cast[i].thumb);
+      value["cast"].push_back(actor);
+    }
   }
-  value["set"] = m_set.title;
-  value["setid"] = m_set.id;
-  value["setoverview"] = m_set.overview;
-  value["tag"] = m_tags;
-  value["runtime"] = GetDuration();
-  value["file"] = m_strFile;
-  value["path"] = m_strPath;
-  value["imdbnumber"] = GetUniqueID();
-  value["mpaa"] = m_strMPAARating;
-  value["filenameandpath"] = m_strFileNameAndPath;
-  value["originaltitle"] = m_strOriginalTitle;
-  value["sorttitle"] = m_strSortTitle;
-  value["episodeguide"] = m_strEpisodeGuide;
-  value["premiered"] = m_premiered.IsValid() ? m_premiered.GetAsDBDate() : StringUtils::Empty;
-  value["status"] = m_strStatus;
-  value["productioncode"] = m_strProductionCode;
-  value["firstaired"] = m_firstAired.IsValid() ? m_firstAired.GetAsDBDate() : StringUtils::Empty;
-  value["showtitle"] = m_strShowTitle;
-  value["album"] = m_strAlbum;
-  value["artist"] = m_artist;
-  value["playcount"] = GetPlayCount();
-  value["lastplayed"] = m_lastPlayed.IsValid() ? m_lastPlayed.GetAsDBDateTime() : StringUtils::Empty;
-  value["top250"] = m_iTop250;
-  value["year"] = m_premiered.GetYear();
-  value["season"] = m_iSeason;
-  value["episode"] = m_iEpisode;
-  for (const auto& i : m_uniqueIDs)
-    value["uniqueid"][i.first] = i.second;
-
-  value["rating"] = GetRating().rating;
-  CVariant ratings = CVariant(CVariant::VariantTypeObject);
-  for (const auto& i : m_ratings)
+  if (IsWanted(fields, "set")) value["set"] = m_set.title;
+  if (IsWanted(fields, "setid")) value["setid"] = m_set.id;
+  if (IsWanted(fields, "setoverview")) value["setoverview"] = m_set.overview;
+  if (IsWanted(fields, "tag")) value["tag"] = m_tags;
+  if (IsWanted(fields, "runtime")) value["runtime"] = GetDuration();
+  if (IsWanted(fields, "file")) value["file"] = m_strFile;
+  if (IsWanted(fields, "path")) value["path"] = m_strPath;
+  if (IsWanted(fields, "imdbnumber")) value["imdbnumber"] = GetUniqueID();
+  if (IsWanted(fields, "mpaa")) value["mpaa"] = m_strMPAARating;
+  if (IsWanted(fields, "filenameandpath")) value["filenameandpath"] = m_strFileNameAndPath;
+  if (IsWanted(fields, "originaltitle")) value["originaltitle"] = m_strOriginalTitle;
+  if (IsWanted(fields, "sorttitle")) value["sorttitle"] = m_strSortTitle;
+  if (IsWanted(fields, "episodeguide")) value["episodeguide"] = m_strEpisodeGuide;
+  if (IsWanted(fields, "premiered")) value["premiered"] = m_premiered.IsValid() ? m_premiered.GetAsDBDate() : StringUtils::Empty;
+  if (IsWanted(fields, "status")) value["status"] = m_strStatus;
+  if (IsWanted(fields, "productioncode")) value["productioncode"] = m_strProductionCode;
+  if (IsWanted(fields, "firstaired")) value["firstaired"] = m_firstAired.IsValid() ? m_firstAired.GetAsDBDate() : StringUtils::Empty;
+  if (IsWanted(fields, "showtitle")) value["showtitle"] = m_strShowTitle;
+  if (IsWanted(fields, "album")) value["album"] = m_strAlbum;
+  if (IsWanted(fields, "artist")) value["artist"] = m_artist;
+  if (IsWanted(fields, "playcount")) value["playcount"] = GetPlayCount();
+  if (IsWanted(fields, "lastplayed")) value["lastplayed"] = m_lastPlayed.IsValid() ? m_lastPlayed.GetAsDBDateTime() : StringUtils::Empty;
+  if (IsWanted(fields, "top250")) value["top250"] = m_iTop250;
+  if (IsWanted(fields, "year")) value["year"] = m_premiered.GetYear();
+  if (IsWanted(fields, "season")) value["season"] = m_iSeason;
+  if (IsWanted(fields, "episode")) value["episode"] = m_iEpisode;
+  if (IsWanted(fields, "uniqueid"))
   {
-    CVariant rating;
-    rating["rating"] = i.second.rating;
-    rating["votes"] = i.second.votes;
-    rating["default"] = i.first == m_strDefaultRating;
+    for (const auto& i : m_uniqueIDs)
+      value["uniqueid"][i.first] = i.second;
+  }
 
-    ratings[i.first] = rating;
+  if (IsWanted(fields, "rating")) value["rating"] = GetRating().rating;
+  if (IsWanted(fields, "ratings"))
+  {
+    CVariant ratings = CVariant(CVariant::VariantTypeObject);
+    for (const auto& i : m_ratings)
+    {
+      CVariant rating;
+      rating["rating"] = i.second.rating;
+      rating["votes"] = i.second.votes;
+      rating["default"] = i.first == m_strDefaultRating;
+
+      ratings[i.first] = rating;
+    }
+    value["ratings"] = ratings;
+  }
+  if (IsWanted(fields, "userrating")) value["userrating"] = m_iUserRating;
+  if (IsWanted(fields, "dbid")) value["dbid"] = m_iDbId;
+  if (IsWanted(fields, "fileid")) value["fileid"] = m_iFileId;
+  if (IsWanted(fields, "track")) value["track"] = m_iTrack;
+  if (IsWanted(fields, "showlink")) value["showlink"] = m_showLink;
+  if (IsWanted(fields, "streamdetails"))
+    m_streamDetails.Serialize(value["streamdetails"]);
+  if (IsWanted(fields, "resume"))
+  {
+    CVariant resume = CVariant(CVariant::VariantTypeObject);
+    resume["position"] = (float)m_resumePoint.timeInSeconds;
+    resume["total"] = (float)m_resumePoint.totalTimeInSeconds;
+    value["resume"] = resume;
   }
-  value["ratings"] = ratings;
-  value["userrating"] = m_iUserRating;
-  value["dbid"] = m_iDbId;
-  value["fileid"] = m_iFileId;
-  value["track"] = m_iTrack;
-  value["showlink"] = m_showLink;
-  m_streamDetails.Serialize(value["streamdetails"]);
-  CVariant resume = CVariant(CVariant::VariantTypeObject);
-  resume["position"] = (float)m_resumePoint.timeInSeconds;
-  resume["total"] = (float)m_resumePoint.totalTimeInSeconds;
-  value["resume"] = resume;
-  value["tvshowid"] = m_iIdShow;
-  value["dateadded"] = m_dateAdded.IsValid() ? m_dateAdded.GetAsDBDateTime() : StringUtils::Empty;
-  value["type"] = m_type;
-  value["seasonid"] = m_iIdSeason;
-  value["specialsortseason"] = m_iSpecialSortSeason;
-  value["specialsortepisode"] = m_iSpecialSortEpisode;
+  if (IsWanted(fields, "tvshowid")) value["tvshowid"] = m_iIdShow;
+  if (IsWanted(fields, "dateadded")) value["dateadded"] = m_dateAdded.IsValid() ? m_dateAdded.GetAsDBDateTime() : StringUtils::Empty;
+  if (IsWanted(fields, "type")) value["type"] = m_type;
+  if (IsWanted(fields, "seasonid")) value["seasonid"] = m_iIdSeason;
+  if (IsWanted(fields, "specialsortseason")) value["specialsortseason"] = m_iSpecialSortSeason;
+  if (IsWanted(fields, "specialsortepisode")) value["specialsortepisode"] = m_iSpecialSortEpisode;
 }
 
 void CVideoInfoTag::ToSortable(SortItem& sortable, Field field) const
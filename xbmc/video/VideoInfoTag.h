@@ -72,6 +72,7 @@ public:
   bool Save(TiXmlNode *node, const std::string &tag, bool savePathInfo = true, const TiXmlElement *additionalNode = NULL);
   void Archive(CArchive& ar) override;
   void Serialize(CVariant& value) const override;
+  void SerializeFields(CVariant& value, const std::set<std::string>& fields) const override;
   void ToSortable(SortItem& sortable, Field field) const override;
   const CRating GetRating(std::string type = "") const;
   const std::string& GetDefaultRating() const;
@@ -11,6 +11,7 @@
 #include <utility>
 
 #include "ServiceBroker.h"
+#include "filesystem/MultiPathDirectory.h"
 #include "guilib/GUIComponent.h"
 #include "guilib/GUIWindowManager.h"
 #include "GUIUserMessages.h"
@@ -45,6 +46,16 @@ void CVideoLibraryQueue::ScanLibrary(const std::string& directory, bool scanAll
   AddJob(new CVideoLibraryScanningJob(directory, scanAll, showProgress));
 }
 
+void CVideoLibraryQueue::ScanChangedPaths(const std::set<std::string>& directories)
+{
+  if (directories.empty())
+    return;
+
+  std::string directory = directories.size() == 1 ? *directories.begin()
+                                                  : XFILE::CMultiPathDirectory::ConstructMultiPath(directories);
+  AddJob(new CVideoLibraryScanningJob(directory, false, false, true));
+}
+
 bool CVideoLibraryQueue::IsScanningLibrary() const
 {
   // check if the library is being cleaned synchronously
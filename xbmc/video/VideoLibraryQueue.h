@@ -43,6 +43,16 @@ public:
    */
   void ScanLibrary(const std::string& directory, bool scanAll = false, bool showProgress = true);
 
+  /*!
+   \brief Enqueue a background scan of directories known to have changed.
+
+   Only the given directories and subdirectories not yet in the library are
+   scanned, unchanged subdirectories are not walked.
+
+   \param[in] directories Changed directories
+   */
+  void ScanChangedPaths(const std::set<std::string>& directories);
+
   /*!
    \brief Check if a library scan is in progress.
 
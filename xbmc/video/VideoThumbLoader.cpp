@@ -41,6 +41,10 @@
 using namespace XFILE;
 using namespace VIDEO;
 
+// each extraction opens its own demuxer and decoder, the job manager limits
+// low priority work to two workers anyway
+static const unsigned int MAX_CONCURRENT_EXTRACTIONS = 2;
+
 CThumbExtractor::CThumbExtractor(const CFileItem& item,
                                  const std::string& listpath,
                                  bool thumb,
@@ -76,6 +80,11 @@ bool CThumbExtractor::operator==(const CJob* job) const
   return false;
 }
 
+void CThumbExtractor::AddTarget(int64_t pos, const std::string& target)
+{
+  m_extraTargets.emplace_back(pos, target);
+}
+
 bool CThumbExtractor::DoWork()
 {
   if (m_item.IsLiveTV()
@@ -104,13 +113,35 @@ bool CThumbExtractor::DoWork()
   if (m_thumb)
   {
     CLog::Log(LOGDEBUG,"%s - trying to extract thumb from video file %s", __FUNCTION__, CURL::GetRedacted(m_item.GetPath()).c_str());
-    // construct the thumb cache file
-    CTextureDetails details;
-    details.file = CTextureCache::GetCacheFile(m_target) + ".jpg";
-    result = CDVDFileInfo::ExtractThumb(m_item, details, m_fillStreamDetails ? &m_item.GetVideoInfoTag()->m_streamDetails : nullptr, m_pos);
-    if(result)
+    // construct the thumb cache files, all positions are extracted with a single open
+    std::vector<CTextureDetails> details(1 + m_extraTargets.size());
+    std::vector<CDVDFileInfo::ThumbRequest> requests(details.size());
+    details[0].file = CTextureCache::GetCacheFile(m_target) + ".jpg";
+    requests[0].pos = m_pos;
+    requests[0].details = &details[0];
+    for (size_t i = 0; i < m_extraTargets.size(); i++)
+    {
+      details[i + 1].file = CTextureCache::GetCacheFile(m_extraTargets[i].second) + ".jpg";
+      requests[i + 1].pos = m_extraTargets[i].first;
+      requests[i + 1].details = &details[i + 1];
+    }
+
+    auto progress = [this, &requests](unsigned int done)
+    {
+      const CDVDFileInfo::ThumbRequest& request = requests[done - 1];
+      if (done > 1 && request.extracted)
+        CTextureCache::GetInstance().AddCachedTexture(m_extraTargets[done - 2].second, *request.details);
+      return ShouldCancel(done, requests.size());
+    };
+
+    CDVDFileInfo::ExtractThumbs(m_item, requests, m_fillStreamDetails ? &m_item.GetVideoInfoTag()->m_streamDetails : nullptr, progress);
+    // the job succeeds if any thumb was written, not only the first one
+    result = std::any_of(requests.begin(), requests.end(), [](const CDVDFileInfo::ThumbRequest& request) {
+      return request.extracted;
+    });
+    if (requests[0].extracted)
     {
-      CTextureCache::GetInstance().AddCachedTexture(m_target, details);
+      CTextureCache::GetInstance().AddCachedTexture(m_target, details[0]);
       m_item.SetProperty("HasAutoThumb", true);
       m_item.SetProperty("AutoThumbImage", m_target);
       m_item.SetArt("thumb", m_target);
@@ -175,7 +206,7 @@ bool CThumbExtractor::DoWork()
 }
 
 CVideoThumbLoader::CVideoThumbLoader() :
-  CThumbLoader(), CJobQueue(true, 1, CJob::PRIORITY_LOW_PAUSABLE)
+  CThumbLoader(), CJobQueue(true, MAX_CONCURRENT_EXTRACTIONS, CJob::PRIORITY_LOW_PAUSABLE)
 {
   m_videoDatabase = new CVideoDatabase();
 }
@@ -47,12 +47,21 @@ public:
 
   bool operator==(const CJob* job) const override;
 
+  /*!
+   \brief Extract a further thumb from the same file while it is open.
+   Progress is reported through ShouldCancel() after each thumb, the first being m_target.
+   \param pos position to extract thumb from
+   \param target thumbpath
+   */
+  void AddTarget(int64_t pos, const std::string& target);
+
   std::string m_target; ///< thumbpath
   std::string m_listpath; ///< path used in fileitem list
   CFileItem  m_item;
   bool       m_thumb; ///< extract thumb?
   int64_t    m_pos; ///< position to extract thumb from
   bool m_fillStreamDetails; ///< fill in stream details?
+  std::vector<std::pair<int64_t, std::string>> m_extraTargets; ///< further positions and thumbpaths
 };
 
 class CVideoThumbLoader : public CThumbLoader, public CJobQueue
@@ -258,7 +258,8 @@ void CGUIDialogVideoBookmarks::OnRefreshList()
     items.push_back(item);
   }
 
-  // add chapters if around
+  // add chapters if around, missing thumbs are extracted by a single job
+  CThumbExtractor* chapterJob = nullptr;
   for (int i = 1; i <= g_application.GetAppPlayer().GetChapterCount(); ++i)
   {
     std::string chapterName;
@@ -281,10 +282,14 @@ void CGUIDialogVideoBookmarks::OnRefreshList()
       item->SetArt("thumb", cachefile);
     else if (i > m_jobsStarted && CServiceBroker::GetSettingsComponent()->GetSettings()->GetBool(CSettings::SETTING_MYVIDEOS_EXTRACTCHAPTERTHUMBS))
     {
-      CFileItem item(m_filePath, false);
-      CJob* job = new CThumbExtractor(item, m_filePath, true, chapterPath, pos * 1000, false);
-      AddJob(job);
-      m_mapJobsChapter[job] = i;
+      if (!chapterJob)
+      {
+        CFileItem item(m_filePath, false);
+        chapterJob = new CThumbExtractor(item, m_filePath, true, chapterPath, pos * 1000, false);
+      }
+      else
+        chapterJob->AddTarget(pos * 1000, chapterPath);
+      m_mapJobsChapter[chapterJob].push_back(i);
       m_jobsStarted++;
     }
 
@@ -294,6 +299,9 @@ void CGUIDialogVideoBookmarks::OnRefreshList()
     items.push_back(item);
   }
 
+  if (chapterJob)
+    AddJob(chapterJob);
+
   // sort items by resume point
   std::sort(items.begin(), items.end(), [](const CFileItemPtr &item1, const CFileItemPtr &item2) {
     return item1->GetProperty("resumepoint").asDouble() < item2->GetProperty("resumepoint").asDouble();
@@ -563,7 +571,7 @@ void CGUIDialogVideoBookmarks::OnJobComplete(unsigned int jobID,
     MAPJOBSCHAPS::iterator iter = m_mapJobsChapter.find(job);
     if (iter != m_mapJobsChapter.end())
     {
-      unsigned int chapterIdx = (*iter).second;
+      unsigned int chapterIdx = (*iter).second.front();
       CGUIMessage m(GUI_MSG_REFRESH_LIST, GetID(), 0, 1, chapterIdx);
       CApplicationMessenger::GetInstance().SendGUIMessage(m);
       m_mapJobsChapter.erase(iter);
@@ -571,3 +579,19 @@ void CGUIDialogVideoBookmarks::OnJobComplete(unsigned int jobID,
   }
   CJobQueue::OnJobComplete(jobID, success, job);
 }
+
+void CGUIDialogVideoBookmarks::OnJobProgress(unsigned int jobID, unsigned int progress, unsigned int total, const CJob* job)
+{
+  if (IsActive())
+  {
+    // chapter thumbs are extracted in the order they were added to the job,
+    // the first one is refreshed once the job completes
+    MAPJOBSCHAPS::iterator iter = m_mapJobsChapter.find(const_cast<CJob*>(job));
+    if (iter != m_mapJobsChapter.end() && progress > 1 && progress <= (*iter).second.size())
+    {
+      unsigned int chapterIdx = (*iter).second[progress - 1];
+      CGUIMessage m(GUI_MSG_REFRESH_LIST, GetID(), 0, 1, chapterIdx);
+      CApplicationMessenger::GetInstance().SendGUIMessage(m);
+    }
+  }
+}
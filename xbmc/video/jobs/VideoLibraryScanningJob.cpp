@@ -9,11 +9,12 @@
 #include "VideoLibraryScanningJob.h"
 #include "video/VideoDatabase.h"
 
-CVideoLibraryScanningJob::CVideoLibraryScanningJob(const std::string& directory, bool scanAll /* = false */, bool showProgress /* = true */)
+CVideoLibraryScanningJob::CVideoLibraryScanningJob(const std::string& directory, bool scanAll /* = false */, bool showProgress /* = true */, bool changedOnly /* = false */)
   : m_scanner(),
     m_directory(directory),
     m_showProgress(showProgress),
-    m_scanAll(scanAll)
+    m_scanAll(scanAll),
+    m_changedOnly(changedOnly)
 { }
 
 CVideoLibraryScanningJob::~CVideoLibraryScanningJob() = default;
@@ -37,13 +38,14 @@ bool CVideoLibraryScanningJob::operator==(const CJob* job) const
     return false;
 
   return m_directory == scanningJob->m_directory &&
-         m_scanAll == scanningJob->m_scanAll;
+         m_scanAll == scanningJob->m_scanAll &&
+         m_changedOnly == scanningJob->m_changedOnly;
 }
 
 bool CVideoLibraryScanningJob::Work(CVideoDatabase &db)
 {
   m_scanner.ShowDialog(m_showProgress);
-  m_scanner.Start(m_directory, m_scanAll);
+  m_scanner.Start(m_directory, m_scanAll, m_changedOnly);
 
   return true;
 }
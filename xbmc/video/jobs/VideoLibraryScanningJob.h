@@ -28,8 +28,9 @@ public:
    \param[in] directory Directory to be scanned for new items
    \param[in] scanAll Whether to scan all items or not
    \param[in] showProgress Whether to show a progress bar or not
+   \param[in] changedOnly Only scan the given directories and their new subdirectories
    */
-  CVideoLibraryScanningJob(const std::string& directory, bool scanAll = false, bool showProgress = true);
+  CVideoLibraryScanningJob(const std::string& directory, bool scanAll = false, bool showProgress = true, bool changedOnly = false);
   ~CVideoLibraryScanningJob() override;
 
   // specialization of CVideoLibraryJob
@@ -49,4 +50,5 @@ private:
   std::string m_directory;
   bool m_showProgress;
   bool m_scanAll;
+  bool m_changedOnly;
 };
@@ -15,6 +15,7 @@
 #include <string.h>
 
 #include "OptionalsReg.h"
+#include "cores/AudioEngine/Sinks/AESinkOffline.h"
 #include "platform/linux/OptionalsReg.h"
 #include "windowing/GraphicContext.h"
 #include "platform/linux/powermanagement/LinuxPowerSyscall.h"
@@ -52,6 +53,10 @@ CWinSystemGbm::CWinSystemGbm() :
   {
     OPTIONALS::SndioRegister();
   }
+  else if (StringUtils::EqualsNoCase(envSink, "OFFLINE"))
+  {
+    CAESinkOffline::Register();
+  }
   else
   {
     if (!OPTIONALS::PulseAudioRegister())
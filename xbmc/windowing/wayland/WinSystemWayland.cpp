@@ -22,6 +22,7 @@
 #include "input/touch/generic/GenericTouchActionHandler.h"
 #include "input/touch/generic/GenericTouchInputHandler.h"
 #include "platform/linux/powermanagement/LinuxPowerSyscall.h"
+#include "cores/AudioEngine/Sinks/AESinkOffline.h"
 #include "platform/linux/OptionalsReg.h"
 #include "platform/linux/PlatformConstants.h"
 #include "platform/linux/TimeUtils.h"
@@ -156,6 +157,10 @@ CWinSystemWayland::CWinSystemWayland()
   {
     OPTIONALS::SndioRegister();
   }
+  else if (StringUtils::EqualsNoCase(envSink, "OFFLINE"))
+  {
+    CAESinkOffline::Register();
+  }
   else
   {
     if (!OPTIONALS::PulseAudioRegister())